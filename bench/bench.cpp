@@ -0,0 +1,431 @@
+/*
+ * Container micro benchmarks. Built twice by `make bench`: once against the
+ * ft containers (bench_ft) and once with FT_STL defined, which swaps in the
+ * std containers like main.cpp does (bench_std). Both builds allocate through
+ * bench::allocator so that --alloc can report allocation activity.
+ */
+
+#include "bench.hpp"
+
+#ifdef FT_STL
+  #include <algorithm>
+  #include <deque>
+  #include <map>
+  #include <queue>
+  #include <set>
+  #include <stack>
+  #include <vector>
+  namespace lib = std;
+  #define BENCH_IMPL "std"
+  typedef std::deque<int, bench::allocator<int>::type> stack_container;
+#else
+  #include "algorithm.hpp"
+  #include "map.hpp"
+  #include "priority_queue.hpp"
+  #include "set.hpp"
+  #include "stack.hpp"
+  #include "vector.hpp"
+  namespace lib = ft;
+  #define BENCH_IMPL "ft"
+  typedef ft::vector<int, bench::allocator<int>::type> stack_container;
+#endif
+
+typedef lib::vector<int, bench::allocator<int>::type> int_vector;
+typedef lib::map<int, int, std::less<int>,
+                 bench::allocator<lib::pair<const int, int> >::type>
+    int_map;
+typedef lib::set<int, std::less<int>, bench::allocator<int>::type> int_set;
+typedef lib::stack<int, stack_container>                           int_stack;
+typedef lib::priority_queue<int, int_vector>                       int_priority_queue;
+
+namespace {
+
+// Inserting into the middle of an ft::vector is linear, so the insert/erase
+// cases do at most this many operations on an n-element vector.
+const size_t max_middle_ops = 1000;
+
+std::vector<int> random_keys(size_t n, unsigned long long seed = 42) {
+  bench::rng       r(seed);
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; ++i)
+    keys[i] = r.next_int();
+  return keys;
+}
+
+void fill(int_vector& v, size_t n) {
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(static_cast<int>(i));
+}
+
+void fill(int_map& m, const std::vector<int>& keys) {
+  for (size_t i = 0; i < keys.size(); ++i)
+    m.insert(lib::make_pair(keys[i], static_cast<int>(i)));
+}
+
+void fill(int_set& s, const std::vector<int>& keys) {
+  for (size_t i = 0; i < keys.size(); ++i)
+    s.insert(keys[i]);
+}
+
+//!@{ vector ///////////////////////////////////////////////////////////////////
+
+void vector_push_back(bench::state& st) {
+  int_vector v;
+  st.start();
+  for (size_t i = 0; i < st.n; ++i)
+    v.push_back(static_cast<int>(i));
+  st.stop(st.n);
+  st.sink += v.size();
+}
+
+void vector_insert_middle(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  size_t ops = st.n < max_middle_ops ? st.n : max_middle_ops;
+  st.start();
+  for (size_t i = 0; i < ops; ++i)
+    v.insert(v.begin() + v.size() / 2, static_cast<int>(i));
+  st.stop(ops);
+  st.sink += v.size();
+}
+
+void vector_erase_middle(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  size_t ops = st.n / 2 < max_middle_ops ? st.n / 2 : max_middle_ops;
+  st.start();
+  for (size_t i = 0; i < ops; ++i)
+    v.erase(v.begin() + v.size() / 2);
+  st.stop(ops);
+  st.sink += v.size();
+}
+
+void vector_copy(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  st.start();
+  int_vector c(v);
+  st.stop(st.n);
+  st.sink += c.size() + c[c.size() / 2];
+}
+
+void vector_iterate(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  unsigned long sum = 0;
+  st.start();
+  for (int_vector::iterator it = v.begin(); it != v.end(); ++it)
+    sum += *it;
+  st.stop(st.n);
+  st.sink += sum;
+}
+
+// Equal vectors, so the comparison runs over every element.
+void vector_equal(bench::state& st) {
+  int_vector a;
+  fill(a, st.n);
+  int_vector b(a);
+  st.start();
+  bool eq = a == b;
+  st.stop(st.n);
+  st.sink += eq;
+}
+
+// Differ in the last element only.
+void vector_less(bench::state& st) {
+  int_vector a;
+  fill(a, st.n);
+  int_vector b(a);
+  b[b.size() - 1] += 1;
+  st.start();
+  bool lt = a < b;
+  st.stop(st.n);
+  st.sink += lt;
+}
+
+void vector_find(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  st.start();
+  int_vector::iterator it = lib::find(v.begin(), v.end(), -1);
+  st.stop(st.n);
+  st.sink += it == v.end();
+}
+
+void vector_count(bench::state& st) {
+  int_vector v;
+  fill(v, st.n);
+  st.start();
+  size_t n = lib::count(v.begin(), v.end(), static_cast<int>(st.n / 2));
+  st.stop(st.n);
+  st.sink += n;
+}
+
+//!@}
+
+//!@{ sort /////////////////////////////////////////////////////////////////////
+
+// Every case sorts a copy of the same random keys; the copy is not timed.
+
+void sort_int(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_vector       v(keys.begin(), keys.end());
+  st.start();
+  lib::sort(v.begin(), v.end());
+  st.stop(st.n);
+  st.sink += v[v.size() / 2];
+}
+
+// With a comparator ft::sort cannot use radix sort: this is the introsort.
+void sort_int_compare(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_vector       v(keys.begin(), keys.end());
+  st.start();
+  lib::sort(v.begin(), v.end(), std::greater<int>());
+  st.stop(st.n);
+  st.sink += v[v.size() / 2];
+}
+
+void stable_sort_int(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_vector       v(keys.begin(), keys.end());
+  st.start();
+  lib::stable_sort(v.begin(), v.end());
+  st.stop(st.n);
+  st.sink += v[v.size() / 2];
+}
+
+void partial_sort_int(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_vector       v(keys.begin(), keys.end());
+  st.start();
+  lib::partial_sort(v.begin(), v.begin() + v.size() / 10, v.end());
+  st.stop(st.n);
+  st.sink += v[0];
+}
+
+void nth_element_int(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_vector       v(keys.begin(), keys.end());
+  st.start();
+  lib::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+  st.stop(st.n);
+  st.sink += v[v.size() / 2];
+}
+
+//!@}
+
+//!@{ map //////////////////////////////////////////////////////////////////////
+
+void map_insert(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  int_map m;
+  st.start();
+  fill(m, keys);
+  st.stop(st.n);
+  st.sink += m.size();
+}
+
+void map_find_hit(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  int_map m;
+  fill(m, keys);
+  unsigned long sum = 0;
+  st.start();
+  for (size_t i = 0; i < keys.size(); ++i)
+    sum += m.find(keys[i])->second;
+  st.stop(st.n);
+  st.sink += sum;
+}
+
+void map_find_miss(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  std::vector<int>  probes = random_keys(st.n, 7);
+  int_map m;
+  fill(m, keys);
+  unsigned long miss = 0;
+  st.start();
+  for (size_t i = 0; i < probes.size(); ++i)
+    miss += m.find(probes[i]) == m.end();
+  st.stop(st.n);
+  st.sink += miss;
+}
+
+void map_erase(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  int_map m;
+  fill(m, keys);
+  unsigned long erased = 0;
+  st.start();
+  for (size_t i = 0; i < keys.size(); ++i)
+    erased += m.erase(keys[i]);
+  st.stop(st.n);
+  st.sink += erased;
+}
+
+void map_iterate(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  int_map m;
+  fill(m, keys);
+  unsigned long sum = 0;
+  st.start();
+  for (int_map::iterator it = m.begin(); it != m.end(); ++it)
+    sum += it->second;
+  st.stop(m.size());
+  st.sink += sum;
+}
+
+void map_copy(bench::state& st) {
+  std::vector<int>  keys = random_keys(st.n);
+  int_map m;
+  fill(m, keys);
+  st.start();
+  int_map c(m);
+  st.stop(m.size());
+  st.sink += c.size();
+}
+
+//!@}
+
+//!@{ set //////////////////////////////////////////////////////////////////////
+
+void set_insert(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_set     s;
+  st.start();
+  fill(s, keys);
+  st.stop(st.n);
+  st.sink += s.size();
+}
+
+void set_find(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_set     s;
+  fill(s, keys);
+  unsigned long found = 0;
+  st.start();
+  for (size_t i = 0; i < keys.size(); ++i)
+    found += s.count(keys[i]);
+  st.stop(st.n);
+  st.sink += found;
+}
+
+void set_erase(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_set     s;
+  fill(s, keys);
+  unsigned long erased = 0;
+  st.start();
+  for (size_t i = 0; i < keys.size(); ++i)
+    erased += s.erase(keys[i]);
+  st.stop(st.n);
+  st.sink += erased;
+}
+
+void set_iterate(bench::state& st) {
+  std::vector<int> keys = random_keys(st.n);
+  int_set     s;
+  fill(s, keys);
+  unsigned long sum = 0;
+  st.start();
+  for (int_set::iterator it = s.begin(); it != s.end(); ++it)
+    sum += *it;
+  st.stop(s.size());
+  st.sink += sum;
+}
+
+//!@}
+
+//!@{ stack ////////////////////////////////////////////////////////////////////
+
+void stack_push(bench::state& st) {
+  int_stack s;
+  st.start();
+  for (size_t i = 0; i < st.n; ++i)
+    s.push(static_cast<int>(i));
+  st.stop(st.n);
+  st.sink += s.size();
+}
+
+void stack_push_pop(bench::state& st) {
+  int_stack s;
+  unsigned long  sum = 0;
+  st.start();
+  for (size_t i = 0; i < st.n; ++i)
+    s.push(static_cast<int>(i));
+  while (!s.empty()) {
+    sum += s.top();
+    s.pop();
+  }
+  st.stop(st.n * 2);
+  st.sink += sum;
+}
+
+//!@}
+
+//!@{ priority_queue ///////////////////////////////////////////////////////////
+
+void priority_queue_push(bench::state& st) {
+  std::vector<int>   keys = random_keys(st.n);
+  int_priority_queue q;
+  st.start();
+  for (size_t i = 0; i < st.n; ++i)
+    q.push(keys[i]);
+  st.stop(st.n);
+  st.sink += q.top();
+}
+
+void priority_queue_push_pop(bench::state& st) {
+  std::vector<int>   keys = random_keys(st.n);
+  int_priority_queue q;
+  unsigned long      sum = 0;
+  st.start();
+  for (size_t i = 0; i < st.n; ++i)
+    q.push(keys[i]);
+  while (!q.empty()) {
+    sum += q.top();
+    q.pop();
+  }
+  st.stop(st.n * 2);
+  st.sink += sum;
+}
+
+//!@}
+
+const bench::case_def cases[] = {
+  { "vector_push_back", vector_push_back },
+  { "vector_insert_middle", vector_insert_middle },
+  { "vector_erase_middle", vector_erase_middle },
+  { "vector_copy", vector_copy },
+  { "vector_iterate", vector_iterate },
+  { "vector_equal", vector_equal },
+  { "vector_less", vector_less },
+  { "vector_find", vector_find },
+  { "vector_count", vector_count },
+  { "sort_int", sort_int },
+  { "sort_int_compare", sort_int_compare },
+  { "stable_sort_int", stable_sort_int },
+  { "partial_sort_int", partial_sort_int },
+  { "nth_element_int", nth_element_int },
+  { "map_insert", map_insert },
+  { "map_find_hit", map_find_hit },
+  { "map_find_miss", map_find_miss },
+  { "map_erase", map_erase },
+  { "map_iterate", map_iterate },
+  { "map_copy", map_copy },
+  { "set_insert", set_insert },
+  { "set_find", set_find },
+  { "set_erase", set_erase },
+  { "set_iterate", set_iterate },
+  { "stack_push", stack_push },
+  { "stack_push_pop", stack_push_pop },
+  { "priority_queue_push", priority_queue_push },
+  { "priority_queue_push_pop", priority_queue_push_pop },
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  return bench::run(argc, argv, BENCH_IMPL, cases,
+                    sizeof(cases) / sizeof(cases[0]));
+}
@@ -0,0 +1,478 @@
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+/*
+ * Micro benchmark harness shared by the ft and std builds of bench.cpp.
+ * It only uses std containers for its own bookkeeping so that both builds
+ * measure the container under test and nothing else.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+#include <time.h>
+#include <vector>
+#include "counting_allocator.hpp"
+#include "perf_counters.hpp"
+
+namespace bench {
+
+inline double now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Allocator the cases build their containers with. Without --alloc
+ * nobody reads the stats it records into.
+ */
+template <typename T>
+struct allocator {
+  typedef ft::counting_allocator<T> type;
+};
+
+/**
+ * @brief Allocation activity inside the measured region of one repetition.
+ */
+struct alloc_delta {
+  size_t allocations;
+  size_t deallocations;
+  size_t bytes;
+  size_t peak_bytes; // high-water mark above the live bytes at start()
+  size_t histogram[ft::allocation_stats::num_buckets];
+};
+
+/**
+ * @brief Passed to every benchmark case. The case prepares its input, then
+ * brackets the measured region with start() and stop(ops). Hardware
+ * counters and allocation stats, when enabled, cover exactly that region.
+ */
+class state {
+public:
+  size_t                  n;
+  size_t                  ops;
+  double                  elapsed_ns;
+  unsigned long           sink; // fold results in here so the optimizer
+                                // keeps them
+  perf_counters*          counters;
+  ft::allocation_stats*   alloc_stats;
+  alloc_delta             allocs;
+
+  explicit state(size_t size, perf_counters* pc = 0,
+                 ft::allocation_stats* as = 0)
+  : n(size), ops(0), elapsed_ns(0), sink(0), counters(pc), alloc_stats(as),
+    _t0(0) {
+    std::memset(&allocs, 0, sizeof(allocs));
+  }
+
+  void start() {
+    if (alloc_stats) {
+      alloc_stats->reset_peak();
+      _alloc0 = *alloc_stats;
+    }
+    if (counters)
+      counters->start();
+    _t0 = now_ns();
+  }
+
+  void stop(size_t op_count) {
+    elapsed_ns += now_ns() - _t0;
+    if (counters)
+      counters->stop();
+    if (alloc_stats) {
+      const ft::allocation_stats& a = *alloc_stats;
+      allocs.allocations += a.allocations - _alloc0.allocations;
+      allocs.deallocations += a.deallocations - _alloc0.deallocations;
+      allocs.bytes += a.bytes_allocated - _alloc0.bytes_allocated;
+      if (a.peak_bytes - _alloc0.live_bytes > allocs.peak_bytes)
+        allocs.peak_bytes = a.peak_bytes - _alloc0.live_bytes;
+      for (size_t b = 0; b < ft::allocation_stats::num_buckets; ++b)
+        allocs.histogram[b] += a.histogram[b] - _alloc0.histogram[b];
+    }
+    ops += op_count;
+  }
+
+private:
+  double               _t0;
+  ft::allocation_stats _alloc0;
+};
+
+typedef void (*case_fn)(state&);
+
+struct case_def {
+  const char* name;
+  case_fn     fn;
+};
+
+/*
+ * Optional per-case metrics reported after the timing columns: the hardware
+ * counters first, then the allocation metrics of --alloc.
+ */
+const int num_counters = perf_counters::num_events;
+enum {
+  metric_allocs = num_counters,
+  metric_frees,
+  metric_alloc_bytes,
+  metric_peak_bytes,
+  num_metrics
+};
+
+inline std::string metric_column(int m) {
+  static const char* alloc_names[num_metrics - num_counters] = {
+    "allocs_per_op", "frees_per_op", "alloc_bytes_per_op", "peak_bytes",
+  };
+  if (m < num_counters)
+    return std::string(perf_counters::name(m)) + "_per_op";
+  return alloc_names[m - num_counters];
+}
+
+struct result {
+  std::string name;
+  size_t      size;
+  size_t      ops;
+  double      ns_per_op;
+  double      ops_per_sec;
+  double      metric[num_metrics]; // < 0 when not measured
+  double      baseline_ns_per_op;  // 0 when no baseline row matched
+  double      baseline_metric[num_metrics];
+  size_t      alloc_histogram[ft::allocation_stats::num_buckets];
+};
+
+struct baseline_row {
+  double ns_per_op;
+  double metric[num_metrics];
+};
+
+struct options {
+  std::string         impl;
+  std::string         format;   // csv or json
+  std::string         filter;   // substring of the case name
+  std::string         baseline; // csv written by the other build
+  std::vector<size_t> sizes;
+  double              min_time_ns;
+  size_t              min_reps;
+  size_t              max_reps;
+  bool                perf;     // read hardware counters
+  bool                alloc;    // report allocation stats
+
+  options()
+  : format("csv"), min_time_ns(5e7), min_reps(3), max_reps(50), perf(true),
+    alloc(false) {
+    sizes.push_back(1000);
+    sizes.push_back(10000);
+    sizes.push_back(100000);
+    sizes.push_back(1000000);
+  }
+};
+
+/**
+ * @brief Small deterministic PRNG (xorshift64*), identical in both builds.
+ */
+class rng {
+  unsigned long long _s;
+
+public:
+  explicit rng(unsigned long long seed = 0x9e3779b97f4a7c15ULL)
+  : _s(seed ? seed : 1) { }
+
+  unsigned long long next() {
+    _s ^= _s >> 12;
+    _s ^= _s << 25;
+    _s ^= _s >> 27;
+    return _s * 2685821657736338717ULL;
+  }
+
+  int next_int() { return static_cast<int>(next() >> 33); }
+};
+
+inline std::vector<size_t> parse_sizes(const std::string& s) {
+  std::vector<size_t> out;
+  std::stringstream   ss(s);
+  std::string         item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty())
+      out.push_back(static_cast<size_t>(std::strtoul(item.c_str(), 0, 10)));
+  return out;
+}
+
+inline bool parse_args(int argc, char** argv, options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 9, "--format=") == 0)
+      opt.format = a.substr(9);
+    else if (a.compare(0, 9, "--filter=") == 0)
+      opt.filter = a.substr(9);
+    else if (a.compare(0, 11, "--baseline=") == 0)
+      opt.baseline = a.substr(11);
+    else if (a.compare(0, 8, "--sizes=") == 0)
+      opt.sizes = parse_sizes(a.substr(8));
+    else if (a.compare(0, 11, "--min-time=") == 0)
+      opt.min_time_ns = std::strtod(a.substr(11).c_str(), 0) * 1e9;
+    else if (a.compare(0, 11, "--max-reps=") == 0)
+      opt.max_reps = std::strtoul(a.substr(11).c_str(), 0, 10);
+    else if (a == "--no-perf")
+      opt.perf = false;
+    else if (a == "--alloc")
+      opt.alloc = true;
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--format=csv|json] [--filter=substr] [--sizes=a,b,..]"
+                   " [--min-time=seconds] [--max-reps=n]"
+                   " [--baseline=other.csv] [--no-perf] [--alloc]"
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Runs one case at one size: repeats it until min_time has been spent
+ * in the measured region (and at least min_reps times) and keeps the
+ * fastest repetition, which is the least disturbed by the rest of the
+ * system.
+ */
+inline result run_case(const case_def& c, size_t n, const options& opt,
+                       perf_counters* pc, unsigned long& sink) {
+  result r;
+  r.name = c.name;
+  r.size = n;
+  r.ops = 0;
+  r.ns_per_op = 0;
+  r.baseline_ns_per_op = 0;
+  for (int m = 0; m < num_metrics; ++m) {
+    r.metric[m] = -1;
+    r.baseline_metric[m] = -1;
+  }
+  std::memset(r.alloc_histogram, 0, sizeof(r.alloc_histogram));
+
+  ft::allocation_stats& as = ft::default_allocation_stats();
+  double                total = 0;
+  for (size_t rep = 0; rep < opt.max_reps; ++rep) {
+    if (pc)
+      pc->reset_values();
+    state st(n, pc, opt.alloc ? &as : 0);
+    c.fn(st);
+    sink += st.sink;
+    total += st.elapsed_ns;
+    if (st.ops != 0) {
+      double per_op = st.elapsed_ns / st.ops;
+      if (r.ops == 0 || per_op < r.ns_per_op) {
+        r.ns_per_op = per_op;
+        r.ops = st.ops;
+        for (int e = 0; pc && e < num_counters; ++e)
+          r.metric[e] = pc->available(e) ? pc->value(e) / st.ops : -1;
+        if (opt.alloc) {
+          r.metric[metric_allocs] = double(st.allocs.allocations) / st.ops;
+          r.metric[metric_frees] = double(st.allocs.deallocations) / st.ops;
+          r.metric[metric_alloc_bytes] = double(st.allocs.bytes) / st.ops;
+          r.metric[metric_peak_bytes] = double(st.allocs.peak_bytes);
+          std::memcpy(r.alloc_histogram, st.allocs.histogram,
+                      sizeof(r.alloc_histogram));
+        }
+      }
+    }
+    if (rep + 1 >= opt.min_reps && total >= opt.min_time_ns)
+      break;
+  }
+  r.ops_per_sec = r.ns_per_op > 0 ? 1e9 / r.ns_per_op : 0;
+  return r;
+}
+
+inline std::vector<std::string> split_csv(const std::string& line) {
+  std::vector<std::string> f;
+  std::stringstream        ss(line);
+  std::string              item;
+  while (std::getline(ss, item, ','))
+    f.push_back(item);
+  if (!line.empty() && line[line.size() - 1] == ',')
+    f.push_back("");
+  return f;
+}
+
+/**
+ * @brief Reads the timing and metric columns per (case, size) from a csv
+ * produced by print_csv. Columns are looked up by name, so a baseline
+ * written by an older build still provides ns_per_op.
+ */
+inline std::map<std::string, baseline_row>
+load_baseline(const std::string& path) {
+  std::map<std::string, baseline_row> out;
+  std::ifstream                       in(path.c_str());
+  std::string                         line;
+
+  std::getline(in, line);
+  std::vector<std::string> header = split_csv(line);
+  int                      ns_col = -1;
+  int                      col[num_metrics];
+  for (int m = 0; m < num_metrics; ++m)
+    col[m] = -1;
+  for (size_t i = 0; i < header.size(); ++i) {
+    if (header[i] == "ns_per_op")
+      ns_col = static_cast<int>(i);
+    for (int m = 0; m < num_metrics; ++m)
+      if (header[i] == metric_column(m))
+        col[m] = static_cast<int>(i);
+  }
+
+  while (std::getline(in, line)) {
+    std::vector<std::string> f = split_csv(line);
+    if (f.size() < 3 || ns_col < 0 || int(f.size()) <= ns_col)
+      continue;
+    baseline_row row;
+    row.ns_per_op = std::strtod(f[ns_col].c_str(), 0);
+    for (int m = 0; m < num_metrics; ++m)
+      row.metric[m] = col[m] >= 0 && int(f.size()) > col[m] &&
+                              !f[col[m]].empty()
+                          ? std::strtod(f[col[m]].c_str(), 0)
+                          : -1;
+    out[f[1] + "/" + f[2]] = row;
+  }
+  return out;
+}
+
+inline std::string format_metric(double v, const char* missing) {
+  if (v < 0)
+    return missing;
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.3f", v);
+  return buf;
+}
+
+// baseline_ns_per_op and ratio of r, or -1 when no baseline row matched
+inline double baseline_ns(const result& r) {
+  return r.baseline_ns_per_op > 0 ? r.baseline_ns_per_op : -1;
+}
+
+inline double baseline_ratio(const result& r) {
+  return r.baseline_ns_per_op > 0 ? r.ns_per_op / r.baseline_ns_per_op : -1;
+}
+
+inline void print_csv(std::ostream& os, const std::string& impl,
+                      const std::vector<result>& rs) {
+  os << "impl,case,size,ops,ns_per_op,ops_per_sec,baseline_ns_per_op,ratio";
+  for (int m = 0; m < num_metrics; ++m)
+    os << "," << metric_column(m) << ",baseline_" << metric_column(m);
+  os << "\n";
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const result& r = rs[i];
+    char          buf[256];
+    snprintf(buf, sizeof(buf), "%s,%s,%lu,%lu,%.3f,%.0f", impl.c_str(),
+             r.name.c_str(), (unsigned long)r.size, (unsigned long)r.ops,
+             r.ns_per_op, r.ops_per_sec);
+    os << buf << "," << format_metric(baseline_ns(r), "") << ","
+       << format_metric(baseline_ratio(r), "");
+    for (int m = 0; m < num_metrics; ++m)
+      os << "," << format_metric(r.metric[m], "")
+         << "," << format_metric(r.baseline_metric[m], "");
+    os << "\n";
+  }
+}
+
+inline void print_json(std::ostream& os, const std::string& impl,
+                       const std::vector<result>& rs) {
+  os << "{\n  \"impl\": \"" << impl << "\",\n  \"results\": [\n";
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const result& r = rs[i];
+    char          buf[512];
+    snprintf(buf, sizeof(buf),
+             "    {\"case\": \"%s\", \"size\": %lu, \"ops\": %lu, "
+             "\"ns_per_op\": %.3f, \"ops_per_sec\": %.0f",
+             r.name.c_str(), (unsigned long)r.size, (unsigned long)r.ops,
+             r.ns_per_op, r.ops_per_sec);
+    os << buf << ", \"baseline_ns_per_op\": "
+       << format_metric(baseline_ns(r), "null")
+       << ", \"ratio\": " << format_metric(baseline_ratio(r), "null");
+    for (int m = 0; m < num_metrics; ++m)
+      os << ", \"" << metric_column(m)
+         << "\": " << format_metric(r.metric[m], "null")
+         << ", \"baseline_" << metric_column(m)
+         << "\": " << format_metric(r.baseline_metric[m], "null");
+    // non-empty buckets of the request size histogram as [min_bytes, count]
+    if (r.metric[metric_allocs] >= 0) {
+      os << ", \"alloc_size_histogram\": [";
+      const char* sep = "";
+      for (size_t b = 0; b < ft::allocation_stats::num_buckets; ++b)
+        if (r.alloc_histogram[b]) {
+          os << sep << "[" << (b ? size_t(1) << b : 0) << ", "
+             << r.alloc_histogram[b] << "]";
+          sep = ", ";
+        }
+      os << "]";
+    }
+    os << "}" << (i + 1 < rs.size() ? "," : "") << "\n";
+  }
+  os << "  ]\n}\n";
+}
+
+/**
+ * @brief Entry point used by the benchmark binaries.
+ * ratio is ns_per_op / baseline_ns_per_op: below 1 means faster than the
+ * baseline build.
+ */
+inline int run(int argc, char** argv, const std::string& impl,
+               const case_def* cases, size_t num_cases) {
+  options opt;
+  opt.impl = impl;
+  if (!parse_args(argc, argv, opt))
+    return 1;
+
+  std::map<std::string, baseline_row> baseline;
+  if (!opt.baseline.empty())
+    baseline = load_baseline(opt.baseline);
+
+  perf_counters  counters;
+  perf_counters* pc = 0;
+  if (opt.perf) {
+    if (counters.open() > 0)
+      pc = &counters;
+    else
+      std::cerr << "perf counters unavailable, reporting time only"
+                << std::endl;
+  }
+
+  std::vector<result> results;
+  unsigned long       sink = 0;
+  for (size_t i = 0; i < num_cases; ++i) {
+    if (!opt.filter.empty() &&
+        std::string(cases[i].name).find(opt.filter) == std::string::npos)
+      continue;
+    for (size_t s = 0; s < opt.sizes.size(); ++s) {
+      result r = run_case(cases[i], opt.sizes[s], opt, pc, sink);
+      std::ostringstream key;
+      key << r.name << "/" << r.size;
+      std::map<std::string, baseline_row>::iterator b =
+          baseline.find(key.str());
+      if (b != baseline.end()) {
+        r.baseline_ns_per_op = b->second.ns_per_op;
+        for (int m = 0; m < num_metrics; ++m)
+          r.baseline_metric[m] = b->second.metric[m];
+      }
+      results.push_back(r);
+      std::cerr << impl << " " << r.name << " n=" << r.size << ": "
+                << r.ns_per_op << " ns/op";
+      if (opt.alloc)
+        std::cerr << ", " << r.metric[metric_allocs] << " allocs/op, "
+                  << r.metric[metric_alloc_bytes] << " bytes/op, peak "
+                  << r.metric[metric_peak_bytes] << " bytes";
+      std::cerr << std::endl;
+    }
+  }
+
+  if (opt.format == "json")
+    print_json(std::cout, impl, results);
+  else
+    print_csv(std::cout, impl, results);
+  std::cerr << "sink: " << sink << std::endl;
+  return 0;
+}
+
+} /* namespace bench */
+
+#endif /* __BENCH_HPP__ */
@@ -0,0 +1,441 @@
+/*
+ * Throughput of the concurrent containers against their single-threaded
+ * counterparts behind a mutex. For every structure and --threads value t,
+ * the best of --reps runs is reported in operations per second over all
+ * threads.
+ *
+ * The stacks run t threads of --ops operations each, half inserts and half
+ * removals in a random order, on one shared instance that starts with
+ * --prefill elements. The queues run as a pipeline of --capacity slots:
+ * t / 2 producers push --ops elements each and the other threads pop them
+ * all, with one thread doing both in turn when t is 1. spsc_ring only runs
+ * with 1 or 2 threads. The vectors have t threads append --ops elements
+ * each.
+ */
+
+#include <pthread.h>
+#include "bench.hpp"
+#include "concurrent_stack.hpp"
+#include "concurrent_vector.hpp"
+#include "mpmc_ring.hpp"
+#include "queue.hpp"
+#include "spsc_ring.hpp"
+#include "stack.hpp"
+#include "vector.hpp"
+
+namespace {
+
+struct config {
+  std::vector<std::string> structures;
+  std::vector<size_t>      threads;
+  size_t                   ops;
+  size_t                   prefill;
+  size_t                   capacity;
+  size_t                   reps;
+
+  config() : ops(1000000), prefill(1000), capacity(1024), reps(3) {
+    structures.push_back("concurrent_stack");
+    structures.push_back("locked_stack");
+    structures.push_back("spsc_ring");
+    structures.push_back("mpmc_ring");
+    structures.push_back("locked_queue");
+    structures.push_back("concurrent_vector");
+    structures.push_back("locked_vector");
+    size_t hw = sysconf(_SC_NPROCESSORS_ONLN);
+    for (size_t t = 1; t < hw; t *= 2)
+      threads.push_back(t);
+    threads.push_back(hw < 1 ? 1 : hw);
+  }
+};
+
+/*
+ * Uniform interface over the stacks under test: push and try_pop; over the
+ * queues: a constructor taking the capacity, try_push and try_pop; and over
+ * the vectors: push_back.
+ */
+
+class locked_stack {
+  ft::stack<long> _s;
+  pthread_mutex_t _m;
+
+public:
+  locked_stack() { pthread_mutex_init(&_m, 0); }
+  ~locked_stack() { pthread_mutex_destroy(&_m); }
+
+  void push(long x) {
+    pthread_mutex_lock(&_m);
+    _s.push(x);
+    pthread_mutex_unlock(&_m);
+  }
+
+  bool try_pop(long& x) {
+    pthread_mutex_lock(&_m);
+    bool found = !_s.empty();
+    if (found) {
+      x = _s.top();
+      _s.pop();
+    }
+    pthread_mutex_unlock(&_m);
+    return found;
+  }
+};
+
+class locked_queue {
+  ft::queue<long> _q;
+  size_t          _capacity;
+  pthread_mutex_t _m;
+
+public:
+  explicit locked_queue(size_t capacity) : _capacity(capacity) {
+    pthread_mutex_init(&_m, 0);
+  }
+  ~locked_queue() { pthread_mutex_destroy(&_m); }
+
+  bool try_push(long x) {
+    pthread_mutex_lock(&_m);
+    bool room = _q.size() < _capacity;
+    if (room)
+      _q.push(x);
+    pthread_mutex_unlock(&_m);
+    return room;
+  }
+
+  bool try_pop(long& x) {
+    pthread_mutex_lock(&_m);
+    bool found = !_q.empty();
+    if (found) {
+      x = _q.front();
+      _q.pop();
+    }
+    pthread_mutex_unlock(&_m);
+    return found;
+  }
+};
+
+class locked_vector {
+  ft::vector<long> _v;
+  pthread_mutex_t  _m;
+
+public:
+  locked_vector() { pthread_mutex_init(&_m, 0); }
+  ~locked_vector() { pthread_mutex_destroy(&_m); }
+
+  void push_back(long x) {
+    pthread_mutex_lock(&_m);
+    _v.push_back(x);
+    pthread_mutex_unlock(&_m);
+  }
+};
+
+/**
+ * @return ns from the first worker leaving the start barrier to the last one
+ * finishing. The workers time themselves: main may not run again until they
+ * are done, so its own clock would miss their work.
+ */
+template <typename Worker>
+double span(const std::vector<Worker>& workers) {
+  double t0 = workers[0].t0;
+  double t1 = workers[0].t1;
+  for (size_t i = 1; i < workers.size(); ++i) {
+    if (workers[i].t0 < t0)
+      t0 = workers[i].t0;
+    if (workers[i].t1 > t1)
+      t1 = workers[i].t1;
+  }
+  return t1 - t0;
+}
+
+template <typename Structure>
+struct worker {
+  Structure*         s;
+  pthread_barrier_t* start;
+  size_t             ops;
+  unsigned long long seed;
+  unsigned long      sink;
+  double             t0;
+  double             t1;
+
+  static void* main(void* p) {
+    worker*   w = static_cast<worker*>(p);
+    bench::rng r(w->seed);
+    long       x = 0;
+    pthread_barrier_wait(w->start);
+    w->t0 = bench::now_ns();
+    for (size_t i = 0; i < w->ops; ++i) {
+      if (r.next() & 1)
+        w->s->push(long(i));
+      else if (w->s->try_pop(x))
+        w->sink += x;
+    }
+    w->t1 = bench::now_ns();
+    return 0;
+  }
+};
+
+/**
+ * @return wall time in ns of threads workers doing ops operations each
+ */
+template <typename Structure>
+double run_threads(size_t threads, const config& cfg, unsigned long& sink) {
+  Structure s;
+  for (size_t i = 0; i < cfg.prefill; ++i)
+    s.push(long(i));
+
+  pthread_barrier_t              start;
+  std::vector<pthread_t>         ids(threads);
+  std::vector<worker<Structure> > workers(threads);
+  pthread_barrier_init(&start, 0, threads + 1);
+  for (size_t i = 0; i < threads; ++i) {
+    worker<Structure> w = { &s, &start, cfg.ops, i + 1, 0, 0, 0 };
+    workers[i] = w;
+    pthread_create(&ids[i], 0, &worker<Structure>::main, &workers[i]);
+  }
+  pthread_barrier_wait(&start);
+  for (size_t i = 0; i < threads; ++i)
+    pthread_join(ids[i], 0);
+  pthread_barrier_destroy(&start);
+  for (size_t i = 0; i < threads; ++i)
+    sink += workers[i].sink;
+  return span(workers);
+}
+
+template <typename Queue>
+struct pipeline_worker {
+  Queue*             q;
+  pthread_barrier_t* start;
+  size_t             pushes;
+  size_t             pops;
+  unsigned long      sink;
+  double             t0;
+  double             t1;
+
+  static void* main(void* p) {
+    pipeline_worker* w = static_cast<pipeline_worker*>(p);
+    size_t           pushed = 0;
+    size_t           popped = 0;
+    long             x = 0;
+    pthread_barrier_wait(w->start);
+    w->t0 = bench::now_ns();
+    // a single thread alternates, and its pop always finds the element
+    while (pushed < w->pushes || popped < w->pops) {
+      if (pushed < w->pushes) {
+        ft::backoff b;
+        while (!w->q->try_push(long(pushed)))
+          b.pause();
+        ++pushed;
+      }
+      if (popped < w->pops) {
+        ft::backoff b;
+        while (!w->q->try_pop(x))
+          b.pause();
+        w->sink += x;
+        ++popped;
+      }
+    }
+    w->t1 = bench::now_ns();
+    return 0;
+  }
+};
+
+/**
+ * @return wall time in ns of a producer/consumer pipeline over threads
+ * threads; sets ops to the number of pushes and pops
+ */
+template <typename Queue>
+double run_pipeline(size_t threads, const config& cfg, unsigned long& sink,
+                    size_t& ops) {
+  Queue q(cfg.capacity);
+
+  size_t producers = threads == 1 ? 1 : threads / 2;
+  size_t consumers = threads - producers;
+  size_t total = producers * cfg.ops;
+  ops = 2 * total;
+
+  pthread_barrier_t                     start;
+  std::vector<pthread_t>                ids(threads);
+  std::vector<pipeline_worker<Queue> > workers(threads);
+  pthread_barrier_init(&start, 0, threads + 1);
+  for (size_t i = 0; i < threads; ++i) {
+    pipeline_worker<Queue> w = { &q, &start, 0, 0, 0, 0, 0 };
+    if (threads == 1) {
+      w.pushes = cfg.ops;
+      w.pops = cfg.ops;
+    } else if (i < producers)
+      w.pushes = cfg.ops;
+    else // share the pops out evenly among the consumers
+      w.pops = total / consumers + (i - producers < total % consumers);
+    workers[i] = w;
+    pthread_create(&ids[i], 0, &pipeline_worker<Queue>::main, &workers[i]);
+  }
+  pthread_barrier_wait(&start);
+  for (size_t i = 0; i < threads; ++i)
+    pthread_join(ids[i], 0);
+  pthread_barrier_destroy(&start);
+  for (size_t i = 0; i < threads; ++i)
+    sink += workers[i].sink;
+  return span(workers);
+}
+
+template <typename Vector>
+struct append_worker {
+  Vector*            v;
+  pthread_barrier_t* start;
+  size_t             ops;
+  double             t0;
+  double             t1;
+
+  static void* main(void* p) {
+    append_worker* w = static_cast<append_worker*>(p);
+    pthread_barrier_wait(w->start);
+    w->t0 = bench::now_ns();
+    for (size_t i = 0; i < w->ops; ++i)
+      w->v->push_back(long(i));
+    w->t1 = bench::now_ns();
+    return 0;
+  }
+};
+
+/**
+ * @return wall time in ns of threads threads appending cfg.ops elements
+ * each; sets ops to the number of appends
+ */
+template <typename Vector>
+double run_append(size_t threads, const config& cfg, unsigned long&,
+                  size_t& ops) {
+  Vector v;
+  ops = threads * cfg.ops;
+
+  pthread_barrier_t                    start;
+  std::vector<pthread_t>               ids(threads);
+  std::vector<append_worker<Vector> > workers(threads);
+  pthread_barrier_init(&start, 0, threads + 1);
+  for (size_t i = 0; i < threads; ++i) {
+    append_worker<Vector> w = { &v, &start, cfg.ops, 0, 0 };
+    workers[i] = w;
+    pthread_create(&ids[i], 0, &append_worker<Vector>::main, &workers[i]);
+  }
+  pthread_barrier_wait(&start);
+  for (size_t i = 0; i < threads; ++i)
+    pthread_join(ids[i], 0);
+  pthread_barrier_destroy(&start);
+  return span(workers);
+}
+
+template <typename Structure>
+double run_stack(size_t threads, const config& cfg, unsigned long& sink,
+                 size_t& ops) {
+  ops = threads * cfg.ops;
+  return run_threads<Structure>(threads, cfg, sink);
+}
+
+typedef double (*run_fn)(size_t, const config&, unsigned long&, size_t&);
+
+struct structure_def {
+  const char* name;
+  run_fn      run;
+  size_t      max_threads; // 0 for any number
+};
+
+const structure_def structures[] = {
+  { "concurrent_stack", &run_stack<ft::concurrent_stack<long> >, 0 },
+  { "locked_stack", &run_stack<locked_stack>, 0 },
+  { "spsc_ring", &run_pipeline<ft::spsc_ring<long> >, 2 },
+  { "mpmc_ring", &run_pipeline<ft::mpmc_ring<long> >, 0 },
+  { "locked_queue", &run_pipeline<locked_queue>, 0 },
+  { "concurrent_vector", &run_append<ft::concurrent_vector<long> >, 0 },
+  { "locked_vector", &run_append<locked_vector>, 0 },
+};
+
+const size_t num_structures = sizeof(structures) / sizeof(structures[0]);
+
+const structure_def* find_structure(const std::string& name) {
+  for (size_t i = 0; i < num_structures; ++i)
+    if (name == structures[i].name)
+      return &structures[i];
+  return 0;
+}
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> out;
+  std::stringstream        ss(s);
+  std::string              item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty())
+      out.push_back(item);
+  return out;
+}
+
+bool parse_args(int argc, char** argv, config& cfg) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 13, "--structures=") == 0)
+      cfg.structures = split(a.substr(13));
+    else if (a.compare(0, 10, "--threads=") == 0)
+      cfg.threads = bench::parse_sizes(a.substr(10));
+    else if (a.compare(0, 6, "--ops=") == 0)
+      cfg.ops = std::strtoul(a.substr(6).c_str(), 0, 10);
+    else if (a.compare(0, 10, "--prefill=") == 0)
+      cfg.prefill = std::strtoul(a.substr(10).c_str(), 0, 10);
+    else if (a.compare(0, 11, "--capacity=") == 0)
+      cfg.capacity = std::strtoul(a.substr(11).c_str(), 0, 10);
+    else if (a.compare(0, 7, "--reps=") == 0)
+      cfg.reps = std::strtoul(a.substr(7).c_str(), 0, 10);
+    else {
+      std::cerr << "usage: " << argv[0] << " [--structures=name,..]"
+                << " [--threads=1,2,4,..] [--ops=per thread]"
+                   " [--prefill=count] [--capacity=slots] [--reps=count]"
+                << std::endl;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < cfg.structures.size(); ++i)
+    if (find_structure(cfg.structures[i]) == 0) {
+      std::cerr << argv[0] << ": unknown structure " << cfg.structures[i]
+                << std::endl;
+      return false;
+    }
+  for (size_t i = 0; i < cfg.threads.size(); ++i)
+    if (cfg.threads[i] == 0) {
+      std::cerr << argv[0] << ": thread counts start at 1" << std::endl;
+      return false;
+    }
+  if (cfg.ops == 0 || cfg.capacity == 0 || cfg.reps == 0) {
+    std::cerr << argv[0] << ": --ops, --capacity and --reps must be positive"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  config cfg;
+  if (!parse_args(argc, argv, cfg))
+    return 1;
+
+  unsigned long sink = 0;
+  std::cout << "structure,threads,ops,ms,mops_per_s\n";
+  for (size_t s = 0; s < cfg.structures.size(); ++s) {
+    const structure_def* def = find_structure(cfg.structures[s]);
+    for (size_t t = 0; t < cfg.threads.size(); ++t) {
+      size_t threads = cfg.threads[t];
+      if (def->max_threads != 0 && threads > def->max_threads)
+        continue;
+      double best = 0;
+      size_t total = 0;
+      for (size_t r = 0; r < cfg.reps; ++r) {
+        double ns = def->run(threads, cfg, sink, total);
+        if (r == 0 || ns < best)
+          best = ns;
+      }
+      char buf[256];
+      snprintf(buf, sizeof(buf), "%s,%lu,%lu,%.3f,%.2f\n", def->name,
+               (unsigned long)threads, (unsigned long)total, best / 1e6,
+               total / best * 1e3);
+      std::cout << buf << std::flush;
+    }
+  }
+  std::cerr << "sink: " << sink << std::endl;
+  return 0;
+}
@@ -0,0 +1,120 @@
+#ifndef __HISTOGRAM_HPP__
+#define __HISTOGRAM_HPP__
+
+/*
+ * Log-linear latency histogram in the style of HdrHistogram: every power of
+ * two range is split into sub_buckets linear slots, so any recorded value is
+ * reported within 1 / sub_buckets (under 1%) of its true value while the
+ * whole 64-bit range fits in a fixed array. Recording is a couple of shifts
+ * and an increment, cheap enough to run around every single operation.
+ */
+
+#include <cstddef>
+#include <cstring>
+
+namespace bench {
+
+class latency_histogram {
+public:
+  typedef unsigned long long value_type;
+
+  static const int    sub_bits = 7;
+  static const size_t sub_buckets = size_t(1) << sub_bits;
+  static const size_t num_slots = (64 - sub_bits + 1) * sub_buckets;
+
+  latency_histogram() { reset(); }
+
+  void reset() {
+    std::memset(_counts, 0, sizeof(_counts));
+    _count = 0;
+    _sum = 0;
+    _min = ~value_type(0);
+    _max = 0;
+  }
+
+  void record(value_type v) {
+    ++_counts[slot(v)];
+    ++_count;
+    _sum += v;
+    if (v < _min)
+      _min = v;
+    if (v > _max)
+      _max = v;
+  }
+
+  void merge(const latency_histogram& x) {
+    for (size_t i = 0; i < num_slots; ++i)
+      _counts[i] += x._counts[i];
+    _count += x._count;
+    _sum += x._sum;
+    if (x._min < _min)
+      _min = x._min;
+    if (x._max > _max)
+      _max = x._max;
+  }
+
+  size_t     count() const { return _count; }
+  value_type min() const { return _count ? _min : 0; }
+  value_type max() const { return _max; }
+  double     mean() const { return _count ? double(_sum) / _count : 0; }
+
+  /**
+   * @brief Smallest recorded value such that at least p percent of all
+   * values are less or equal, reported as the highest value of its slot
+   * and never above the exact max.
+   */
+  value_type percentile(double p) const {
+    if (_count == 0)
+      return 0;
+    size_t target = static_cast<size_t>(p / 100.0 * _count + 0.5);
+    if (target == 0)
+      target = 1;
+    if (target > _count)
+      target = _count;
+    size_t seen = 0;
+    for (size_t i = 0; i < num_slots; ++i) {
+      seen += _counts[i];
+      if (seen >= target) {
+        value_type v = slot_highest(i);
+        return v < _max ? v : _max;
+      }
+    }
+    return _max;
+  }
+
+  static size_t slot(value_type v) {
+    if (v < 2 * sub_buckets)
+      return static_cast<size_t>(v);
+    int msb = 63;
+    while (!(v >> msb))
+      --msb;
+    int shift = msb - sub_bits;
+    return (shift + 1) * sub_buckets + static_cast<size_t>(v >> shift) -
+           sub_buckets;
+  }
+
+  static value_type slot_lowest(size_t i) {
+    if (i < 2 * sub_buckets)
+      return i;
+    int shift = static_cast<int>(i / sub_buckets) - 1;
+    return value_type(i % sub_buckets + sub_buckets) << shift;
+  }
+
+  static value_type slot_highest(size_t i) {
+    if (i < 2 * sub_buckets)
+      return i;
+    int shift = static_cast<int>(i / sub_buckets) - 1;
+    return slot_lowest(i) + (value_type(1) << shift) - 1;
+  }
+
+private:
+  size_t     _counts[num_slots];
+  size_t     _count;
+  value_type _sum;
+  value_type _min;
+  value_type _max;
+};
+
+} /* namespace bench */
+
+#endif /* __HISTOGRAM_HPP__ */
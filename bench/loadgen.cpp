@@ -0,0 +1,362 @@
+/*
+ * Load generator: drives a mixed read/write/erase workload against one
+ * container and times every single operation into a latency histogram, so
+ * that reallocation spikes and rebalancing bursts show up in the tail
+ * instead of disappearing into an average. Built against ft (loadgen_ft)
+ * and, with FT_STL, against std (loadgen_std).
+ *
+ * With --record=path nothing is timed: the same operation stream is run
+ * through the ft::traced_* wrappers and written out as a trace for replay.
+ *
+ * Operations per container:
+ *   map, set  read = find, write = insert, erase = erase by key
+ *   vector    read = operator[] at key % size, write = push_back,
+ *             erase = pop_back (kept O(1) so growth spikes stand out)
+ */
+
+#include "bench.hpp"
+#include "histogram.hpp"
+#include "trace.hpp"
+#include "workload.hpp"
+
+#ifdef FT_STL
+  #include <map>
+  #include <set>
+  #include <vector>
+  namespace lib = std;
+  #define BENCH_IMPL "std"
+#else
+  #include "map.hpp"
+  #include "set.hpp"
+  #include "vector.hpp"
+  namespace lib = ft;
+  #define BENCH_IMPL "ft"
+#endif
+
+namespace {
+
+enum op_type { op_read, op_write, op_erase, num_ops };
+
+const char* op_names[num_ops] = { "read", "write", "erase" };
+
+struct config {
+  std::string                        container;
+  std::string                        format;
+  std::string                        record;
+  size_t                             ops;
+  size_t                             keys;
+  size_t                             prefill;
+  double                             mix[num_ops];
+  bench::key_generator::distribution dist;
+  double                             theta;
+  unsigned long long                 seed;
+
+  config()
+  : container("map"), format("text"), ops(1000000), keys(100000),
+    prefill(size_t(-1)), dist(bench::key_generator::uniform), theta(0.99),
+    seed(42) {
+    mix[op_read] = 80;
+    mix[op_write] = 15;
+    mix[op_erase] = 5;
+  }
+};
+
+bool parse_args(int argc, char** argv, config& cfg) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 12, "--container=") == 0)
+      cfg.container = a.substr(12);
+    else if (a.compare(0, 9, "--format=") == 0)
+      cfg.format = a.substr(9);
+    else if (a.compare(0, 6, "--ops=") == 0)
+      cfg.ops = std::strtoul(a.substr(6).c_str(), 0, 10);
+    else if (a.compare(0, 7, "--keys=") == 0)
+      cfg.keys = std::strtoul(a.substr(7).c_str(), 0, 10);
+    else if (a.compare(0, 10, "--prefill=") == 0)
+      cfg.prefill = std::strtoul(a.substr(10).c_str(), 0, 10);
+    else if (a.compare(0, 7, "--read=") == 0)
+      cfg.mix[op_read] = std::strtod(a.substr(7).c_str(), 0);
+    else if (a.compare(0, 8, "--write=") == 0)
+      cfg.mix[op_write] = std::strtod(a.substr(8).c_str(), 0);
+    else if (a.compare(0, 8, "--erase=") == 0)
+      cfg.mix[op_erase] = std::strtod(a.substr(8).c_str(), 0);
+    else if (a.compare(0, 7, "--dist=") == 0 &&
+             bench::key_generator::parse(a.substr(7), cfg.dist))
+      ;
+    else if (a.compare(0, 8, "--theta=") == 0)
+      cfg.theta = std::strtod(a.substr(8).c_str(), 0);
+    else if (a.compare(0, 7, "--seed=") == 0)
+      cfg.seed = std::strtoull(a.substr(7).c_str(), 0, 10);
+    else if (a.compare(0, 9, "--record=") == 0)
+      cfg.record = a.substr(9);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--container=map|set|vector] [--ops=n] [--keys=n]"
+                   " [--prefill=n] [--read=w] [--write=w] [--erase=w]"
+                   " [--dist=uniform|zipf|sequential] [--theta=t]"
+                   " [--seed=n] [--format=text|csv] [--record=trace]"
+                << std::endl;
+      return false;
+    }
+  }
+  if (cfg.theta <= 0 || cfg.theta >= 1 ||
+      cfg.mix[op_read] + cfg.mix[op_write] + cfg.mix[op_erase] <= 0 ||
+      (cfg.container != "map" && cfg.container != "set" &&
+       cfg.container != "vector")) {
+    std::cerr << argv[0] << ": invalid configuration" << std::endl;
+    return false;
+  }
+  if (cfg.keys == 0) { // keys are drawn, and prefilled, modulo the key count
+    std::cerr << argv[0] << ": --keys must be at least 1" << std::endl;
+    return false;
+  }
+  if (cfg.prefill == size_t(-1))
+    cfg.prefill = cfg.keys / 2;
+  return true;
+}
+
+/**
+ * @brief The whole operation stream, drawn up front so that generating keys
+ * is not part of any measured operation.
+ */
+struct workload {
+  std::vector<unsigned char> types;
+  std::vector<int>           keys;
+
+  explicit workload(const config& cfg) : types(cfg.ops), keys(cfg.ops) {
+    bench::key_generator gen(cfg.dist, cfg.keys, cfg.theta, cfg.seed);
+    double total = cfg.mix[op_read] + cfg.mix[op_write] + cfg.mix[op_erase];
+    double read_cut = cfg.mix[op_read] / total;
+    double write_cut = read_cut + cfg.mix[op_write] / total;
+    for (size_t i = 0; i < cfg.ops; ++i) {
+      double u = gen.uniform_real();
+      types[i] = u < read_cut ? op_read : u < write_cut ? op_write : op_erase;
+      keys[i] = static_cast<int>(gen.next());
+    }
+  }
+};
+
+/**
+ * @brief Cost of one now_ns() pair, included in every recorded latency.
+ */
+double timer_overhead_ns() {
+  double best = 1e9;
+  for (int i = 0; i < 1000; ++i) {
+    double t0 = bench::now_ns();
+    double t1 = bench::now_ns();
+    if (t1 - t0 < best)
+      best = t1 - t0;
+  }
+  return best;
+}
+
+inline void record(bench::latency_histogram* hist, int type, double t0,
+                   double t1) {
+  hist[type].record(static_cast<unsigned long long>(t1 - t0));
+}
+
+unsigned long run_map(const config& cfg, const workload& w,
+                      bench::latency_histogram* hist) {
+  lib::map<int, int> m;
+  unsigned long      sink = 0;
+  for (size_t i = 0; i < cfg.prefill; ++i)
+    m.insert(lib::make_pair(static_cast<int>(i % cfg.keys), 0));
+  for (size_t i = 0; i < w.keys.size(); ++i) {
+    int    k = w.keys[i];
+    double t0 = bench::now_ns();
+    switch (w.types[i]) {
+    case op_read:
+      sink += m.find(k) != m.end();
+      break;
+    case op_write:
+      sink += m.insert(lib::make_pair(k, k)).second;
+      break;
+    default:
+      sink += m.erase(k);
+    }
+    record(hist, w.types[i], t0, bench::now_ns());
+  }
+  return sink + m.size();
+}
+
+unsigned long run_set(const config& cfg, const workload& w,
+                      bench::latency_histogram* hist) {
+  lib::set<int> s;
+  unsigned long sink = 0;
+  for (size_t i = 0; i < cfg.prefill; ++i)
+    s.insert(static_cast<int>(i % cfg.keys));
+  for (size_t i = 0; i < w.keys.size(); ++i) {
+    int    k = w.keys[i];
+    double t0 = bench::now_ns();
+    switch (w.types[i]) {
+    case op_read:
+      sink += s.find(k) != s.end();
+      break;
+    case op_write:
+      sink += s.insert(k).second;
+      break;
+    default:
+      sink += s.erase(k);
+    }
+    record(hist, w.types[i], t0, bench::now_ns());
+  }
+  return sink + s.size();
+}
+
+unsigned long run_vector(const config& cfg, const workload& w,
+                         bench::latency_histogram* hist) {
+  lib::vector<int> v;
+  unsigned long    sink = 0;
+  for (size_t i = 0; i < cfg.prefill; ++i)
+    v.push_back(static_cast<int>(i));
+  for (size_t i = 0; i < w.keys.size(); ++i) {
+    int    k = w.keys[i];
+    double t0 = bench::now_ns();
+    switch (w.types[i]) {
+    case op_read:
+      if (!v.empty())
+        sink += v[k % v.size()];
+      break;
+    case op_write:
+      v.push_back(k);
+      break;
+    default:
+      if (!v.empty())
+        v.pop_back();
+    }
+    record(hist, w.types[i], t0, bench::now_ns());
+  }
+  return sink + v.size();
+}
+
+/**
+ * @brief Runs the prefill and the workload through a recording wrapper.
+ */
+void record_trace(const config& cfg, const workload& w) {
+  if (cfg.container == "map") {
+    ft::trace_writer                     out(cfg.record, ft::trace_map);
+    ft::traced_map<lib::map<int, int> >  m(out);
+    for (size_t i = 0; i < cfg.prefill; ++i)
+      m.insert(lib::make_pair(static_cast<int>(i % cfg.keys), 0));
+    for (size_t i = 0; i < w.keys.size(); ++i) {
+      int k = w.keys[i];
+      if (w.types[i] == op_read)
+        m.find(k);
+      else if (w.types[i] == op_write)
+        m.insert(lib::make_pair(k, k));
+      else
+        m.erase(k);
+    }
+    out.flush();
+  } else if (cfg.container == "set") {
+    ft::trace_writer                     out(cfg.record, ft::trace_set);
+    ft::traced_set<lib::set<int> >       s(out);
+    for (size_t i = 0; i < cfg.prefill; ++i)
+      s.insert(static_cast<int>(i % cfg.keys));
+    for (size_t i = 0; i < w.keys.size(); ++i) {
+      int k = w.keys[i];
+      if (w.types[i] == op_read)
+        s.find(k);
+      else if (w.types[i] == op_write)
+        s.insert(k);
+      else
+        s.erase(k);
+    }
+    out.flush();
+  } else {
+    ft::trace_writer                     out(cfg.record, ft::trace_vector);
+    ft::traced_vector<lib::vector<int> > v(out);
+    for (size_t i = 0; i < cfg.prefill; ++i)
+      v.push_back(static_cast<int>(i));
+    for (size_t i = 0; i < w.keys.size(); ++i) {
+      int k = w.keys[i];
+      if (w.types[i] == op_read) {
+        if (!v.empty())
+          v.at(k % v.size());
+      } else if (w.types[i] == op_write)
+        v.push_back(k);
+      else if (!v.empty())
+        v.pop_back();
+    }
+    out.flush();
+  }
+}
+
+void print_text(const config& cfg, const bench::latency_histogram* hist,
+                double overhead) {
+  std::cout << BENCH_IMPL << " " << cfg.container << ": " << cfg.ops
+            << " ops, " << cfg.keys << " keys, timer overhead ~" << overhead
+            << " ns (included below)\n";
+  char buf[256];
+  snprintf(buf, sizeof(buf), "%-6s %10s %9s %9s %9s %9s %9s %11s\n", "op",
+           "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+  std::cout << buf;
+  for (int t = 0; t <= num_ops; ++t) {
+    const bench::latency_histogram& h = hist[t];
+    if (h.count() == 0)
+      continue;
+    snprintf(buf, sizeof(buf),
+             "%-6s %10lu %9.1f %9llu %9llu %9llu %9llu %11llu\n",
+             t < num_ops ? op_names[t] : "all", (unsigned long)h.count(),
+             h.mean(), h.percentile(50), h.percentile(90), h.percentile(99),
+             h.percentile(99.9), h.max());
+    std::cout << buf;
+  }
+}
+
+void print_csv(const config& cfg, const bench::latency_histogram* hist) {
+  std::cout << "impl,container,op,count,mean_ns,p50_ns,p90_ns,p99_ns,"
+               "p999_ns,max_ns\n";
+  char buf[256];
+  for (int t = 0; t <= num_ops; ++t) {
+    const bench::latency_histogram& h = hist[t];
+    if (h.count() == 0)
+      continue;
+    snprintf(buf, sizeof(buf), "%s,%s,%s,%lu,%.1f,%llu,%llu,%llu,%llu,%llu\n",
+             BENCH_IMPL, cfg.container.c_str(),
+             t < num_ops ? op_names[t] : "all", (unsigned long)h.count(),
+             h.mean(), h.percentile(50), h.percentile(90), h.percentile(99),
+             h.percentile(99.9), h.max());
+    std::cout << buf;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  config cfg;
+  if (!parse_args(argc, argv, cfg))
+    return 1;
+
+  workload w(cfg);
+  if (!cfg.record.empty()) {
+    try {
+      record_trace(cfg, w);
+    } catch (const std::exception& e) {
+      std::cerr << argv[0] << ": " << e.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // one per operation type plus the combined one; ~60KB each, keep them off
+  // the stack
+  std::vector<bench::latency_histogram> hist(num_ops + 1);
+  unsigned long                         sink;
+
+  if (cfg.container == "map")
+    sink = run_map(cfg, w, &hist[0]);
+  else if (cfg.container == "set")
+    sink = run_set(cfg, w, &hist[0]);
+  else
+    sink = run_vector(cfg, w, &hist[0]);
+  for (int t = 0; t < num_ops; ++t)
+    hist[num_ops].merge(hist[t]);
+
+  if (cfg.format == "csv")
+    print_csv(cfg, &hist[0]);
+  else
+    print_text(cfg, &hist[0], timer_overhead_ns());
+  std::cerr << "sink: " << sink << std::endl;
+  return 0;
+}
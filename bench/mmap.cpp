@@ -0,0 +1,144 @@
+/*
+ * Startup cost of ft::mmap_vector against reading the same data with fread.
+ * It writes --n 8 byte elements to --path through an mmap_vector, then for
+ * --reps rounds times opening the file read-only with mmap_vector and
+ * reading its elements into an ft::vector with fread, and reports the best
+ * of each. scan_ms adds one pass over every element to the open, which is
+ * where the mapped pages fault in. The file was just written, so both read
+ * from the page cache: the numbers compare copying against mapping, not
+ * disk speed.
+ */
+
+#include <cstdio>
+#include "bench.hpp"
+#include "mmap_vector.hpp"
+#include "vector.hpp"
+
+namespace {
+
+typedef long long value_type;
+
+struct config {
+  std::string path;
+  size_t      n;
+  size_t      reps;
+
+  config() : path("mmap_bench.dat"), n(20000000), reps(5) { }
+};
+
+void write_file(const config& cfg) {
+  ft::mmap_vector<value_type> v(cfg.path, ft::mmap_truncate);
+  v.reserve(cfg.n);
+  bench::rng r(42);
+  for (size_t i = 0; i < cfg.n; ++i)
+    v.push_back(static_cast<value_type>(r.next()));
+  v.sync();
+}
+
+value_type sum(const value_type* first, const value_type* last) {
+  value_type s = 0;
+  for (; first != last; ++first)
+    s += *first;
+  return s;
+}
+
+/**
+ * @brief Opens the file with mmap_vector, then walks it. Sets open_ns to
+ * the time to open and scan_ns to the time to open and walk.
+ */
+void run_mmap(const config& cfg, double& open_ns, double& scan_ns,
+              unsigned long& sink) {
+  double t0 = bench::now_ns();
+  ft::mmap_vector<value_type> v(cfg.path, ft::mmap_read_only);
+  double t1 = bench::now_ns();
+  sink += static_cast<unsigned long>(sum(v.begin(), v.end()));
+  double t2 = bench::now_ns();
+  open_ns = t1 - t0;
+  scan_ns = t2 - t0;
+}
+
+/**
+ * @brief Reads the elements of the file into an ft::vector, then walks it.
+ * Sets open_ns to the time to read and scan_ns to the time to read and walk.
+ */
+void run_fread(const config& cfg, double& open_ns, double& scan_ns,
+               unsigned long& sink) {
+  double t0 = bench::now_ns();
+  FILE* f = std::fopen(cfg.path.c_str(), "rb");
+  if (!f)
+    throw std::runtime_error("mmap_bench: cannot open " + cfg.path);
+  ft::vector<value_type> v(cfg.n);
+  size_t got = 0;
+  if (std::fseek(f, ft::mmap_vector<value_type>::header_size, SEEK_SET) == 0)
+    got = std::fread(v.data(), sizeof(value_type), cfg.n, f);
+  std::fclose(f);
+  if (got != cfg.n)
+    throw std::runtime_error("mmap_bench: short read from " + cfg.path);
+  double t1 = bench::now_ns();
+  sink += static_cast<unsigned long>(sum(v.data(), v.data() + v.size()));
+  double t2 = bench::now_ns();
+  open_ns = t1 - t0;
+  scan_ns = t2 - t0;
+}
+
+bool parse_args(int argc, char** argv, config& cfg) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 4, "--n=") == 0)
+      cfg.n = std::strtoul(a.substr(4).c_str(), 0, 10);
+    else if (a.compare(0, 7, "--path=") == 0)
+      cfg.path = a.substr(7);
+    else if (a.compare(0, 7, "--reps=") == 0)
+      cfg.reps = std::strtoul(a.substr(7).c_str(), 0, 10);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--n=count] [--path=file] [--reps=count]" << std::endl;
+      return false;
+    }
+  }
+  if (cfg.n == 0 || cfg.reps == 0 || cfg.path.empty()) {
+    std::cerr << argv[0] << ": --n and --reps must be positive, --path set"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  config cfg;
+  if (!parse_args(argc, argv, cfg))
+    return 1;
+
+  unsigned long sink = 0;
+  try {
+    write_file(cfg);
+    double best[2][2] = { { 0, 0 }, { 0, 0 } }; // [method][open, scan]
+    for (size_t r = 0; r < cfg.reps; ++r) {
+      double t[2][2];
+      run_mmap(cfg, t[0][0], t[0][1], sink);
+      run_fread(cfg, t[1][0], t[1][1], sink);
+      for (int m = 0; m < 2; ++m)
+        for (int k = 0; k < 2; ++k)
+          if (r == 0 || t[m][k] < best[m][k])
+            best[m][k] = t[m][k];
+    }
+    const char* methods[2] = { "mmap_vector", "fread" };
+    std::cout << "method,n,mb,open_ms,scan_ms\n";
+    for (int m = 0; m < 2; ++m) {
+      char buf[256];
+      snprintf(buf, sizeof(buf), "%s,%lu,%.1f,%.3f,%.3f\n", methods[m],
+               (unsigned long)cfg.n, cfg.n * sizeof(value_type) / 1e6,
+               best[m][0] / 1e6, best[m][1] / 1e6);
+      std::cout << buf;
+    }
+  } catch (std::exception& e) {
+    std::remove(cfg.path.c_str());
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+  std::remove(cfg.path.c_str());
+  std::cerr << "sink: " << sink << std::endl;
+  return 0;
+}
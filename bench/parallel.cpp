@@ -0,0 +1,269 @@
+/*
+ * Speedup of the parallel algorithms by thread count. For every algorithm
+ * and --threads value t it runs the algorithm over --n ints in a
+ * thread_pool of t - 1 workers (plus the calling thread) and reports the
+ * best of --reps runs next to the plain sequential algorithm: ft::sort,
+ * std::for_each, std::transform, std::accumulate and std::partial_sum.
+ * map_for_each and map_reduce do the same over an ft::map of --map-n
+ * entries, walked through its split_ranges(). The csv plots as one speedup
+ * curve per algorithm.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include "bench.hpp"
+#include "map.hpp"
+#include "parallel_algorithm.hpp"
+#include "vector.hpp"
+
+namespace {
+
+typedef ft::vector<int>   int_vector;
+typedef ft::map<int, int> int_map;
+
+struct config {
+  std::vector<std::string> algorithms;
+  std::vector<size_t>      threads;
+  size_t                   n;
+  size_t                   map_n;
+  size_t                   grain;
+  size_t                   reps;
+
+  config() : n(10000000), map_n(1000000), grain(0), reps(5) {
+    algorithms.push_back("for_each");
+    algorithms.push_back("transform");
+    algorithms.push_back("reduce");
+    algorithms.push_back("inclusive_scan");
+    algorithms.push_back("sort");
+    algorithms.push_back("map_for_each");
+    algorithms.push_back("map_reduce");
+    size_t hw = ft::thread_pool::hardware_concurrency();
+    for (size_t t = 1; t < hw; t *= 2)
+      threads.push_back(t);
+    threads.push_back(hw);
+  }
+};
+
+// A few multiplications per element, so that for_each and transform are
+// not purely bound by memory bandwidth.
+struct mix {
+  int operator()(int x) const {
+    unsigned h = unsigned(x) * 2654435761u;
+    h ^= h >> 15;
+    return int(h * 2246822519u);
+  }
+};
+
+struct mix_in_place {
+  void operator()(int& x) const { x = mix()(x); }
+};
+
+struct mix_value {
+  void operator()(int_map::value_type& x) const {
+    x.second = mix()(x.second);
+  }
+};
+
+struct add_value {
+  long long operator()(long long acc, const int_map::value_type& x) const {
+    return acc + x.second;
+  }
+};
+
+bool is_map_algorithm(const std::string& algorithm) {
+  return algorithm.compare(0, 4, "map_") == 0;
+}
+
+/**
+ * @brief Runs a map algorithm on m, in pool when there is one, else
+ * sequentially.
+ * @return time taken in ns
+ */
+double run_map_once(const std::string& algorithm, ft::thread_pool* pool,
+                    int_map& m, unsigned long& sink) {
+  double t0 = bench::now_ns();
+  if (algorithm == "map_for_each") {
+    if (pool)
+      ft::parallel_for_each(*pool, m, mix_value());
+    else
+      std::for_each(m.begin(), m.end(), mix_value());
+  } else {
+    long long r = 0;
+    if (pool)
+      r = ft::parallel_reduce(*pool, m, 0LL, add_value(),
+                              std::plus<long long>());
+    else
+      r = std::accumulate(m.begin(), m.end(), 0LL, add_value());
+    sink += static_cast<unsigned long>(r);
+  }
+  double t1 = bench::now_ns();
+  sink += m.begin()->second;
+  return t1 - t0;
+}
+
+/**
+ * @brief Runs one algorithm on v, in pool when there is one, else
+ * sequentially.
+ * @return time taken in ns
+ */
+double run_once(const std::string& algorithm, ft::thread_pool* pool,
+                int_vector& v, int_vector& out, size_t grain,
+                unsigned long& sink) {
+  double t0 = bench::now_ns();
+  if (algorithm == "for_each") {
+    if (pool)
+      ft::parallel_for_each(*pool, v.begin(), v.end(), mix_in_place(), grain);
+    else
+      std::for_each(v.begin(), v.end(), mix_in_place());
+  } else if (algorithm == "transform") {
+    if (pool)
+      ft::parallel_transform(*pool, v.begin(), v.end(), out.begin(), mix(),
+                             grain);
+    else
+      std::transform(v.begin(), v.end(), out.begin(), mix());
+  } else if (algorithm == "reduce") {
+    long long r = 0;
+    if (pool)
+      r = ft::parallel_reduce(*pool, v.begin(), v.end(), 0LL,
+                              std::plus<long long>(), grain);
+    else
+      r = std::accumulate(v.begin(), v.end(), 0LL);
+    sink += static_cast<unsigned long>(r);
+  } else if (algorithm == "inclusive_scan") {
+    if (pool)
+      ft::parallel_inclusive_scan(*pool, v.begin(), v.end(), out.begin(),
+                                  std::plus<int>(), grain);
+    else
+      std::partial_sum(v.begin(), v.end(), out.begin());
+  } else {
+    if (pool)
+      ft::parallel_sort(*pool, v.begin(), v.end(), std::less<int>(), grain);
+    else
+      ft::sort(v.begin(), v.end());
+  }
+  double t1 = bench::now_ns();
+  sink += v[v.size() / 2] + out[out.size() / 2];
+  return t1 - t0;
+}
+
+/**
+ * @return best time over cfg.reps runs, each on a fresh copy of keys; the
+ * map algorithms all run on the same map
+ */
+double measure(const config& cfg, const std::string& algorithm,
+               ft::thread_pool* pool, const int_vector& keys, int_map& m,
+               unsigned long& sink) {
+  double best = 0;
+  for (size_t r = 0; r < cfg.reps; ++r) {
+    double t;
+    if (is_map_algorithm(algorithm))
+      t = run_map_once(algorithm, pool, m, sink);
+    else {
+      int_vector v(keys);
+      int_vector out(keys.size());
+      t = run_once(algorithm, pool, v, out, cfg.grain, sink);
+    }
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> out;
+  std::stringstream        ss(s);
+  std::string              item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty())
+      out.push_back(item);
+  return out;
+}
+
+bool parse_args(int argc, char** argv, config& cfg) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 13, "--algorithms=") == 0)
+      cfg.algorithms = split(a.substr(13));
+    else if (a.compare(0, 10, "--threads=") == 0)
+      cfg.threads = bench::parse_sizes(a.substr(10));
+    else if (a.compare(0, 4, "--n=") == 0)
+      cfg.n = std::strtoul(a.substr(4).c_str(), 0, 10);
+    else if (a.compare(0, 8, "--map-n=") == 0)
+      cfg.map_n = std::strtoul(a.substr(8).c_str(), 0, 10);
+    else if (a.compare(0, 8, "--grain=") == 0)
+      cfg.grain = std::strtoul(a.substr(8).c_str(), 0, 10);
+    else if (a.compare(0, 7, "--reps=") == 0)
+      cfg.reps = std::strtoul(a.substr(7).c_str(), 0, 10);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--algorithms=for_each,transform,reduce,inclusive_scan,"
+                   "sort,map_for_each,map_reduce] [--threads=1,2,4,..]"
+                   " [--n=count] [--map-n=count] [--grain=elements]"
+                   " [--reps=count]"
+                << std::endl;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < cfg.algorithms.size(); ++i) {
+    const std::string& a = cfg.algorithms[i];
+    if (a != "for_each" && a != "transform" && a != "reduce" &&
+        a != "inclusive_scan" && a != "sort" && a != "map_for_each" &&
+        a != "map_reduce") {
+      std::cerr << argv[0] << ": unknown algorithm " << a << std::endl;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < cfg.threads.size(); ++i)
+    if (cfg.threads[i] == 0) {
+      std::cerr << argv[0] << ": thread counts start at 1" << std::endl;
+      return false;
+    }
+  if (cfg.n == 0 || cfg.map_n == 0 || cfg.reps == 0) {
+    std::cerr << argv[0] << ": --n, --map-n and --reps must be positive"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  config cfg;
+  if (!parse_args(argc, argv, cfg))
+    return 1;
+
+  bench::rng r(42);
+  int_vector keys(cfg.n);
+  for (size_t i = 0; i < cfg.n; ++i)
+    keys[i] = r.next_int();
+  int_map m;
+  for (size_t a = 0; a < cfg.algorithms.size(); ++a)
+    if (is_map_algorithm(cfg.algorithms[a])) {
+      for (size_t i = 0; i < cfg.map_n; ++i)
+        m.insert(ft::make_pair(r.next_int(), int(i)));
+      break;
+    }
+
+  unsigned long sink = 0;
+  std::cout << "algorithm,n,threads,grain,sequential_ms,ms,speedup,"
+               "efficiency\n";
+  for (size_t a = 0; a < cfg.algorithms.size(); ++a) {
+    const std::string& algorithm = cfg.algorithms[a];
+    double             seq = measure(cfg, algorithm, 0, keys, m, sink);
+    size_t             n = is_map_algorithm(algorithm) ? m.size() : cfg.n;
+    for (size_t t = 0; t < cfg.threads.size(); ++t) {
+      ft::thread_pool pool(cfg.threads[t] - 1);
+      double          par = measure(cfg, algorithm, &pool, keys, m, sink);
+      char            buf[256];
+      snprintf(buf, sizeof(buf), "%s,%lu,%lu,%lu,%.3f,%.3f,%.2f,%.2f\n",
+               algorithm.c_str(), (unsigned long)n,
+               (unsigned long)cfg.threads[t], (unsigned long)cfg.grain,
+               seq / 1e6, par / 1e6, seq / par, seq / par / cfg.threads[t]);
+      std::cout << buf << std::flush;
+    }
+  }
+  std::cerr << "sink: " << sink << std::endl;
+  return 0;
+}
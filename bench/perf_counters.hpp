@@ -0,0 +1,183 @@
+#ifndef __PERF_COUNTERS_HPP__
+#define __PERF_COUNTERS_HPP__
+
+/*
+ * Hardware performance counters around a measured region, read through the
+ * Linux perf_event_open(2) interface. Every event is opened on its own so
+ * that one unsupported event (common in VMs and containers, or with a
+ * restrictive kernel.perf_event_paranoid) does not take the others down.
+ * Events that could not be opened report as unavailable; on other systems
+ * all of them are.
+ */
+
+#include <cstring>
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace bench {
+
+class perf_counters {
+public:
+  enum event {
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    branch_misses,
+    dtlb_misses,
+    num_events
+  };
+
+  static const char* name(int e) {
+    static const char* names[num_events] = {
+      "cycles",      "instructions",  "l1d_misses",
+      "llc_misses",  "branch_misses", "dtlb_misses",
+    };
+    return names[e];
+  }
+
+  perf_counters() {
+    for (int i = 0; i < num_events; ++i) {
+      _fd[i] = -1;
+      _value[i] = 0;
+    }
+  }
+
+  ~perf_counters() { close(); }
+
+  /**
+   * @brief Opens every event for the calling thread, user space only.
+   * @return number of events that are available
+   */
+  int open() {
+    int n = 0;
+#ifdef __linux__
+    for (int i = 0; i < num_events; ++i) {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      _describe(static_cast<event>(i), attr);
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format =
+          PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      _fd[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1,
+                                        -1, 0));
+      if (_fd[i] >= 0)
+        ++n;
+    }
+#endif
+    return n;
+  }
+
+  void close() {
+#ifdef __linux__
+    for (int i = 0; i < num_events; ++i)
+      if (_fd[i] >= 0)
+        ::close(_fd[i]);
+#endif
+    for (int i = 0; i < num_events; ++i)
+      _fd[i] = -1;
+  }
+
+  bool available(int e) const { return _fd[e] >= 0; }
+
+  bool any_available() const {
+    for (int i = 0; i < num_events; ++i)
+      if (_fd[i] >= 0)
+        return true;
+    return false;
+  }
+
+  void start() {
+#ifdef __linux__
+    for (int i = 0; i < num_events; ++i)
+      if (_fd[i] >= 0) {
+        ioctl(_fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  /**
+   * @brief Stops counting and adds the counts since start() to value(),
+   * scaled up when the kernel had to multiplex the counters.
+   */
+  void stop() {
+#ifdef __linux__
+    for (int i = 0; i < num_events; ++i) {
+      if (_fd[i] < 0)
+        continue;
+      ioctl(_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+      unsigned long long buf[3] = { 0, 0, 0 };
+      if (read(_fd[i], buf, sizeof(buf)) != sizeof(buf))
+        continue;
+      double v = static_cast<double>(buf[0]);
+      if (buf[2] != 0 && buf[2] < buf[1])
+        v *= static_cast<double>(buf[1]) / buf[2];
+      _value[i] += v;
+    }
+#endif
+  }
+
+  void reset_values() {
+    for (int i = 0; i < num_events; ++i)
+      _value[i] = 0;
+  }
+
+  double value(int e) const { return _value[e]; }
+
+private:
+  int    _fd[num_events];
+  double _value[num_events];
+
+  perf_counters(const perf_counters&);
+  perf_counters& operator=(const perf_counters&);
+
+#ifdef __linux__
+  static void _describe(event e, struct perf_event_attr& attr) {
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (e) {
+    case cycles:
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case instructions:
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case branch_misses:
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case l1d_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_L1D |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case llc_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_LL |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case dtlb_misses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    default:
+      break;
+    }
+  }
+#endif
+};
+
+} /* namespace bench */
+
+#endif /* __PERF_COUNTERS_HPP__ */
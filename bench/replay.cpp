@@ -0,0 +1,212 @@
+/*
+ * Replays a trace recorded with the ft::traced_* wrappers (or
+ * `loadgen --record`) against ft (replay_ft) or, with FT_STL, std
+ * (replay_std) containers of long long. The trace is loaded into memory
+ * first so that only container operations are timed. Every operation's
+ * observed result is compared with the recorded one; a mismatch is a
+ * divergence.
+ */
+
+#include "bench.hpp"
+#include "trace.hpp"
+
+#ifdef FT_STL
+  #include <map>
+  #include <set>
+  #include <vector>
+  namespace lib = std;
+  #define BENCH_IMPL "std"
+#else
+  #include "map.hpp"
+  #include "set.hpp"
+  #include "vector.hpp"
+  namespace lib = ft;
+  #define BENCH_IMPL "ft"
+#endif
+
+namespace {
+
+typedef long long                     key_type;
+typedef std::vector<ft::trace_record> record_list;
+typedef lib::map<key_type, key_type>  map_type;
+typedef lib::set<key_type>            set_type;
+typedef lib::vector<key_type>         vector_type;
+
+const char* op_name(int op) {
+  static const char* names[ft::trace_num_ops] = {
+    "?",      "insert",    "find",     "count", "erase", "subscript",
+    "assign", "push_back", "pop_back", "at",    "clear",
+  };
+  return op > 0 && op < ft::trace_num_ops ? names[op] : "?";
+}
+
+struct replay_stats {
+  size_t divergences;
+  size_t first_divergence; // record index, valid when divergences != 0
+  size_t final_size;
+};
+
+inline void check(replay_stats& st, size_t i, unsigned long long expected,
+                  unsigned long long observed) {
+  if (expected != observed && st.divergences++ == 0)
+    st.first_divergence = i;
+}
+
+void replay_map(const record_list& rs, replay_stats& st) {
+  map_type m;
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const ft::trace_record& r = rs[i];
+    unsigned long long      got = 0;
+    switch (r.op) {
+    case ft::trace_insert:
+      got = m.insert(lib::make_pair(r.key, r.value)).second;
+      break;
+    case ft::trace_find: {
+      map_type::iterator it = m.find(r.key);
+      got = it == m.end() ? 0 : 1 + ft::trace_zigzag(it->second);
+      break;
+    }
+    case ft::trace_count:
+      got = m.count(r.key);
+      break;
+    case ft::trace_erase:
+      got = m.erase(r.key);
+      break;
+    case ft::trace_subscript: {
+      size_t before = m.size();
+      m[r.key];
+      got = m.size() == before;
+      break;
+    }
+    case ft::trace_assign: {
+      size_t before = m.size();
+      m[r.key] = r.value;
+      got = m.size() == before;
+      break;
+    }
+    case ft::trace_clear:
+      m.clear();
+      break;
+    default:
+      got = ~r.result; // not a map operation
+    }
+    check(st, i, r.result, got);
+  }
+  st.final_size = m.size();
+}
+
+void replay_set(const record_list& rs, replay_stats& st) {
+  set_type s;
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const ft::trace_record& r = rs[i];
+    unsigned long long      got = 0;
+    switch (r.op) {
+    case ft::trace_insert:
+      got = s.insert(r.key).second;
+      break;
+    case ft::trace_find:
+      got = s.find(r.key) != s.end();
+      break;
+    case ft::trace_count:
+      got = s.count(r.key);
+      break;
+    case ft::trace_erase:
+      got = s.erase(r.key);
+      break;
+    case ft::trace_clear:
+      s.clear();
+      break;
+    default:
+      got = ~r.result;
+    }
+    check(st, i, r.result, got);
+  }
+  st.final_size = s.size();
+}
+
+void replay_vector(const record_list& rs, replay_stats& st) {
+  vector_type v;
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const ft::trace_record& r = rs[i];
+    unsigned long long      got = 0;
+    size_t                  idx = static_cast<size_t>(r.key);
+    switch (r.op) {
+    case ft::trace_push_back:
+      v.push_back(r.value);
+      got = v.size();
+      break;
+    case ft::trace_pop_back:
+      if (v.empty()) {
+        got = ~r.result;
+        break;
+      }
+      v.pop_back();
+      got = v.size();
+      break;
+    case ft::trace_at:
+      got = idx < v.size() ? ft::trace_zigzag(v[idx]) : ~r.result;
+      break;
+    case ft::trace_assign:
+      if (idx < v.size())
+        v[idx] = r.value;
+      else
+        got = ~r.result;
+      break;
+    case ft::trace_clear:
+      v.clear();
+      break;
+    default:
+      got = ~r.result;
+    }
+    check(st, i, r.result, got);
+  }
+  st.final_size = v.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " trace_file" << std::endl;
+    return 1;
+  }
+
+  record_list    records;
+  ft::trace_kind kind;
+  try {
+    ft::trace_reader in(argv[1]);
+    ft::trace_record r;
+    kind = in.kind();
+    while (in.next(r))
+      records.push_back(r);
+  } catch (const std::exception& e) {
+    std::cerr << argv[0] << ": " << e.what() << std::endl;
+    return 1;
+  }
+
+  replay_stats st = { 0, 0, 0 };
+  double       t0 = bench::now_ns();
+  if (kind == ft::trace_map)
+    replay_map(records, st);
+  else if (kind == ft::trace_set)
+    replay_set(records, st);
+  else
+    replay_vector(records, st);
+  double elapsed = bench::now_ns() - t0;
+
+  static const char* kinds[] = { "", "map", "set", "vector" };
+  double ns_per_op = records.empty() ? 0 : elapsed / records.size();
+  std::cout << BENCH_IMPL << " " << kinds[kind] << ": " << records.size()
+            << " ops in " << elapsed / 1e6 << " ms, " << ns_per_op
+            << " ns/op, " << (ns_per_op > 0 ? 1e3 / ns_per_op : 0)
+            << " Mops/s, final size " << st.final_size << std::endl;
+  if (st.divergences == 0) {
+    std::cout << "no divergence" << std::endl;
+    return 0;
+  }
+  const ft::trace_record& r = records[st.first_divergence];
+  std::cout << st.divergences << " divergences, first at op "
+            << st.first_divergence << " (" << op_name(r.op) << " key "
+            << r.key << ", recorded result " << r.result << ")" << std::endl;
+  return 2;
+}
@@ -0,0 +1,300 @@
+/*
+ * Memory footprint and time scaling, a parameterised version of the
+ * test_subject workload in main.cpp: for every container, element size and
+ * element count it fills the container, touches random elements and reports
+ * wall time and resident set size per element. Each point runs in a forked
+ * child so that the RSS of one point is not inflated by memory the
+ * allocator kept from the previous one. Built against ft (scaling_ft) and,
+ * with FT_STL, against std (scaling_std); the csv of both concatenates into
+ * one plot-ready table.
+ */
+
+#include <algorithm>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bench.hpp"
+#include "large_page_allocator.hpp"
+
+#ifdef FT_STL
+  #include <map>
+  #include <stack>
+  #include <vector>
+  namespace lib = std;
+  #define BENCH_IMPL "std"
+#else
+  #include "map.hpp"
+  #include "stack.hpp"
+  #include "vector.hpp"
+  namespace lib = ft;
+  #define BENCH_IMPL "ft"
+#endif
+
+namespace {
+
+// Buffer from the subject test, with a configurable size
+template <size_t N>
+struct payload {
+  int  idx;
+  char buff[N - sizeof(int)];
+};
+
+template <>
+struct payload<sizeof(int)> {
+  int idx;
+};
+
+const size_t elem_sizes[] = { 4, 16, 64, 256, 1024, 4096 };
+
+struct config {
+  std::vector<std::string> containers;
+  std::vector<size_t>      counts;
+  std::vector<size_t>      sizes;
+  unsigned long long       max_ram;
+
+  config() : max_ram(4294967296ULL) { // MAX_RAM of the subject test
+    containers.push_back("vector");
+    containers.push_back("map");
+    containers.push_back("stack");
+    for (size_t n = 1000; n <= 1000000; n *= 10)
+      counts.push_back(n);
+    sizes.push_back(4);
+    sizes.push_back(64);
+    sizes.push_back(4096);
+  }
+};
+
+struct point {
+  double build_ns;
+  double access_ns;
+  double rss_bytes;      // growth of the resident set with the container full
+  double peak_rss_bytes; // high-water mark growth, e.g. during reallocation
+};
+
+size_t resident_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t        total = 0;
+  size_t        resident = 0;
+  statm >> total >> resident;
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+size_t peak_resident_bytes() {
+  std::ifstream status("/proc/self/status");
+  std::string   line;
+  while (std::getline(status, line))
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::strtoul(line.c_str() + 6, 0, 10) * 1024;
+  return 0;
+}
+
+template <size_t N, typename Alloc>
+void run_vector(size_t count, point& p, unsigned long& sink) {
+  bench::rng                      r(count);
+  size_t                          rss0 = resident_bytes();
+  double                          t0 = bench::now_ns();
+  lib::vector<payload<N>, Alloc > v;
+  for (size_t i = 0; i < count; ++i)
+    v.push_back(payload<N>());
+  double t1 = bench::now_ns();
+  for (size_t i = 0; i < count; ++i)
+    v[r.next() % count].idx = 5;
+  double t2 = bench::now_ns();
+  p.rss_bytes = double(resident_bytes()) - rss0;
+  p.build_ns = t1 - t0;
+  p.access_ns = t2 - t1;
+  sink += v[count / 2].idx;
+}
+
+template <size_t N>
+void run_map(size_t count, point& p, unsigned long& sink) {
+  bench::rng       r(count);
+  std::vector<int> keys(count);
+  for (size_t i = 0; i < count; ++i)
+    keys[i] = r.next_int();
+  size_t                     rss0 = resident_bytes();
+  double                     t0 = bench::now_ns();
+  lib::map<int, payload<N> > m;
+  for (size_t i = 0; i < count; ++i)
+    m.insert(lib::make_pair(keys[i], payload<N>()));
+  double t1 = bench::now_ns();
+  for (size_t i = 0; i < count; ++i)
+    sink += m.count(keys[r.next() % count]);
+  double t2 = bench::now_ns();
+  p.rss_bytes = double(resident_bytes()) - rss0;
+  p.build_ns = t1 - t0;
+  p.access_ns = t2 - t1;
+}
+
+template <size_t N>
+void run_stack(size_t count, point& p, unsigned long& sink) {
+  size_t                  rss0 = resident_bytes();
+  double                  t0 = bench::now_ns();
+  lib::stack<payload<N> > s;
+  for (size_t i = 0; i < count; ++i)
+    s.push(payload<N>());
+  double t1 = bench::now_ns();
+  // measure RSS at the full size, then drain it as the access pass
+  p.rss_bytes = double(resident_bytes()) - rss0;
+  double t2 = bench::now_ns();
+  while (!s.empty()) {
+    sink += s.top().idx;
+    s.pop();
+  }
+  double t3 = bench::now_ns();
+  p.build_ns = t1 - t0;
+  p.access_ns = t3 - t2;
+}
+
+template <size_t N>
+void run_point(const std::string& container, size_t count, point& p,
+               unsigned long& sink) {
+  if (container == "vector")
+    run_vector<N, std::allocator<payload<N> > >(count, p, sink);
+  else if (container == "vector_large_page")
+    run_vector<N, ft::large_page_allocator<payload<N> > >(count, p, sink);
+  else if (container == "map")
+    run_map<N>(count, p, sink);
+  else
+    run_stack<N>(count, p, sink);
+}
+
+void dispatch(const std::string& container, size_t size, size_t count,
+              point& p, unsigned long& sink) {
+  switch (size) {
+  case 4:
+    return run_point<4>(container, count, p, sink);
+  case 16:
+    return run_point<16>(container, count, p, sink);
+  case 64:
+    return run_point<64>(container, count, p, sink);
+  case 256:
+    return run_point<256>(container, count, p, sink);
+  case 1024:
+    return run_point<1024>(container, count, p, sink);
+  default:
+    return run_point<4096>(container, count, p, sink);
+  }
+}
+
+/**
+ * @brief Runs one point in a child process and reads its result back
+ * through a pipe.
+ * @return false when the child failed, e.g. was killed for lack of memory
+ */
+bool measure(const std::string& container, size_t size, size_t count,
+             point& p) {
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    unsigned long sink = 0;
+    point         child;
+    size_t        rss0 = resident_bytes();
+    dispatch(container, size, count, child, sink);
+    child.peak_rss_bytes = double(peak_resident_bytes()) - rss0;
+    ssize_t n = write(fds[1], &child, sizeof(child));
+    _exit(n == sizeof(child) && sink != 1 ? 0 : 1);
+  }
+  close(fds[1]);
+  ssize_t n = read(fds[0], &p, sizeof(p));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return n == sizeof(p) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+std::vector<std::string> split(const std::string& s) {
+  std::vector<std::string> out;
+  std::stringstream        ss(s);
+  std::string              item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty())
+      out.push_back(item);
+  return out;
+}
+
+bool parse_args(int argc, char** argv, config& cfg) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a.compare(0, 13, "--containers=") == 0)
+      cfg.containers = split(a.substr(13));
+    else if (a.compare(0, 9, "--counts=") == 0)
+      cfg.counts = bench::parse_sizes(a.substr(9));
+    else if (a.compare(0, 8, "--sizes=") == 0)
+      cfg.sizes = bench::parse_sizes(a.substr(8));
+    else if (a.compare(0, 10, "--max-ram=") == 0)
+      cfg.max_ram = std::strtoull(a.substr(10).c_str(), 0, 10);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--containers=vector,vector_large_page,map,stack]"
+                   " [--counts=a,b,..]"
+                   " [--sizes=4,16,64,256,1024,4096] [--max-ram=bytes]"
+                << std::endl;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < cfg.containers.size(); ++i)
+    if (cfg.containers[i] != "vector" &&
+        cfg.containers[i] != "vector_large_page" &&
+        cfg.containers[i] != "map" && cfg.containers[i] != "stack") {
+      std::cerr << argv[0] << ": unknown container " << cfg.containers[i]
+                << std::endl;
+      return false;
+    }
+  for (size_t i = 0; i < cfg.sizes.size(); ++i) {
+    const size_t* end = elem_sizes + sizeof(elem_sizes) / sizeof(size_t);
+    if (std::find(elem_sizes, end, cfg.sizes[i]) == end) {
+      std::cerr << argv[0] << ": element size " << cfg.sizes[i]
+                << " not one of 4,16,64,256,1024,4096" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  config cfg;
+  if (!parse_args(argc, argv, cfg))
+    return 1;
+
+  std::cout << "impl,container,elem_bytes,count,build_ns_per_elem,"
+               "access_ns_per_elem,rss_bytes,rss_bytes_per_elem,"
+               "overhead_bytes_per_elem,peak_rss_bytes\n";
+  for (size_t c = 0; c < cfg.containers.size(); ++c)
+    for (size_t s = 0; s < cfg.sizes.size(); ++s)
+      for (size_t k = 0; k < cfg.counts.size(); ++k) {
+        const std::string& container = cfg.containers[c];
+        size_t             size = cfg.sizes[s];
+        size_t             count = cfg.counts[k];
+        // vector growth can hold up to three times the payload at once
+        if (count == 0 || 3.0 * count * size > double(cfg.max_ram)) {
+          std::cerr << "skip " << container << " " << size << "x" << count
+                    << ": over --max-ram" << std::endl;
+          continue;
+        }
+        point p;
+        if (!measure(container, size, count, p)) {
+          std::cerr << "failed " << container << " " << size << "x" << count
+                    << std::endl;
+          continue;
+        }
+        char buf[256];
+        snprintf(buf, sizeof(buf),
+                 "%s,%s,%lu,%lu,%.2f,%.2f,%.0f,%.2f,%.2f,%.0f\n", BENCH_IMPL,
+                 container.c_str(), (unsigned long)size, (unsigned long)count,
+                 p.build_ns / count, p.access_ns / count, p.rss_bytes,
+                 p.rss_bytes / count, p.rss_bytes / count - size,
+                 p.peak_rss_bytes);
+        std::cout << buf << std::flush;
+      }
+  return 0;
+}
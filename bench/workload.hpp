@@ -0,0 +1,98 @@
+#ifndef __WORKLOAD_HPP__
+#define __WORKLOAD_HPP__
+
+/*
+ * Key streams for the load generator. All of them are deterministic for a
+ * given seed, so the ft and std builds see exactly the same operations.
+ */
+
+#include <cmath>
+#include <string>
+#include "bench.hpp"
+
+namespace bench {
+
+/**
+ * @brief Draws keys in [0, n) uniformly, sequentially (wrapping around) or
+ * from a Zipfian distribution where key 0 is the most popular. The Zipfian
+ * sampler is the constant time one of Gray et al., "Quickly Generating
+ * Billion-Record Synthetic Databases", also used by YCSB; its setup is
+ * linear in n and theta must lie in (0, 1).
+ */
+class key_generator {
+public:
+  enum distribution { uniform, zipf, sequential };
+
+  key_generator(distribution d, size_t n, double theta = 0.99,
+                unsigned long long seed = 42)
+  : _dist(d), _n(n ? n : 1), _next(0), _rng(seed), _theta(theta), _zetan(0),
+    _alpha(0), _eta(0) {
+    if (_dist == zipf) {
+      double zeta2 = _zeta(2);
+      _zetan = _zeta(_n);
+      _alpha = 1.0 / (1.0 - _theta);
+      _eta = (1.0 - std::pow(2.0 / _n, 1.0 - _theta)) /
+             (1.0 - zeta2 / _zetan);
+    }
+  }
+
+  static bool parse(const std::string& s, distribution& d) {
+    if (s == "uniform")
+      d = uniform;
+    else if (s == "zipf")
+      d = zipf;
+    else if (s == "sequential")
+      d = sequential;
+    else
+      return false;
+    return true;
+  }
+
+  size_t next() {
+    switch (_dist) {
+    case sequential:
+      return _next++ % _n;
+    case zipf: {
+      double u = uniform_real();
+      double uz = u * _zetan;
+      if (uz < 1.0)
+        return 0;
+      if (uz < 1.0 + std::pow(0.5, _theta))
+        return _n > 1 ? 1 : 0;
+      size_t k = static_cast<size_t>(
+          _n * std::pow(_eta * u - _eta + 1.0, _alpha));
+      return k < _n ? k : _n - 1;
+    }
+    default:
+      return static_cast<size_t>(_rng.next() % _n);
+    }
+  }
+
+  /**
+   * @brief Uniform double in [0, 1), also used to pick operation types.
+   */
+  double uniform_real() {
+    return (_rng.next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  distribution _dist;
+  size_t       _n;
+  size_t       _next;
+  rng          _rng;
+  double       _theta;
+  double       _zetan;
+  double       _alpha;
+  double       _eta;
+
+  double _zeta(size_t n) const {
+    double sum = 0;
+    for (size_t i = 1; i <= n; ++i)
+      sum += 1.0 / std::pow(static_cast<double>(i), _theta);
+    return sum;
+  }
+};
+
+} /* namespace bench */
+
+#endif /* __WORKLOAD_HPP__ */
@@ -1,6 +1,12 @@
 #ifndef __ALGOBASE_HPP__
 #define __ALGOBASE_HPP__
 
+#include <cstddef>
+#include <cstring>
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "vector_iterator.hpp"
+
 namespace ft {
 
 /**
@@ -47,6 +53,208 @@ bool lexicographical_compare(InputIterator1 first1,
   return first1 == last1 && first2 != last2;
 }
 
+/**
+ * @brief Returns the first iterator in [first, last) whose element equals
+ * value, or last.
+ */
+template <typename InputIterator, typename T>
+inline InputIterator find(InputIterator first, InputIterator last,
+                          const T& value) {
+  while (first != last && !(*first == value))
+    ++first;
+  return first;
+}
+
+/**
+ * @brief Counts the elements of [first, last) equal to value.
+ */
+template <typename InputIterator, typename T>
+inline typename iterator_traits<InputIterator>::difference_type
+count(InputIterator first, InputIterator last, const T& value) {
+  typename iterator_traits<InputIterator>::difference_type n = 0;
+  for (; first != last; ++first)
+    if (*first == value)
+      ++n;
+  return n;
+}
+
+//!@{ Contiguous ranges ////////////////////////////////////////////////////////
+
+/*
+ * Overloads for pointer ranges, which vector_iterator ranges unwrap to.
+ * When both sides hold the same integral type, equal is a memcmp,
+ * lexicographical_compare a memcmp for unsigned bytes or a vectorized
+ * search for the first mismatch otherwise, and find and count vectorized
+ * scans (see simd.hpp). Everything else takes the element-wise loops.
+ */
+
+template <typename T1, typename T2>
+struct _same_element {
+  static const bool value = false;
+  typedef void      type;
+};
+
+template <typename T>
+struct _same_element<T, T> {
+  static const bool value = true;
+  typedef T         type;
+};
+
+template <typename T>
+struct _same_element<const T, T> : _same_element<T, T> {};
+
+template <typename T>
+struct _same_element<T, const T> : _same_element<T, T> {};
+
+template <typename T>
+struct _same_element<const T, const T> : _same_element<T, T> {};
+
+template <typename T1, typename T2>
+struct _contiguous {
+  static const bool value =
+      simd_traits<typename _same_element<T1, T2>::type>::value;
+};
+
+template <bool Simd>
+struct _algobase_dispatch {
+  template <typename T1, typename T2>
+  static bool equal(T1* first1, T1* last1, T2* first2) {
+    for (; first1 != last1; ++first1, ++first2)
+      if (!(*first1 == *first2))
+        return false;
+    return true;
+  }
+
+  template <typename T1, typename T2>
+  static bool lexicographical_compare(T1* first1, T1* last1, T2* first2,
+                                      T2* last2) {
+    for (; first1 != last1 && first2 != last2; ++first1, ++first2) {
+      if (*first1 < *first2)
+        return true;
+      if (*first2 < *first1)
+        return false;
+    }
+    return first1 == last1 && first2 != last2;
+  }
+
+  template <typename T, typename V>
+  static size_t find(T* first, T* last, const V& value) {
+    size_t i = 0;
+    for (; first + i != last && !(first[i] == value); ++i) { }
+    return i;
+  }
+
+  template <typename T, typename V>
+  static ptrdiff_t count(T* first, T* last, const V& value) {
+    ptrdiff_t n = 0;
+    for (; first != last; ++first)
+      if (*first == value)
+        ++n;
+    return n;
+  }
+};
+
+template <>
+struct _algobase_dispatch<true> {
+  template <typename T1, typename T2>
+  static bool equal(T1* first1, T1* last1, T2* first2) {
+    size_t n = last1 - first1;
+    return n == 0 || std::memcmp(first1, first2, n * sizeof(T1)) == 0;
+  }
+
+  template <typename T1, typename T2>
+  static bool lexicographical_compare(T1* first1, T1* last1, T2* first2,
+                                      T2* last2) {
+    typedef typename _same_element<T1, T2>::type T;
+
+    size_t n1 = last1 - first1;
+    size_t n2 = last2 - first2;
+    size_t n = n1 < n2 ? n1 : n2;
+    if (n != 0) {
+      if (simd_traits<T>::memcmp_order) {
+        int c = std::memcmp(first1, first2, n);
+        if (c != 0)
+          return c < 0;
+      } else {
+        size_t i = simd_mismatch(first1, first2, n * sizeof(T)) / sizeof(T);
+        if (i < n)
+          return first1[i] < first2[i];
+      }
+    }
+    return n1 < n2;
+  }
+
+  template <typename T, typename V>
+  static size_t find(T* first, T* last, const V& value) {
+    typedef typename simd_traits<V>::type U;
+    return simd_find(reinterpret_cast<const U*>(first), size_t(last - first),
+                     U(value));
+  }
+
+  template <typename T, typename V>
+  static ptrdiff_t count(T* first, T* last, const V& value) {
+    typedef typename simd_traits<V>::type U;
+    return simd_count(reinterpret_cast<const U*>(first), size_t(last - first),
+                      U(value));
+  }
+};
+
+template <typename T1, typename T2>
+inline bool equal(T1* first1, T1* last1, T2* first2) {
+  return _algobase_dispatch<_contiguous<T1, T2>::value>::equal(first1, last1,
+                                                               first2);
+}
+
+template <typename Iterator1, typename Iterator2>
+inline bool equal(vector_iterator<Iterator1> first1,
+                  vector_iterator<Iterator1> last1,
+                  vector_iterator<Iterator2> first2) {
+  return ft::equal(first1.base(), last1.base(), first2.base());
+}
+
+template <typename T1, typename T2>
+inline bool lexicographical_compare(T1* first1, T1* last1, T2* first2,
+                                    T2* last2) {
+  return _algobase_dispatch<_contiguous<T1, T2>::value>::
+      lexicographical_compare(first1, last1, first2, last2);
+}
+
+template <typename Iterator1, typename Iterator2>
+inline bool lexicographical_compare(vector_iterator<Iterator1> first1,
+                                    vector_iterator<Iterator1> last1,
+                                    vector_iterator<Iterator2> first2,
+                                    vector_iterator<Iterator2> last2) {
+  return ft::lexicographical_compare(first1.base(), last1.base(),
+                                     first2.base(), last2.base());
+}
+
+template <typename T, typename V>
+inline T* find(T* first, T* last, const V& value) {
+  return first +
+         _algobase_dispatch<_contiguous<T, V>::value>::find(first, last, value);
+}
+
+template <typename Iterator, typename V>
+inline vector_iterator<Iterator> find(vector_iterator<Iterator> first,
+                                      vector_iterator<Iterator> last,
+                                      const V& value) {
+  return vector_iterator<Iterator>(ft::find(first.base(), last.base(), value));
+}
+
+template <typename T, typename V>
+inline ptrdiff_t count(T* first, T* last, const V& value) {
+  return _algobase_dispatch<_contiguous<T, V>::value>::count(first, last,
+                                                             value);
+}
+
+template <typename Iterator, typename V>
+inline ptrdiff_t count(vector_iterator<Iterator> first,
+                       vector_iterator<Iterator> last, const V& value) {
+  return ft::count(first.base(), last.base(), value);
+}
+
+//!@}
+
 } /* namespace ft */
 
 #endif /* __ALGOBASE_HPP__ */
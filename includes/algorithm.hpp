@@ -0,0 +1,615 @@
+#ifndef __ALGORITHM_HPP__
+#define __ALGORITHM_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include "algobase.hpp"
+#include "iterator.hpp"
+#include "vector_iterator.hpp"
+
+namespace ft {
+
+//!@{ Sorting Internals ////////////////////////////////////////////////////////
+
+/*
+ * sort is an introsort: quicksort with a median-of-three pivot that falls
+ * back to heapsort past 2 log2(n) levels, leaving ranges of sort_threshold
+ * elements or fewer to insertion sort. Ranges of integers compared with the
+ * default operator< go to an LSD radix sort instead, which is also stable
+ * and so serves stable_sort too. Every entry point taking vector_iterators
+ * unwraps them to the underlying pointers, so the radix path applies to
+ * ft::vector<int> and the loops run on raw pointers.
+ */
+
+// Ranges of at most this many elements are finished by insertion sort
+const ptrdiff_t sort_threshold = 16;
+
+// Below this size the counting passes of radix sort cost more than they save
+const ptrdiff_t radix_threshold = 256;
+
+inline ptrdiff_t _sort_depth_limit(ptrdiff_t n) {
+  ptrdiff_t k = 0;
+  for (; n > 1; n >>= 1)
+    ++k;
+  return 2 * k;
+}
+
+template <typename RandomIt, typename Compare>
+void _insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+
+  if (first == last)
+    return;
+  for (RandomIt i = first + 1; i != last; ++i) {
+    value_type v = *i;
+    RandomIt   hole = i;
+    if (comp(v, *first)) {
+      for (; hole != first; --hole)
+        *hole = *(hole - 1);
+    } else {
+      // *first is not greater than v, so the scan stops before it
+      for (RandomIt prev = hole - 1; comp(v, *prev); --prev, --hole)
+        *hole = *prev;
+    }
+    *hole = v;
+  }
+}
+
+/**
+ * @brief Sifts v down from hole in the max-heap [first, first + len).
+ */
+template <typename RandomIt, typename Distance, typename T, typename Compare>
+void _adjust_heap(RandomIt first, Distance hole, Distance len, T v,
+                  Compare comp) {
+  const Distance top = hole;
+  Distance       child = 2 * hole + 2;
+  while (child < len) {
+    if (comp(first[child], first[child - 1]))
+      --child;
+    first[hole] = first[child];
+    hole = child;
+    child = 2 * child + 2;
+  }
+  if (child == len) {
+    first[hole] = first[child - 1];
+    hole = child - 1;
+  }
+  Distance parent = (hole - 1) / 2;
+  while (hole > top && comp(first[parent], v)) {
+    first[hole] = first[parent];
+    hole = parent;
+    parent = (hole - 1) / 2;
+  }
+  first[hole] = v;
+}
+
+template <typename RandomIt, typename Compare>
+void _make_heap(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename iterator_traits<RandomIt>::difference_type Distance;
+
+  Distance len = last - first;
+  if (len < 2)
+    return;
+  for (Distance parent = (len - 2) / 2;; --parent) {
+    _adjust_heap(first, parent, len, first[parent], comp);
+    if (parent == 0)
+      return;
+  }
+}
+
+/**
+ * @brief Moves the heap top to *result and sifts the old *result into the
+ * heap [first, last).
+ */
+template <typename RandomIt, typename Compare>
+inline void _pop_heap(RandomIt first, RandomIt last, RandomIt result,
+                      Compare comp) {
+  typedef typename iterator_traits<RandomIt>::value_type      value_type;
+  typedef typename iterator_traits<RandomIt>::difference_type Distance;
+
+  value_type v = *result;
+  *result = *first;
+  _adjust_heap(first, Distance(0), Distance(last - first), v, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void _sort_heap(RandomIt first, RandomIt last, Compare comp) {
+  while (last - first > 1) {
+    --last;
+    _pop_heap(first, last, last, comp);
+  }
+}
+
+/**
+ * @brief Leaves the middle - first smallest elements of [first, last) in a
+ * max-heap at [first, middle).
+ */
+template <typename RandomIt, typename Compare>
+void _heap_select(RandomIt first, RandomIt middle, RandomIt last,
+                  Compare comp) {
+  _make_heap(first, middle, comp);
+  for (RandomIt i = middle; i < last; ++i)
+    if (comp(*i, *first))
+      _pop_heap(first, middle, i, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void _move_median_to_first(RandomIt result, RandomIt a, RandomIt b,
+                           RandomIt c, Compare comp) {
+  if (comp(*a, *b)) {
+    if (comp(*b, *c))
+      ft::swap(*result, *b);
+    else if (comp(*a, *c))
+      ft::swap(*result, *c);
+    else
+      ft::swap(*result, *a);
+  } else if (comp(*a, *c))
+    ft::swap(*result, *a);
+  else if (comp(*b, *c))
+    ft::swap(*result, *c);
+  else
+    ft::swap(*result, *b);
+}
+
+/**
+ * @brief Hoare partition of [first, last) around *first, chosen as the
+ * median of the first, middle and last elements. The median guards both
+ * scans, so neither needs a bounds check.
+ * @return start of the right part
+ */
+template <typename RandomIt, typename Compare>
+RandomIt _partition_pivot(RandomIt first, RandomIt last, Compare comp) {
+  RandomIt mid = first + (last - first) / 2;
+  _move_median_to_first(first, first + 1, mid, last - 1, comp);
+  RandomIt lo = first + 1;
+  RandomIt hi = last;
+  for (;;) {
+    while (comp(*lo, *first))
+      ++lo;
+    --hi;
+    while (comp(*first, *hi))
+      --hi;
+    if (!(lo < hi))
+      return lo;
+    ft::swap(*lo, *hi);
+    ++lo;
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void _introsort_loop(RandomIt first, RandomIt last, ptrdiff_t depth,
+                     Compare comp) {
+  while (last - first > sort_threshold) {
+    if (depth == 0) {
+      _heap_select(first, last, last, comp);
+      _sort_heap(first, last, comp);
+      return;
+    }
+    --depth;
+    RandomIt cut = _partition_pivot(first, last, comp);
+    _introsort_loop(cut, last, depth, comp);
+    last = cut;
+  }
+}
+
+template <typename RandomIt, typename Compare>
+inline void _introsort(RandomIt first, RandomIt last, Compare comp) {
+  if (last - first < 2)
+    return;
+  _introsort_loop(first, last, _sort_depth_limit(last - first), comp);
+  _insertion_sort(first, last, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void _introselect(RandomIt first, RandomIt nth, RandomIt last,
+                  Compare comp) {
+  ptrdiff_t depth = _sort_depth_limit(last - first);
+  while (last - first > 3) {
+    if (depth == 0) {
+      _heap_select(first, nth + 1, last, comp);
+      ft::swap(*first, *nth);
+      return;
+    }
+    --depth;
+    RandomIt cut = _partition_pivot(first, last, comp);
+    if (cut <= nth)
+      first = cut;
+    else
+      last = cut;
+  }
+  _insertion_sort(first, last, comp);
+}
+
+/**
+ * @brief Scratch space of up to n copies of seed for stable_sort, released
+ * (and its elements destroyed) on scope exit. May come back smaller than
+ * asked for, or empty, when memory is short.
+ */
+template <typename T>
+class _temporary_buffer {
+public:
+  _temporary_buffer(ptrdiff_t n, const T& seed) : _buf(0), _len(0) {
+    std::pair<T*, ptrdiff_t> p = std::get_temporary_buffer<T>(n);
+    if (p.first == 0)
+      return;
+    try {
+      std::uninitialized_fill(p.first, p.first + p.second, seed);
+    } catch (...) {
+      std::return_temporary_buffer(p.first);
+      throw;
+    }
+    _buf = p.first;
+    _len = p.second;
+  }
+
+  ~_temporary_buffer() {
+    for (ptrdiff_t i = 0; i < _len; ++i)
+      _buf[i].~T();
+    std::return_temporary_buffer(_buf);
+  }
+
+  T*        begin() const { return _buf; }
+  ptrdiff_t size() const { return _len; }
+
+private:
+  T*        _buf;
+  ptrdiff_t _len;
+
+  _temporary_buffer(const _temporary_buffer&);
+  _temporary_buffer& operator=(const _temporary_buffer&);
+};
+
+template <typename RandomIt, typename T, typename Compare>
+void _merge_sort_with_buffer(RandomIt first, RandomIt last, T* buf,
+                             Compare comp) {
+  if (last - first <= sort_threshold) {
+    _insertion_sort(first, last, comp);
+    return;
+  }
+  RandomIt mid = first + (last - first) / 2;
+  _merge_sort_with_buffer(first, mid, buf, comp);
+  _merge_sort_with_buffer(mid, last, buf, comp);
+  if (!comp(*mid, *(mid - 1)))
+    return; // halves already in order
+
+  T*       left = buf;
+  T*       left_end = std::copy(first, mid, buf);
+  RandomIt right = mid;
+  RandomIt out = first;
+  while (left != left_end && right != last) {
+    if (comp(*right, *left))
+      *out++ = *right++;
+    else
+      *out++ = *left++;
+  }
+  std::copy(left, left_end, out);
+}
+
+template <typename RandomIt, typename Distance, typename Compare>
+void _merge_without_buffer(RandomIt first, RandomIt middle, RandomIt last,
+                           Distance len1, Distance len2, Compare comp) {
+  if (len1 == 0 || len2 == 0)
+    return;
+  if (len1 + len2 == 2) {
+    if (comp(*middle, *first))
+      ft::swap(*first, *middle);
+    return;
+  }
+  RandomIt first_cut;
+  RandomIt second_cut;
+  Distance len11;
+  Distance len22;
+  if (len1 > len2) {
+    len11 = len1 / 2;
+    first_cut = first + len11;
+    second_cut = std::lower_bound(middle, last, *first_cut, comp);
+    len22 = second_cut - middle;
+  } else {
+    len22 = len2 / 2;
+    second_cut = middle + len22;
+    first_cut = std::upper_bound(first, middle, *second_cut, comp);
+    len11 = first_cut - first;
+  }
+  std::rotate(first_cut, middle, second_cut);
+  RandomIt new_middle = first_cut + len22;
+  _merge_without_buffer(first, first_cut, new_middle, len11, len22, comp);
+  _merge_without_buffer(new_middle, second_cut, last, len1 - len11,
+                        len2 - len22, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void _inplace_stable_sort(RandomIt first, RandomIt last, Compare comp) {
+  if (last - first <= sort_threshold) {
+    _insertion_sort(first, last, comp);
+    return;
+  }
+  RandomIt mid = first + (last - first) / 2;
+  _inplace_stable_sort(first, mid, comp);
+  _inplace_stable_sort(mid, last, comp);
+  _merge_without_buffer(first, mid, last, mid - first, last - mid, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void _stable_sort(RandomIt first, RandomIt last, Compare comp) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+
+  ptrdiff_t n = last - first;
+  if (n <= sort_threshold) {
+    _insertion_sort(first, last, comp);
+    return;
+  }
+  _temporary_buffer<value_type> buf((n + 1) / 2, *first);
+  if (buf.size() >= (n + 1) / 2)
+    _merge_sort_with_buffer(first, last, buf.begin(), comp);
+  else
+    _inplace_stable_sort(first, last, comp);
+}
+
+//!@}
+
+//!@{ Radix Sort ///////////////////////////////////////////////////////////////
+
+/**
+ * @brief Maps an integral type onto an unsigned key of the same size whose
+ * unsigned order is the order of the values: signed types get their sign
+ * bit flipped.
+ */
+template <typename T>
+struct radix_traits {
+  static const bool value = false;
+};
+
+#define FT_RADIX_TRAITS(T, U, SIGNED)                                          \
+  template <>                                                                  \
+  struct radix_traits<T> {                                                     \
+    static const bool value = true;                                            \
+    typedef U         key_type;                                                \
+    static key_type   key(T v) {                                               \
+      const key_type sign = key_type(1) << (sizeof(key_type) * 8 - 1);         \
+      return key_type(key_type(v) ^ (SIGNED ? sign : key_type(0)));            \
+    }                                                                          \
+  };
+
+FT_RADIX_TRAITS(char, unsigned char, (char(-1) < 0))
+FT_RADIX_TRAITS(signed char, unsigned char, true)
+FT_RADIX_TRAITS(unsigned char, unsigned char, false)
+FT_RADIX_TRAITS(short, unsigned short, true)
+FT_RADIX_TRAITS(unsigned short, unsigned short, false)
+FT_RADIX_TRAITS(int, unsigned int, true)
+FT_RADIX_TRAITS(unsigned int, unsigned int, false)
+FT_RADIX_TRAITS(long, unsigned long, true)
+FT_RADIX_TRAITS(unsigned long, unsigned long, false)
+FT_RADIX_TRAITS(long long, unsigned long long, true)
+FT_RADIX_TRAITS(unsigned long long, unsigned long long, false)
+
+#undef FT_RADIX_TRAITS
+
+/**
+ * @brief LSD radix sort of [first, last) by bytes, ping-ponging with buf,
+ * which holds at least last - first elements. All byte histograms are
+ * counted in a single pass, and a byte that is the same in every key (e.g.
+ * the high bytes of small values) costs no scatter pass.
+ */
+template <typename T>
+void _radix_sort(T* first, T* last, T* buf) {
+  typedef radix_traits<T>           traits;
+  typedef typename traits::key_type key_type;
+
+  const size_t n = last - first;
+  size_t       counts[sizeof(key_type)][256];
+  std::memset(counts, 0, sizeof(counts));
+  for (T* p = first; p != last; ++p) {
+    key_type k = traits::key(*p);
+    for (size_t b = 0; b < sizeof(key_type); ++b)
+      ++counts[b][(k >> (8 * b)) & 0xff];
+  }
+
+  T* src = first;
+  T* dst = buf;
+  for (size_t b = 0; b < sizeof(key_type); ++b) {
+    size_t* count = counts[b];
+    if (count[(traits::key(*first) >> (8 * b)) & 0xff] == n)
+      continue;
+    size_t offset = 0;
+    for (size_t d = 0; d < 256; ++d) {
+      size_t c = count[d];
+      count[d] = offset;
+      offset += c;
+    }
+    for (T* p = src; p != src + n; ++p)
+      dst[count[(traits::key(*p) >> (8 * b)) & 0xff]++] = *p;
+    std::swap(src, dst);
+  }
+  if (src != first)
+    std::memcpy(first, src, n * sizeof(T));
+}
+
+/*
+ * Sorts a pointer range with operator<: radix sort for integers when the
+ * range is large enough and a scratch buffer is available, otherwise the
+ * comparison sort.
+ */
+template <bool Radix>
+struct _sort_dispatch {
+  template <typename T>
+  static void sort(T* first, T* last) {
+    _introsort(first, last, std::less<T>());
+  }
+
+  template <typename T>
+  static void stable_sort(T* first, T* last) {
+    _stable_sort(first, last, std::less<T>());
+  }
+};
+
+template <>
+struct _sort_dispatch<true> {
+  template <typename T>
+  static void sort(T* first, T* last) {
+    if (last - first < radix_threshold || !_try_radix(first, last))
+      _introsort(first, last, std::less<T>());
+  }
+
+  template <typename T>
+  static void stable_sort(T* first, T* last) {
+    if (last - first < radix_threshold || !_try_radix(first, last))
+      _stable_sort(first, last, std::less<T>());
+  }
+
+private:
+  template <typename T>
+  static bool _try_radix(T* first, T* last) {
+    std::pair<T*, ptrdiff_t> buf = std::get_temporary_buffer<T>(last - first);
+    bool                     ok = buf.second >= last - first;
+    if (ok)
+      _radix_sort(first, last, buf.first);
+    std::return_temporary_buffer(buf.first);
+    return ok;
+  }
+};
+
+//!@}
+
+//!@{ Sorting //////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Sorts [first, last) into ascending order. Not stable.
+ * O(n log n) comparisons in the worst case; O(n) for integers of at least
+ * radix_threshold elements.
+ */
+template <typename RandomIt>
+inline void sort(RandomIt first, RandomIt last) {
+  _introsort(first, last,
+             std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename RandomIt, typename Compare>
+inline void sort(RandomIt first, RandomIt last, Compare comp) {
+  _introsort(first, last, comp);
+}
+
+template <typename T>
+inline void sort(T* first, T* last) {
+  _sort_dispatch<radix_traits<T>::value>::sort(first, last);
+}
+
+template <typename Iterator>
+inline void sort(vector_iterator<Iterator> first,
+                 vector_iterator<Iterator> last) {
+  ft::sort(first.base(), last.base());
+}
+
+template <typename Iterator, typename Compare>
+inline void sort(vector_iterator<Iterator> first,
+                 vector_iterator<Iterator> last, Compare comp) {
+  _introsort(first.base(), last.base(), comp);
+}
+
+/**
+ * @brief Sorts [first, last) keeping equivalent elements in their original
+ * order. Merge sort through a buffer of n / 2 elements, or in place in
+ * O(n log^2 n) when that cannot be allocated.
+ */
+template <typename RandomIt>
+inline void stable_sort(RandomIt first, RandomIt last) {
+  _stable_sort(first, last,
+               std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename RandomIt, typename Compare>
+inline void stable_sort(RandomIt first, RandomIt last, Compare comp) {
+  _stable_sort(first, last, comp);
+}
+
+template <typename T>
+inline void stable_sort(T* first, T* last) {
+  _sort_dispatch<radix_traits<T>::value>::stable_sort(first, last);
+}
+
+template <typename Iterator>
+inline void stable_sort(vector_iterator<Iterator> first,
+                        vector_iterator<Iterator> last) {
+  ft::stable_sort(first.base(), last.base());
+}
+
+template <typename Iterator, typename Compare>
+inline void stable_sort(vector_iterator<Iterator> first,
+                        vector_iterator<Iterator> last, Compare comp) {
+  _stable_sort(first.base(), last.base(), comp);
+}
+
+/**
+ * @brief Puts the middle - first smallest elements of [first, last), sorted,
+ * into [first, middle); the rest are left in unspecified order.
+ * O(n log(middle - first)).
+ */
+template <typename RandomIt, typename Compare>
+inline void partial_sort(RandomIt first, RandomIt middle, RandomIt last,
+                         Compare comp) {
+  _heap_select(first, middle, last, comp);
+  _sort_heap(first, middle, comp);
+}
+
+template <typename RandomIt>
+inline void partial_sort(RandomIt first, RandomIt middle, RandomIt last) {
+  ft::partial_sort(
+      first, middle, last,
+      std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename Iterator, typename Compare>
+inline void partial_sort(vector_iterator<Iterator> first,
+                         vector_iterator<Iterator> middle,
+                         vector_iterator<Iterator> last, Compare comp) {
+  ft::partial_sort(first.base(), middle.base(), last.base(), comp);
+}
+
+template <typename Iterator>
+inline void partial_sort(vector_iterator<Iterator> first,
+                         vector_iterator<Iterator> middle,
+                         vector_iterator<Iterator> last) {
+  ft::partial_sort(first.base(), middle.base(), last.base());
+}
+
+/**
+ * @brief Places in *nth the element that would be there if [first, last)
+ * were sorted, with no greater element before it and no smaller one after.
+ * Introselect: O(n) on average, O(n log n) in the worst case.
+ */
+template <typename RandomIt, typename Compare>
+inline void nth_element(RandomIt first, RandomIt nth, RandomIt last,
+                        Compare comp) {
+  if (first == last || nth == last)
+    return;
+  _introselect(first, nth, last, comp);
+}
+
+template <typename RandomIt>
+inline void nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+  ft::nth_element(
+      first, nth, last,
+      std::less<typename iterator_traits<RandomIt>::value_type>());
+}
+
+template <typename Iterator, typename Compare>
+inline void nth_element(vector_iterator<Iterator> first,
+                        vector_iterator<Iterator> nth,
+                        vector_iterator<Iterator> last, Compare comp) {
+  ft::nth_element(first.base(), nth.base(), last.base(), comp);
+}
+
+template <typename Iterator>
+inline void nth_element(vector_iterator<Iterator> first,
+                        vector_iterator<Iterator> nth,
+                        vector_iterator<Iterator> last) {
+  ft::nth_element(first.base(), nth.base(), last.base());
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __ALGORITHM_HPP__ */
@@ -0,0 +1,202 @@
+#ifndef __ARENA_HPP__
+#define __ARENA_HPP__
+
+#include <cstddef>
+#include <new>
+#include "type_traits.hpp"
+
+namespace ft {
+
+//!@{ Monotonic Arena //////////////////////////////////////////////////////////
+
+/**
+ * @brief Bump-pointer arena. Memory handed out is only reclaimed in bulk by
+ * release() or by the destructor; individual deallocation is a no-op.
+ *
+ * Chunks are obtained from operator new and grow geometrically. An optional
+ * caller-supplied buffer (e.g. on the stack) is used before the first chunk.
+ */
+class monotonic_arena {
+  struct chunk {
+    chunk* next;
+    size_t size;
+  };
+
+  static const size_t max_align = 16;
+
+  chunk* _chunks;
+  char*  _cur;
+  char*  _end;
+  char*  _initial_buffer;
+  size_t _initial_size;
+  size_t _next_chunk_size;
+  size_t _bytes_used;
+
+public:
+  explicit monotonic_arena(size_t initial_chunk_size = 4096)
+  : _chunks(0), _cur(0), _end(0), _initial_buffer(0), _initial_size(0),
+    _next_chunk_size(initial_chunk_size < 64 ? 64 : initial_chunk_size),
+    _bytes_used(0) { }
+
+  monotonic_arena(void* buffer, size_t size)
+  : _chunks(0), _cur(static_cast<char*>(buffer)),
+    _end(static_cast<char*>(buffer) + size),
+    _initial_buffer(static_cast<char*>(buffer)), _initial_size(size),
+    _next_chunk_size(size < 64 ? 64 : size), _bytes_used(0) { }
+
+  ~monotonic_arena() { release(); }
+
+  /**
+   * @brief Returns @p bytes of storage aligned to @p align (a power of two,
+   * at most 16). When the current chunk is full, a new one, large enough for
+   * the request, comes from operator new.
+   * @throw std::bad_alloc when that chunk cannot be obtained
+   */
+  void* allocate(size_t bytes, size_t align = max_align) {
+    char* p = _align(_cur, align);
+    if (_cur == 0 || p > _end || size_t(_end - p) < bytes) {
+      if (bytes > size_t(-1) / 4) // the chunk size doubling would overflow
+        throw std::bad_alloc();
+      _grow(bytes + align);
+      p = _align(_cur, align);
+    }
+    _cur = p + bytes;
+    _bytes_used += bytes;
+    return p;
+  }
+
+  /**
+   * @brief Frees every chunk and rewinds to the initial buffer. Objects
+   * living in the arena are not destroyed.
+   */
+  void release() {
+    while (_chunks) {
+      chunk* next = _chunks->next;
+      ::operator delete(_chunks);
+      _chunks = next;
+    }
+    _cur = _initial_buffer;
+    _end = _initial_buffer + _initial_size;
+    _bytes_used = 0;
+  }
+
+  /**
+   * @brief Payload bytes handed out since construction or the last release().
+   */
+  size_t bytes_used() const { return _bytes_used; }
+
+private:
+  monotonic_arena(const monotonic_arena&);
+  monotonic_arena& operator=(const monotonic_arena&);
+
+  static char* _align(char* p, size_t align) {
+    size_t mis = reinterpret_cast<size_t>(p) & (align - 1);
+    return mis ? p + (align - mis) : p;
+  }
+
+  void _grow(size_t min_bytes) {
+    size_t size = _next_chunk_size;
+    while (size < min_bytes + sizeof(chunk))
+      size *= 2;
+    chunk* c = static_cast<chunk*>(::operator new(size));
+    c->next = _chunks;
+    c->size = size;
+    _chunks = c;
+    _cur = reinterpret_cast<char*>(c) + sizeof(chunk);
+    _end = reinterpret_cast<char*>(c) + size;
+    _next_chunk_size = size * 2;
+  }
+};
+
+/**
+ * @brief An arena with an inline buffer of N bytes, released when it goes
+ * out of scope. Meant for containers that live exactly as long as a request:
+ *
+ *     ft::scoped_arena<16384>       arena;
+ *     ft::arena_allocator<int>      alloc(arena);
+ *     ft::vector<int, ft::arena_allocator<int> > v(alloc);
+ *
+ * The containers must be declared after the arena so they are destroyed
+ * first.
+ */
+template <size_t N>
+class scoped_arena : public monotonic_arena {
+  union {
+    char        bytes[N];
+    long double align_;
+  } _buffer;
+
+public:
+  scoped_arena() : monotonic_arena(&_buffer, N) { }
+};
+
+//!@}
+
+//!@{ Arena Allocator //////////////////////////////////////////////////////////
+
+/**
+ * @brief std::allocator compatible front end of a monotonic_arena.
+ * deallocate() does nothing; the memory goes back when the arena is released.
+ */
+template <typename T>
+class arena_allocator {
+public:
+  typedef T              value_type;
+  typedef T*             pointer;
+  typedef const T*       const_pointer;
+  typedef T&             reference;
+  typedef const T&       const_reference;
+  typedef size_t         size_type;
+  typedef ptrdiff_t      difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef arena_allocator<U> other;
+  };
+
+  monotonic_arena* arena;
+
+  explicit arena_allocator(monotonic_arena& a) : arena(&a) { }
+
+  template <typename U>
+  arena_allocator(const arena_allocator<U>& x) : arena(x.arena) { }
+
+  pointer allocate(size_type n, const void* = 0) {
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<pointer>(arena->allocate(n * sizeof(T)));
+  }
+
+  void deallocate(pointer, size_type) { }
+
+  void construct(pointer p, const T& v) { new (static_cast<void*>(p)) T(v); }
+  void destroy(pointer p) { p->~T(); }
+
+  pointer       address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+
+  size_type max_size() const { return size_type(-1) / sizeof(T); }
+};
+
+template <typename T, typename U>
+inline bool operator==(const arena_allocator<T>& x,
+                       const arena_allocator<U>& y) {
+  return x.arena == y.arena;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const arena_allocator<T>& x,
+                       const arena_allocator<U>& y) {
+  return x.arena != y.arena;
+}
+
+template <typename T>
+struct is_monotonic_allocator<arena_allocator<T> > {
+  static const bool value = true;
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __ARENA_HPP__ */
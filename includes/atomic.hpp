@@ -0,0 +1,133 @@
+#ifndef __ATOMIC_HPP__
+#define __ATOMIC_HPP__
+
+#include <cstddef>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+#endif
+
+namespace ft {
+
+//!@{ Atomic Helpers ///////////////////////////////////////////////////////////
+
+/*
+ * Building blocks of the lock-free containers. C++98 has no std::atomic, so
+ * they rely on the GCC __sync and __atomic builtins like the rest of the
+ * library.
+ */
+
+// Padding unit that keeps data written by different threads apart
+const size_t cache_line_size = 64;
+
+/**
+ * @brief Spin-wait hint: lets the sibling hyperthread run and saves power.
+ */
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+
+/**
+ * @brief Waiting policy of the blocking operations: spins with cpu_relax()
+ * while the other side is likely running, then yields the CPU, which is
+ * what lets a producer and a consumer share one core.
+ */
+class backoff {
+  int _spins;
+
+public:
+  static const int spin_limit = 64;
+
+  backoff() : _spins(0) { }
+
+  void pause() {
+    if (_spins < spin_limit) {
+      ++_spins;
+      cpu_relax();
+    } else
+      sched_yield();
+  }
+};
+
+//!@}
+
+//!@{ Tagged Pointers //////////////////////////////////////////////////////////
+
+/*
+ * A pointer paired with a counter that changes on every successful update,
+ * both swapped by one double-width compare-and-swap. A thread that read the
+ * head, was preempted while other threads popped that node and pushed it
+ * back, and then tries its CAS fails on the counter although the pointer
+ * matches again: the ABA problem of a plain pointer CAS. On x86-64 the swap
+ * is cmpxchg16b, on 32-bit targets an 8-byte CAS; other 64-bit targets go
+ * through the __atomic builtins and may need -latomic.
+ */
+
+template <typename Node>
+struct tagged_ptr {
+  Node*  ptr;
+  size_t tag;
+} __attribute__((aligned(2 * sizeof(void*))));
+
+#if defined(__x86_64__)
+
+template <typename Node>
+__attribute__((target("cx16"))) inline bool
+tagged_cas(tagged_ptr<Node>* where, const tagged_ptr<Node>& expected,
+           Node* ptr) {
+  tagged_ptr<Node>  desired = { ptr, expected.tag + 1 };
+  unsigned __int128 e;
+  unsigned __int128 d;
+  __builtin_memcpy(&e, &expected, sizeof(e));
+  __builtin_memcpy(&d, &desired, sizeof(d));
+  return __sync_bool_compare_and_swap(
+      reinterpret_cast<unsigned __int128*>(where), e, d);
+}
+
+#elif __SIZEOF_POINTER__ == 4
+
+template <typename Node>
+inline bool tagged_cas(tagged_ptr<Node>* where,
+                       const tagged_ptr<Node>& expected, Node* ptr) {
+  tagged_ptr<Node>   desired = { ptr, expected.tag + 1 };
+  unsigned long long e;
+  unsigned long long d;
+  __builtin_memcpy(&e, &expected, sizeof(e));
+  __builtin_memcpy(&d, &desired, sizeof(d));
+  return __sync_bool_compare_and_swap(
+      reinterpret_cast<unsigned long long*>(where), e, d);
+}
+
+#else
+
+template <typename Node>
+inline bool tagged_cas(tagged_ptr<Node>* where,
+                       const tagged_ptr<Node>& expected, Node* ptr) {
+  tagged_ptr<Node> e = expected;
+  tagged_ptr<Node> desired = { ptr, expected.tag + 1 };
+  return __atomic_compare_exchange(where, &e, &desired, false,
+                                   __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+#endif
+
+/**
+ * @brief Snapshot of a tagged pointer. The halves are read separately: a
+ * torn snapshot only makes the following CAS fail.
+ */
+template <typename Node>
+inline tagged_ptr<Node> tagged_load(const tagged_ptr<Node>* where) {
+  tagged_ptr<Node> t;
+  t.tag = __atomic_load_n(&where->tag, __ATOMIC_ACQUIRE);
+  t.ptr = __atomic_load_n(&where->ptr, __ATOMIC_ACQUIRE);
+  return t;
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __ATOMIC_HPP__ */
@@ -0,0 +1,304 @@
+/** @file bloom_filter.hpp
+ *  This is an internal header file, included by rb_tree.hpp.
+ *  You should not attempt to use it directly.
+ */
+
+#ifndef __BLOOM_FILTER_HPP__
+#define __BLOOM_FILTER_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <stdlib.h>
+#include <string>
+
+namespace ft {
+
+//!@{ Hash /////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief 64-bit finalizer (murmur3 fmix64). Spreads every input bit over the
+ * whole word so that block and bit selection can use disjoint bit ranges.
+ */
+inline size_t bloom_mix(unsigned long long x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return static_cast<size_t>(x);
+}
+
+/**
+ * @brief Hash used by the lookup filter of rb_tree.
+ * The primary template is disabled: keys without a specialization can not
+ * enable the filter and lookups keep descending the tree as before. Equal
+ * values hash alike, so the hash only agrees with comparators that order by
+ * value (see bloom_value_order).
+ */
+template <typename Key>
+struct bloom_hash {
+  static const bool enabled = false;
+  size_t operator()(const Key&) const { return 0; }
+};
+
+#define FT_BLOOM_INTEGRAL_HASH(T)                                              \
+  template <>                                                                  \
+  struct bloom_hash<T> {                                                       \
+    static const bool enabled = true;                                          \
+    size_t operator()(T x) const {                                             \
+      return bloom_mix(static_cast<unsigned long long>(x));                    \
+    }                                                                          \
+  };
+
+FT_BLOOM_INTEGRAL_HASH(bool)
+FT_BLOOM_INTEGRAL_HASH(char)
+FT_BLOOM_INTEGRAL_HASH(signed char)
+FT_BLOOM_INTEGRAL_HASH(unsigned char)
+FT_BLOOM_INTEGRAL_HASH(short)
+FT_BLOOM_INTEGRAL_HASH(unsigned short)
+FT_BLOOM_INTEGRAL_HASH(int)
+FT_BLOOM_INTEGRAL_HASH(unsigned int)
+FT_BLOOM_INTEGRAL_HASH(long)
+FT_BLOOM_INTEGRAL_HASH(unsigned long)
+FT_BLOOM_INTEGRAL_HASH(long long)
+FT_BLOOM_INTEGRAL_HASH(unsigned long long)
+
+#undef FT_BLOOM_INTEGRAL_HASH
+
+template <>
+struct bloom_hash<std::string> {
+  static const bool enabled = true;
+  size_t operator()(const std::string& s) const {
+    // FNV-1a over the bytes, then finalized
+    unsigned long long h = 14695981039346656037ULL;
+    for (std::string::size_type i = 0; i < s.size(); ++i) {
+      h ^= static_cast<unsigned char>(s[i]);
+      h *= 1099511628211ULL;
+    }
+    return bloom_mix(h);
+  }
+};
+
+/**
+ * @brief Whether Compare finds two keys equivalent exactly when they are
+ * equal, so that bloom_hash<Key> never separates keys a lookup would match.
+ * True for std::less and std::greater; any other comparator needs a hash
+ * written for it.
+ */
+template <typename Compare, typename Key>
+struct bloom_value_order { static const bool value = false; };
+
+template <typename Key>
+struct bloom_value_order<std::less<Key>, Key> {
+  static const bool value = true;
+};
+
+template <typename Key>
+struct bloom_value_order<std::greater<Key>, Key> {
+  static const bool value = true;
+};
+
+//!@}
+
+//!@{ Blocked Bloom Filter /////////////////////////////////////////////////////
+
+/**
+ * @brief Counters exported by the lookup filter, used to tune its size.
+ * lookups, misses_avoided and false_positives are bumped by const lookups,
+ * which may run on several threads at once, so they are updated atomically.
+ */
+struct bloom_filter_stats {
+  size_t lookups;         // lookups that consulted the filter
+  size_t misses_avoided;  // definite misses answered without a tree descent
+  size_t false_positives; // filter said "maybe" but the key was absent
+  size_t rebuilds;        // lazy rebuilds after erases or growth
+  size_t bits;            // size of the bit array
+  size_t bits_per_key;    // configured density
+};
+
+/**
+ * @brief Bloom filter split into 512-bit blocks, one cache line each.
+ * Every key touches a single block, so a probe costs at most one cache miss.
+ * Keys are inserted by hash value; removal is not supported, which is why
+ * the owner counts erases and asks for a rebuild once they pile up.
+ */
+class blocked_bloom_filter {
+public:
+  typedef unsigned long long word_type;
+
+  static const size_t block_bits = 512;
+  static const size_t block_words = block_bits / (sizeof(word_type) * 8);
+
+private:
+  word_type* _words;
+  size_t     _num_blocks; // always a power of two
+  size_t     _num_probes;
+  size_t     _bits_per_key;
+  size_t     _capacity;   // number of keys the array was sized for
+  size_t     _inserted;
+  size_t     _erased;
+
+public:
+  bloom_filter_stats stats;
+
+  explicit blocked_bloom_filter(size_t bits_per_key)
+  : _words(0), _num_blocks(0), _num_probes(0), _bits_per_key(bits_per_key),
+    _capacity(0), _inserted(0), _erased(0) {
+    if (_bits_per_key == 0)
+      _bits_per_key = 1;
+    // k = bits_per_key * ln(2), clamped to a sane range
+    _num_probes = _bits_per_key * 69 / 100;
+    if (_num_probes < 1)
+      _num_probes = 1;
+    if (_num_probes > 16)
+      _num_probes = 16;
+    std::memset(&stats, 0, sizeof(stats));
+    stats.bits_per_key = _bits_per_key;
+  }
+
+  blocked_bloom_filter(const blocked_bloom_filter& x)
+  : _words(0), _num_blocks(0), _num_probes(x._num_probes),
+    _bits_per_key(x._bits_per_key), _capacity(x._capacity),
+    _inserted(x._inserted), _erased(x._erased), stats(x.snapshot()) {
+    if (x._num_blocks != 0) {
+      _allocate(x._num_blocks);
+      std::memcpy(_words, x._words, _num_blocks * block_words *
+                                        sizeof(word_type));
+    }
+  }
+
+  ~blocked_bloom_filter() { free(_words); }
+
+  /**
+   * @brief Drops every key and sizes the bit array for @p expected keys.
+   */
+  void reset(size_t expected) {
+    if (expected < 64)
+      expected = 64;
+    size_t blocks = 1;
+    while (blocks * block_bits < expected * _bits_per_key)
+      blocks <<= 1;
+    if (blocks != _num_blocks) {
+      free(_words);
+      _words = 0;
+      _num_blocks = 0;
+      _allocate(blocks);
+    }
+    std::memset(_words, 0, _num_blocks * block_words * sizeof(word_type));
+    _capacity = expected;
+    _inserted = 0;
+    _erased = 0;
+    stats.bits = _num_blocks * block_bits;
+  }
+
+  void insert(size_t h) {
+    word_type* block = _block(h);
+    size_t     g = static_cast<unsigned int>(h);
+    size_t     delta = ((g >> 17) | (g << 15)) | 1;
+
+    for (size_t i = 0; i < _num_probes; ++i) {
+      size_t bit = g & (block_bits - 1);
+      block[bit >> 6] |= word_type(1) << (bit & 63);
+      g += delta;
+    }
+    ++_inserted;
+  }
+
+  /**
+   * @brief false means the key was never inserted; true means "maybe".
+   */
+  bool may_contain(size_t h) const {
+    const word_type* block = _block(h);
+    size_t           g = static_cast<unsigned int>(h);
+    size_t           delta = ((g >> 17) | (g << 15)) | 1;
+
+    for (size_t i = 0; i < _num_probes; ++i) {
+      size_t bit = g & (block_bits - 1);
+      if ((block[bit >> 6] & (word_type(1) << (bit & 63))) == 0)
+        return false;
+      g += delta;
+    }
+    return true;
+  }
+
+  void note_erase() { ++_erased; }
+
+  // for the lookup counters of stats
+  static void count(size_t& counter) {
+    __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+  }
+
+  bloom_filter_stats snapshot() const {
+    bloom_filter_stats s;
+    s.lookups = __atomic_load_n(&stats.lookups, __ATOMIC_RELAXED);
+    s.misses_avoided =
+        __atomic_load_n(&stats.misses_avoided, __ATOMIC_RELAXED);
+    s.false_positives =
+        __atomic_load_n(&stats.false_positives, __ATOMIC_RELAXED);
+    s.rebuilds = stats.rebuilds;
+    s.bits = stats.bits;
+    s.bits_per_key = stats.bits_per_key;
+    return s;
+  }
+
+  /**
+   * @brief Whether the filter should be rebuilt from the live keys: either a
+   * quarter of the inserted keys have been erased since the last rebuild, or
+   * the container outgrew the size the bit array was planned for.
+   */
+  bool needs_rebuild(size_t live) const {
+    return _num_blocks == 0 || _erased * 4 > _inserted ||
+           live > _capacity * 2;
+  }
+
+  size_t bits_per_key() const { return _bits_per_key; }
+
+  size_t memory_bytes() const {
+    return _num_blocks * block_words * sizeof(word_type);
+  }
+
+private:
+  blocked_bloom_filter& operator=(const blocked_bloom_filter&);
+
+  void _allocate(size_t blocks) {
+    void* p = 0;
+    if (posix_memalign(&p, 64, blocks * block_words * sizeof(word_type)) != 0)
+      throw std::bad_alloc();
+    _words = static_cast<word_type*>(p);
+    _num_blocks = blocks;
+  }
+
+  word_type* _block(size_t h) const {
+    // the low half feeds the bit probes, the high half picks the block
+    return _words + ((h >> (sizeof(size_t) * 4)) & (_num_blocks - 1)) *
+                        block_words;
+  }
+};
+
+/**
+ * @brief The filter of one rb_tree, with the hash of its keys: bloom_hash
+ * by default, or a function supplied by the owner of the tree.
+ */
+template <typename Key>
+class key_bloom_filter : public blocked_bloom_filter {
+public:
+  typedef size_t (*hash_function)(const Key&);
+
+  key_bloom_filter(size_t bits_per_key, hash_function hash)
+  : blocked_bloom_filter(bits_per_key), _hash(hash) { }
+
+  size_t hash(const Key& k) const {
+    return _hash ? _hash(k) : bloom_hash<Key>()(k);
+  }
+
+private:
+  hash_function _hash; // 0 for bloom_hash
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __BLOOM_FILTER_HPP__ */
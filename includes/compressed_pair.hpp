@@ -0,0 +1,64 @@
+/** @file compressed_pair.hpp
+ *  This is an internal header file, included by rb_tree.hpp, vector.hpp
+ *  and ring_buffer.hpp.
+ *  You should not attempt to use it directly.
+ */
+
+#ifndef __COMPRESSED_PAIR_HPP__
+#define __COMPRESSED_PAIR_HPP__
+
+#include "type_traits.hpp"
+
+namespace ft
+{
+
+/**
+ * @brief Holds one value of type T, as a base class when T is empty so that
+ * it takes no space in the derived object (empty base optimization). Index
+ * keeps the two bases of a compressed_pair<T, T> distinct.
+ */
+template <class T, int Index, bool = is_empty<T>::value>
+struct ebo_storage {
+  T _value;
+
+  ebo_storage() : _value() {}
+  explicit ebo_storage(const T& v) : _value(v) {}
+
+  T&       get() { return _value; }
+  const T& get() const { return _value; }
+};
+
+template <class T, int Index>
+struct ebo_storage<T, Index, true> : private T {
+  ebo_storage() : T() {}
+  explicit ebo_storage(const T& v) : T(v) {}
+
+  T&       get() { return *this; }
+  const T& get() const { return *this; }
+};
+
+/**
+ * @brief Pair whose empty members (stateless allocators and comparators)
+ * occupy no bytes: sizeof(compressed_pair<std::allocator<int>, int*>) is
+ * sizeof(int*). Containers pair each policy object with a data member that
+ * is always present.
+ */
+template <class T1, class T2>
+class compressed_pair : private ebo_storage<T1, 0>,
+                        private ebo_storage<T2, 1> {
+  typedef ebo_storage<T1, 0> first_base;
+  typedef ebo_storage<T2, 1> second_base;
+
+public:
+  compressed_pair() : first_base(), second_base() {}
+  compressed_pair(const T1& a, const T2& b) : first_base(a), second_base(b) {}
+
+  T1&       first() { return first_base::get(); }
+  const T1& first() const { return first_base::get(); }
+  T2&       second() { return second_base::get(); }
+  const T2& second() const { return second_base::get(); }
+};
+
+} /* namespace ft */
+
+#endif /* __COMPRESSED_PAIR_HPP__ */
@@ -0,0 +1,228 @@
+#ifndef __CONCURRENT_STACK_HPP__
+#define __CONCURRENT_STACK_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <sched.h>
+#include "atomic.hpp"
+
+namespace ft {
+
+//!@{ Concurrent Stack /////////////////////////////////////////////////////////
+
+/**
+ * @brief Lock-free LIFO stack (Treiber stack) for many producers and
+ * consumers.
+ *
+ * push and try_pop swing the head with a tagged CAS. Popped nodes are not
+ * freed but kept on an internal free list, itself a Treiber stack, and
+ * reused by later pushes; a thread reading the link of a node that another
+ * thread just popped thus never touches freed memory. Nodes go back to the
+ * allocator when the stack is destroyed, so the footprint is that of the
+ * largest size reached.
+ *
+ * Under contention a failed CAS backs off into an elimination array: a push
+ * offers its node in a random slot for a short while, and a pop that failed
+ * its own CAS takes any offered node. A push and a pop that meet there
+ * cancel out without touching the head at all.
+ *
+ * There is no top(): the element would be gone by the time it is read, so
+ * try_pop copies it out. Not copyable.
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class concurrent_stack {
+public:
+  typedef T      value_type;
+  typedef Alloc  allocator_type;
+  typedef size_t size_type;
+
+  // slots of the elimination array, and spins a push waits in one
+  static const size_t elimination_slots = 16;
+  static const int    elimination_spins = 128;
+
+private:
+  struct node {
+    node* next;
+    T     value;
+  };
+
+  typedef typename Alloc::template rebind<node>::other node_allocator;
+
+  // one cache line per slot, so that threads meeting in one slot do not
+  // slow down those meeting in the next. Offers are tagged too: the node
+  // a push offered may be taken, popped and offered again by another push
+  // before the first one withdraws.
+  struct slot {
+    tagged_ptr<node> offer;
+    char             pad[cache_line_size - sizeof(tagged_ptr<node>)];
+  };
+
+  tagged_ptr<node> _head;
+  char             _pad0[cache_line_size - sizeof(tagged_ptr<node>)];
+  tagged_ptr<node> _free;
+  char             _pad1[cache_line_size - sizeof(tagged_ptr<node>)];
+  slot             _slots[elimination_slots];
+  node_allocator   _alloc;
+
+public:
+  explicit concurrent_stack(const allocator_type& a = allocator_type())
+  : _alloc(a) {
+    _head.ptr = 0;
+    _head.tag = 0;
+    _free.ptr = 0;
+    _free.tag = 0;
+    for (size_t i = 0; i < elimination_slots; ++i) {
+      _slots[i].offer.ptr = 0;
+      _slots[i].offer.tag = 0;
+    }
+  }
+
+  /**
+   * @brief Destroys the remaining elements. No other thread may use the
+   * stack any more.
+   */
+  ~concurrent_stack() {
+    for (node* n = _head.ptr; n != 0;) {
+      node* next = n->next;
+      n->value.~T(); // only the value was constructed
+      _alloc.deallocate(n, 1);
+      n = next;
+    }
+    for (node* n = _free.ptr; n != 0;) {
+      node* next = n->next;
+      _alloc.deallocate(n, 1);
+      n = next;
+    }
+  }
+
+  void push(const value_type& x) {
+    node* n = _acquire_node();
+    try {
+      new (&n->value) T(x);
+    } catch (...) {
+      _push_node(_free, n);
+      throw;
+    }
+    for (;;) {
+      tagged_ptr<node> head = tagged_load(&_head);
+      __atomic_store_n(&n->next, head.ptr, __ATOMIC_RELAXED);
+      if (tagged_cas(&_head, head, n))
+        return;
+      if (_offer(n))
+        return;
+    }
+  }
+
+  /**
+   * @brief Copies the top element into x and removes it.
+   * @return false, leaving x alone, when the stack was empty
+   */
+  bool try_pop(value_type& x) {
+    node* n;
+    for (;;) {
+      tagged_ptr<node> head = tagged_load(&_head);
+      if (head.ptr == 0)
+        return false;
+      node* next = __atomic_load_n(&head.ptr->next, __ATOMIC_RELAXED);
+      if (tagged_cas(&_head, head, next)) {
+        n = head.ptr;
+        break;
+      }
+      if ((n = _take()) != 0)
+        break;
+    }
+    try {
+      x = n->value;
+    } catch (...) {
+      // put it back rather than lose the element
+      for (;;) {
+        tagged_ptr<node> head = tagged_load(&_head);
+        __atomic_store_n(&n->next, head.ptr, __ATOMIC_RELAXED);
+        if (tagged_cas(&_head, head, n))
+          throw;
+      }
+    }
+    n->value.~T();
+    _push_node(_free, n);
+    return true;
+  }
+
+  /**
+   * @brief Whether the stack was empty at some point during the call; an
+   * element may have been pushed since.
+   */
+  bool empty() const { return tagged_load(&_head).ptr == 0; }
+
+private:
+  node* _acquire_node() {
+    for (;;) {
+      tagged_ptr<node> head = tagged_load(&_free);
+      if (head.ptr == 0)
+        return _alloc.allocate(1);
+      node* next = __atomic_load_n(&head.ptr->next, __ATOMIC_RELAXED);
+      if (tagged_cas(&_free, head, next))
+        return head.ptr;
+    }
+  }
+
+  static void _push_node(tagged_ptr<node>& list, node* n) {
+    for (;;) {
+      tagged_ptr<node> head = tagged_load(&list);
+      __atomic_store_n(&n->next, head.ptr, __ATOMIC_RELAXED);
+      if (tagged_cas(&list, head, n))
+        return;
+    }
+  }
+
+  static size_t _random_slot() {
+    static __thread unsigned state = 0;
+    if (state == 0)
+      state = unsigned(reinterpret_cast<size_t>(&state)) | 1;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % elimination_slots;
+  }
+
+  /**
+   * @brief Offers n to a pop in a random slot for a while.
+   * @return true when a pop took it
+   */
+  bool _offer(node* n) {
+    slot&            s = _slots[_random_slot()];
+    tagged_ptr<node> empty = tagged_load(&s.offer);
+    if (empty.ptr != 0 || !tagged_cas(&s.offer, empty, n)) {
+      sched_yield();
+      return false;
+    }
+    tagged_ptr<node> offered = { n, empty.tag + 1 };
+    for (int i = 0; i < elimination_spins; ++i) {
+      if (__atomic_load_n(&s.offer.tag, __ATOMIC_ACQUIRE) != offered.tag)
+        return true;
+      cpu_relax();
+    }
+    // withdraw the offer, unless a pop took it in the meantime
+    return !tagged_cas(&s.offer, offered, (node*)0);
+  }
+
+  /**
+   * @return a node offered by a push, now owned by the caller, or null
+   */
+  node* _take() {
+    slot&            s = _slots[_random_slot()];
+    tagged_ptr<node> offered = tagged_load(&s.offer);
+    if (offered.ptr != 0 && tagged_cas(&s.offer, offered, (node*)0))
+      return offered.ptr;
+    return 0;
+  }
+
+  concurrent_stack(const concurrent_stack&);
+  concurrent_stack& operator=(const concurrent_stack&);
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __CONCURRENT_STACK_HPP__ */
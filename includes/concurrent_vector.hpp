@@ -0,0 +1,477 @@
+#ifndef __CONCURRENT_VECTOR_HPP__
+#define __CONCURRENT_VECTOR_HPP__
+
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "atomic.hpp"
+#include "iterator.hpp"
+#include "memory_stats.hpp"
+#include "pair.hpp"
+#include "vector.hpp"
+
+namespace ft {
+
+//!@{ Concurrent Vector Iterator ///////////////////////////////////////////////
+
+/*
+ * Random access iterator over a concurrent_vector: the vector and an index,
+ * dereferenced through operator[]. Vector is const for const_iterator.
+ */
+template <typename Vector, typename Value>
+class concurrent_vector_iterator {
+  Vector* _v;
+  size_t  _i;
+
+public:
+  typedef std::random_access_iterator_tag iterator_category;
+  typedef Value                           value_type;
+  typedef ptrdiff_t                       difference_type;
+  typedef Value*                          pointer;
+  typedef Value&                          reference;
+
+  concurrent_vector_iterator() : _v(0), _i(0) { }
+  concurrent_vector_iterator(Vector* v, size_t i) : _v(v), _i(i) { }
+
+  // Allow iterator to const_iterator conversion
+  template <typename V, typename U>
+  concurrent_vector_iterator(const concurrent_vector_iterator<V, U>& it)
+  : _v(it.vector()), _i(it.index()) { }
+
+  reference operator*() const { return (*_v)[_i]; }
+  pointer   operator->() const { return &(*_v)[_i]; }
+  reference operator[](difference_type n) const { return (*_v)[_i + n]; }
+
+  concurrent_vector_iterator& operator++() {
+    ++_i;
+    return *this;
+  }
+
+  concurrent_vector_iterator operator++(int) {
+    concurrent_vector_iterator tmp(*this);
+    ++_i;
+    return tmp;
+  }
+
+  concurrent_vector_iterator& operator--() {
+    --_i;
+    return *this;
+  }
+
+  concurrent_vector_iterator operator--(int) {
+    concurrent_vector_iterator tmp(*this);
+    --_i;
+    return tmp;
+  }
+
+  concurrent_vector_iterator& operator+=(difference_type n) {
+    _i += n;
+    return *this;
+  }
+
+  concurrent_vector_iterator operator+(difference_type n) const {
+    return concurrent_vector_iterator(_v, _i + n);
+  }
+
+  concurrent_vector_iterator& operator-=(difference_type n) {
+    _i -= n;
+    return *this;
+  }
+
+  concurrent_vector_iterator operator-(difference_type n) const {
+    return concurrent_vector_iterator(_v, _i - n);
+  }
+
+  Vector* vector() const { return _v; }
+  size_t  index() const { return _i; }
+};
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator==(const concurrent_vector_iterator<V1, U1>& lhs,
+                       const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() == rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator!=(const concurrent_vector_iterator<V1, U1>& lhs,
+                       const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() != rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator<(const concurrent_vector_iterator<V1, U1>& lhs,
+                      const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() < rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator>(const concurrent_vector_iterator<V1, U1>& lhs,
+                      const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() > rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator<=(const concurrent_vector_iterator<V1, U1>& lhs,
+                       const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() <= rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline bool operator>=(const concurrent_vector_iterator<V1, U1>& lhs,
+                       const concurrent_vector_iterator<V2, U2>& rhs) {
+  return lhs.index() >= rhs.index();
+}
+
+template <typename V1, typename U1, typename V2, typename U2>
+inline ptrdiff_t operator-(const concurrent_vector_iterator<V1, U1>& lhs,
+                           const concurrent_vector_iterator<V2, U2>& rhs) {
+  return ptrdiff_t(lhs.index() - rhs.index());
+}
+
+template <typename V, typename U>
+inline concurrent_vector_iterator<V, U>
+operator+(ptrdiff_t n, const concurrent_vector_iterator<V, U>& it) {
+  return it + n;
+}
+
+//!@}
+
+//!@{ Concurrent Vector ////////////////////////////////////////////////////////
+
+/**
+ * @brief Vector that many threads can append to at once, and whose elements
+ * never move.
+ *
+ * The elements live in segments of exponentially growing size:
+ * first_segment_size elements, then twice that, and so on, so that element
+ * i is found with one bit scan and growing never copies anything. A
+ * reference or iterator stays valid until clear() or destruction, even
+ * while other threads keep appending.
+ *
+ * push_back and grow_by claim their indices with one atomic add on the
+ * size and construct the elements in place. The thread whose range starts a
+ * segment allocates it; another thread landing in that segment waits for
+ * the allocation, and nothing else ever blocks. size() counts claimed
+ * elements, some of which may still be under construction: a thread may
+ * read an element once it knows, through the index returned by push_back or
+ * grow_by or some other synchronization, that its construction finished.
+ *
+ * If constructing an element throws, or its segment cannot be allocated,
+ * the exception propagates and the indices claimed by that call stay empty:
+ * they still count in size() but must not be read. clear() and the
+ * destructor are not thread-safe. Not copyable.
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class concurrent_vector {
+public:
+  typedef T                                        value_type;
+  typedef Alloc                                    allocator_type;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+
+  typedef concurrent_vector_iterator<concurrent_vector, T> iterator;
+  typedef concurrent_vector_iterator<const concurrent_vector, const T>
+      const_iterator;
+
+  // elements in the first segment; segment k holds first_segment_size << k
+  static const size_type first_segment_size = 16;
+
+private:
+  static const int       _first_segment_bits = 4;
+  static const size_type _segment_count =
+      sizeof(size_type) * CHAR_BIT - _first_segment_bits;
+
+  typedef ft::pair<size_type, size_type> index_range;
+
+  pointer        _segments[_segment_count];
+  allocator_type _alloc;
+  // segments whose allocation failed, as bits; their claimants give up
+  size_type      _failed;
+  // ranges claimed by calls that threw, never constructed
+  ft::vector<index_range> _holes;
+  int                     _holes_lock;
+  // the claim counter, on a cache line of its own
+  char           _pad0[cache_line_size];
+  size_type      _size;
+  char           _pad1[cache_line_size - sizeof(size_type)];
+
+public:
+  //!@{ construct/copy/destroy ///////////////////////////////////////////////
+
+  explicit concurrent_vector(const allocator_type& a = allocator_type())
+  : _alloc(a), _failed(0), _holes_lock(0), _size(0) {
+    for (size_type k = 0; k < _segment_count; ++k)
+      _segments[k] = 0;
+  }
+
+  /**
+   * @brief Destroys the elements and frees the segments. No other thread
+   * may use the vector any more.
+   */
+  ~concurrent_vector() {
+    clear();
+    for (size_type k = 0; k < _segment_count; ++k)
+      if (_segments[k])
+        _alloc.deallocate(_segments[k], _segment_size(k));
+  }
+
+  allocator_type get_allocator() const { return _alloc; }
+
+  //!@}
+
+  //!@{ Iterators ////////////////////////////////////////////////////////////
+
+  iterator       begin() { return iterator(this, 0); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  iterator       end() { return iterator(this, size()); }
+  const_iterator end() const { return const_iterator(this, size()); }
+
+  //!@}
+
+  //!@{ Capacity /////////////////////////////////////////////////////////////
+
+  // Claimed elements, including any still under construction
+  size_type size() const {
+    return __atomic_load_n(&_size, __ATOMIC_RELAXED);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  size_type max_size() const {
+    size_type m = _alloc.max_size();
+    size_type limit = size_type(-1) / 2;
+    return m < limit ? m : limit;
+  }
+
+  // Elements the allocated segments can hold
+  size_type capacity() const {
+    size_type n = 0;
+    for (size_type k = 0; k < _segment_count; ++k)
+      if (__atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE))
+        n += _segment_size(k);
+    return n;
+  }
+
+  /**
+   * @brief Allocates the segments holding the first n elements, so that
+   * appends up to that size never wait for an allocation. Thread-safe.
+   */
+  void reserve(size_type n) {
+    if (n > max_size())
+      throw std::length_error("concurrent_vector::reserve");
+    if (n == 0)
+      return;
+    for (size_type k = 0; k <= _segment_of(n - 1); ++k)
+      _allocate_segment(k);
+  }
+
+  memory_stats memory_usage() const {
+    memory_stats s;
+    s.payload_bytes = size() * sizeof(value_type);
+    s.overhead_bytes = capacity() * sizeof(value_type) - s.payload_bytes;
+    s.allocations = 0;
+    for (size_type k = 0; k < _segment_count; ++k)
+      s.allocations += __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE) != 0;
+    return s;
+  }
+
+  //!@}
+
+  //!@{ Element Access ///////////////////////////////////////////////////////
+
+  reference operator[](size_type i) {
+    size_type k = _segment_of(i);
+    return _segments[k][i - _segment_base(k)];
+  }
+
+  const_reference operator[](size_type i) const {
+    size_type k = _segment_of(i);
+    return _segments[k][i - _segment_base(k)];
+  }
+
+  reference at(size_type i) {
+    if (i >= size())
+      throw std::out_of_range("concurrent_vector::at");
+    return (*this)[i];
+  }
+
+  const_reference at(size_type i) const {
+    if (i >= size())
+      throw std::out_of_range("concurrent_vector::at");
+    return (*this)[i];
+  }
+
+  reference       front() { return (*this)[0]; }
+  const_reference front() const { return (*this)[0]; }
+
+  //!@}
+
+  //!@{ Modifiers ////////////////////////////////////////////////////////////
+
+  /**
+   * @brief Appends a copy of x. Thread-safe.
+   * @return the new element, which stays where it is
+   */
+  reference push_back(const value_type& x) {
+    size_type i = _claim(1);
+    size_type k = _segment_of(i);
+    size_type base = _segment_base(k);
+    pointer   seg = __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE);
+    if (seg == 0 || i == base) {
+      _construct_range(i, 1, x);
+      seg = _segments[k];
+    } else {
+      try {
+        _alloc.construct(seg + (i - base), x);
+      } catch (...) {
+        _add_hole(i, i + 1);
+        throw;
+      }
+    }
+    return seg[i - base];
+  }
+
+  /**
+   * @brief Appends n copies of x at consecutive indices. Thread-safe.
+   * @return iterator to the first of them
+   */
+  iterator grow_by(size_type n, const value_type& x = value_type()) {
+    size_type first = _claim(n);
+    _construct_range(first, n, x);
+    return iterator(this, first);
+  }
+
+  /**
+   * @brief Destroys all elements and keeps the segments. Not thread-safe.
+   */
+  void clear() {
+    size_type n = _size;
+    for (size_type i = 0; i < n; ++i)
+      if (!_in_hole(i))
+        _alloc.destroy(&(*this)[i]);
+    _size = 0;
+    _failed = 0;
+    _holes.clear();
+  }
+
+  //!@}
+
+private:
+  static size_type _segment_of(size_type i) {
+    unsigned long j = (unsigned long)(i + first_segment_size);
+    return sizeof(unsigned long) * CHAR_BIT - 1 - __builtin_clzl(j) -
+           _first_segment_bits;
+  }
+
+  static size_type _segment_base(size_type k) {
+    return (first_segment_size << k) - first_segment_size;
+  }
+
+  static size_type _segment_size(size_type k) {
+    return first_segment_size << k;
+  }
+
+  size_type _claim(size_type n) {
+    if (n > max_size() - size())
+      throw std::length_error("concurrent_vector::grow_by");
+    return __atomic_fetch_add(&_size, n, __ATOMIC_RELAXED);
+  }
+
+  /**
+   * @brief Segment k, allocating it unless another thread did first.
+   */
+  pointer _allocate_segment(size_type k) {
+    pointer seg = __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE);
+    if (seg)
+      return seg;
+    pointer mine = _alloc.allocate(_segment_size(k));
+    if (__atomic_compare_exchange_n(&_segments[k], &seg, mine, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      return mine;
+    _alloc.deallocate(mine, _segment_size(k));
+    return seg;
+  }
+
+  /**
+   * @brief Segment k, waiting for the thread that claimed its first element
+   * to allocate it.
+   * @throw std::bad_alloc when that allocation failed
+   */
+  pointer _wait_segment(size_type k) {
+    backoff b;
+    for (;;) {
+      pointer seg = __atomic_load_n(&_segments[k], __ATOMIC_ACQUIRE);
+      if (seg)
+        return seg;
+      if (__atomic_load_n(&_failed, __ATOMIC_ACQUIRE) & (size_type(1) << k))
+        throw std::bad_alloc();
+      b.pause();
+    }
+  }
+
+  // constructs the claimed indices [first, first + n) from x
+  void _construct_range(size_type first, size_type n, const value_type& x) {
+    size_type i = first;
+    size_type last = first + n;
+    try {
+      while (i < last) {
+        size_type k = _segment_of(i);
+        size_type base = _segment_base(k);
+        pointer   seg;
+        if (i != base)
+          seg = _wait_segment(k);
+        else {
+          try {
+            seg = _allocate_segment(k);
+          } catch (...) {
+            __atomic_or_fetch(&_failed, size_type(1) << k, __ATOMIC_RELEASE);
+            throw;
+          }
+        }
+        size_type end = base + _segment_size(k);
+        if (end > last)
+          end = last;
+        for (; i < end; ++i)
+          _alloc.construct(seg + (i - base), x);
+      }
+    } catch (...) {
+      _add_hole(i, last);
+      throw;
+    }
+  }
+
+  void _add_hole(size_type first, size_type last) {
+    while (__atomic_exchange_n(&_holes_lock, 1, __ATOMIC_ACQUIRE))
+      cpu_relax();
+    try {
+      _holes.push_back(index_range(first, last));
+    } catch (...) {
+      __atomic_store_n(&_holes_lock, 0, __ATOMIC_RELEASE);
+      throw;
+    }
+    __atomic_store_n(&_holes_lock, 0, __ATOMIC_RELEASE);
+  }
+
+  bool _in_hole(size_type i) const {
+    for (size_type h = 0; h < _holes.size(); ++h)
+      if (i >= _holes[h].first && i < _holes[h].second)
+        return true;
+    return false;
+  }
+
+  concurrent_vector(const concurrent_vector&);
+  concurrent_vector& operator=(const concurrent_vector&);
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __CONCURRENT_VECTOR_HPP__ */
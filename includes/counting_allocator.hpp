@@ -0,0 +1,163 @@
+#ifndef __COUNTING_ALLOCATOR_HPP__
+#define __COUNTING_ALLOCATOR_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace ft {
+
+//!@{ Allocation Statistics ////////////////////////////////////////////////////
+
+/**
+ * @brief Allocation counters shared by every counting_allocator pointing at
+ * them. Sizes are in bytes. Not synchronized: give each thread its own.
+ */
+struct allocation_stats {
+  static const size_t num_buckets = sizeof(size_t) * 8;
+
+  size_t allocations;
+  size_t deallocations;
+  size_t bytes_allocated;
+  size_t bytes_deallocated;
+  size_t live_bytes;
+  size_t peak_bytes;
+  // histogram[i] counts requests of [2^i, 2^(i+1)) bytes, [0] also holds 0
+  size_t histogram[num_buckets];
+
+  allocation_stats() { reset(); }
+
+  void reset() {
+    allocations = 0;
+    deallocations = 0;
+    bytes_allocated = 0;
+    bytes_deallocated = 0;
+    live_bytes = 0;
+    peak_bytes = 0;
+    std::memset(histogram, 0, sizeof(histogram));
+  }
+
+  /**
+   * @brief Restarts peak tracking from the current live size, so that
+   * peak_bytes - live_bytes afterwards is the high-water mark of a region.
+   */
+  void reset_peak() { peak_bytes = live_bytes; }
+
+  size_t live_allocations() const { return allocations - deallocations; }
+
+  static size_t bucket(size_t bytes) {
+    size_t b = 0;
+    while (bytes >>= 1)
+      ++b;
+    return b;
+  }
+
+  void record_allocate(size_t bytes) {
+    ++allocations;
+    bytes_allocated += bytes;
+    live_bytes += bytes;
+    if (live_bytes > peak_bytes)
+      peak_bytes = live_bytes;
+    ++histogram[bucket(bytes)];
+  }
+
+  void record_deallocate(size_t bytes) {
+    ++deallocations;
+    bytes_deallocated += bytes;
+    live_bytes -= bytes;
+  }
+};
+
+/**
+ * @brief Stats used by default-constructed counting allocators, i.e. by
+ * containers built without an explicit allocator argument.
+ */
+inline allocation_stats& default_allocation_stats() {
+  static allocation_stats s;
+  return s;
+}
+
+//!@}
+
+//!@{ Counting Allocator ///////////////////////////////////////////////////////
+
+/**
+ * @brief Forwards to Alloc and records every allocate() and deallocate() in
+ * an allocation_stats. Rebound copies, such as the node allocator of a map,
+ * keep recording into the same stats object.
+ *
+ * @code
+ * ft::allocation_stats                          stats;
+ * ft::counting_allocator<int>                   alloc(stats);
+ * ft::vector<int, ft::counting_allocator<int> > v(alloc);
+ * @endcode
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class counting_allocator {
+public:
+  typedef typename Alloc::value_type      value_type;
+  typedef typename Alloc::pointer         pointer;
+  typedef typename Alloc::const_pointer   const_pointer;
+  typedef typename Alloc::reference       reference;
+  typedef typename Alloc::const_reference const_reference;
+  typedef typename Alloc::size_type       size_type;
+  typedef typename Alloc::difference_type difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef counting_allocator<
+        U, typename Alloc::template rebind<U>::other> other;
+  };
+
+  allocation_stats* stats;
+  Alloc             base;
+
+  counting_allocator() : stats(&default_allocation_stats()), base() { }
+
+  explicit counting_allocator(allocation_stats& s, const Alloc& a = Alloc())
+  : stats(&s), base(a) { }
+
+  template <typename U, typename A>
+  counting_allocator(const counting_allocator<U, A>& x)
+  : stats(x.stats), base(x.base) { }
+
+  pointer allocate(size_type n, const void* hint = 0) {
+    pointer p = base.allocate(n, hint);
+    stats->record_allocate(n * sizeof(T));
+    return p;
+  }
+
+  void deallocate(pointer p, size_type n) {
+    if (p == 0)
+      return;
+    stats->record_deallocate(n * sizeof(T));
+    base.deallocate(p, n);
+  }
+
+  void construct(pointer p, const T& v) { base.construct(p, v); }
+  void destroy(pointer p) { base.destroy(p); }
+
+  pointer       address(reference x) const { return base.address(x); }
+  const_pointer address(const_reference x) const { return base.address(x); }
+
+  size_type max_size() const { return base.max_size(); }
+};
+
+template <typename T, typename A, typename U, typename B>
+inline bool operator==(const counting_allocator<T, A>& x,
+                       const counting_allocator<U, B>& y) {
+  return x.stats == y.stats && x.base == y.base;
+}
+
+template <typename T, typename A, typename U, typename B>
+inline bool operator!=(const counting_allocator<T, A>& x,
+                       const counting_allocator<U, B>& y) {
+  return !(x == y);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __COUNTING_ALLOCATOR_HPP__ */
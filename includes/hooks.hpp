@@ -0,0 +1,189 @@
+#ifndef __HOOKS_HPP__
+#define __HOOKS_HPP__
+
+#include <cstddef>
+
+namespace ft {
+
+//!@{ Container Hooks //////////////////////////////////////////////////////////
+
+/*
+ * Hooks are a policy template parameter of rb_tree (and so map and set) and
+ * vector. Every hook is a static function called at the point where the
+ * event happens; null_hooks leaves them all empty, so the default
+ * instantiation compiles to exactly the code it had without hooks. A custom
+ * policy derives from null_hooks and hides the functions it cares about:
+ *
+ *   struct my_hooks : ft::null_hooks {
+ *     static void rotate_left(const void* node) { ... }
+ *   };
+ *   ft::map<int, int, std::less<int>,
+ *           std::allocator<ft::pair<const int, int> >, my_hooks> m;
+ */
+
+enum hook_event {
+  hook_rotate_left,
+  hook_rotate_right,
+  hook_recolor,
+  hook_insert_rebalance,
+  hook_erase_rebalance,
+  hook_node_allocate,
+  hook_node_deallocate,
+  hook_reallocate,
+  hook_num_events
+};
+
+inline const char* hook_event_name(hook_event e) {
+  static const char* names[hook_num_events] = {
+    "rotate_left",      "rotate_right",    "recolor",
+    "insert_rebalance", "erase_rebalance", "node_allocate",
+    "node_deallocate",  "reallocate",
+  };
+  return names[e];
+}
+
+struct null_hooks {
+  // rb_tree: rotation around node
+  static void rotate_left(const void*) { }
+  static void rotate_right(const void*) { }
+  // rb_tree: a rebalancing step changed the color of node
+  static void recolor(const void*) { }
+  // rb_tree: fix-up after linking in, or before unlinking, node
+  static void insert_rebalance(const void*) { }
+  static void erase_rebalance(const void*) { }
+  // rb_tree: node storage obtained from / returned to the allocator
+  static void node_allocate(const void*, size_t) { }
+  static void node_deallocate(const void*, size_t) { }
+  // vector: storage moved from old_start to new_start (sizes in bytes)
+  static void reallocate(const void*, size_t, const void*, size_t) { }
+};
+
+/**
+ * @brief Event totals of a counting_hooks policy.
+ */
+struct hook_counters {
+  size_t events[hook_num_events];
+  size_t node_bytes;        // live bytes of rb_tree nodes
+  size_t reallocated_bytes; // sum of the new capacities of vector regrowth
+};
+
+/**
+ * @brief Counts every event. Counters are global per Tag and not
+ * synchronized; use a distinct Tag to count one container (or one thread)
+ * separately from the others.
+ */
+template <typename Tag = void>
+struct counting_hooks {
+  static hook_counters& counters() {
+    static hook_counters c = hook_counters();
+    return c;
+  }
+
+  static void reset() { counters() = hook_counters(); }
+
+  static void rotate_left(const void*) {
+    ++counters().events[hook_rotate_left];
+  }
+  static void rotate_right(const void*) {
+    ++counters().events[hook_rotate_right];
+  }
+  static void recolor(const void*) { ++counters().events[hook_recolor]; }
+  static void insert_rebalance(const void*) {
+    ++counters().events[hook_insert_rebalance];
+  }
+  static void erase_rebalance(const void*) {
+    ++counters().events[hook_erase_rebalance];
+  }
+  static void node_allocate(const void*, size_t bytes) {
+    ++counters().events[hook_node_allocate];
+    counters().node_bytes += bytes;
+  }
+  static void node_deallocate(const void*, size_t bytes) {
+    ++counters().events[hook_node_deallocate];
+    counters().node_bytes -= bytes;
+  }
+  static void reallocate(const void*, size_t, const void*, size_t bytes) {
+    ++counters().events[hook_reallocate];
+    counters().reallocated_bytes += bytes;
+  }
+};
+
+struct hook_record {
+  size_t      seq; // position in the stream of all events
+  hook_event  event;
+  const void* node;  // node or, for reallocate, the old storage
+  const void* other; // new storage for reallocate
+  size_t      bytes; // node size or new capacity in bytes
+};
+
+/**
+ * @brief Keeps the last Capacity events in a ring buffer, overwriting the
+ * oldest ones, for post-mortem inspection of what a container just did.
+ * Global per Tag and not synchronized.
+ */
+template <size_t Capacity = 4096, typename Tag = void>
+struct trace_ring_hooks {
+  struct ring {
+    hook_record records[Capacity];
+    size_t      total;
+  };
+
+  static ring& buffer() {
+    static ring r;
+    return r;
+  }
+
+  static void clear() { buffer().total = 0; }
+
+  // events ever recorded, including the overwritten ones
+  static size_t total() { return buffer().total; }
+
+  static size_t size() {
+    return total() < Capacity ? total() : Capacity;
+  }
+
+  // i-th retained event, oldest first
+  static const hook_record& at(size_t i) {
+    ring& r = buffer();
+    return r.records[(r.total - size() + i) % Capacity];
+  }
+
+  static void push(hook_event e, const void* node, const void* other,
+                   size_t bytes) {
+    ring&        r = buffer();
+    hook_record& rec = r.records[r.total % Capacity];
+    rec.seq = r.total++;
+    rec.event = e;
+    rec.node = node;
+    rec.other = other;
+    rec.bytes = bytes;
+  }
+
+  static void rotate_left(const void* x) { push(hook_rotate_left, x, 0, 0); }
+  static void rotate_right(const void* x) {
+    push(hook_rotate_right, x, 0, 0);
+  }
+  static void recolor(const void* x) { push(hook_recolor, x, 0, 0); }
+  static void insert_rebalance(const void* x) {
+    push(hook_insert_rebalance, x, 0, 0);
+  }
+  static void erase_rebalance(const void* x) {
+    push(hook_erase_rebalance, x, 0, 0);
+  }
+  static void node_allocate(const void* x, size_t bytes) {
+    push(hook_node_allocate, x, 0, bytes);
+  }
+  static void node_deallocate(const void* x, size_t bytes) {
+    push(hook_node_deallocate, x, 0, bytes);
+  }
+  static void reallocate(const void* from, size_t, const void* to,
+                         size_t bytes) {
+    push(hook_reallocate, from, to, bytes);
+  }
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __HOOKS_HPP__ */
@@ -5,6 +5,8 @@
  * Iterator Base Classes
  */
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
 
 namespace ft {
@@ -219,9 +221,17 @@ operator+(typename reverse_iterator<Iterator>::difference_type __n,
 
 //!@}
 
+//!@{ Iterator Operations //////////////////////////////////////////////////////
+
+/*
+ * distance and advance dispatch on the iterator category: constant time
+ * for random access iterators (vector, pointers), a walk for the others.
+ * The tags are the std ones, so std iterators dispatch the same way.
+ */
+
 template <typename InputIterator>
 inline typename iterator_traits<InputIterator>::difference_type
-distance(InputIterator first, InputIterator last) {
+_distance(InputIterator first, InputIterator last, std::input_iterator_tag) {
   typename iterator_traits<InputIterator>::difference_type n = 0;
 
   while (first != last) {
@@ -231,6 +241,75 @@ distance(InputIterator first, InputIterator last) {
   return n;
 }
 
+template <typename RandomAccessIterator>
+inline typename iterator_traits<RandomAccessIterator>::difference_type
+_distance(RandomAccessIterator first, RandomAccessIterator last,
+          std::random_access_iterator_tag) {
+  return last - first;
+}
+
+/**
+ * @brief Number of increments from first to last. Consumes a single-pass
+ * (input) range.
+ */
+template <typename InputIterator>
+inline typename iterator_traits<InputIterator>::difference_type
+distance(InputIterator first, InputIterator last) {
+  return _distance(first, last,
+                   typename iterator_traits<InputIterator>::iterator_category());
+}
+
+template <typename InputIterator, typename Distance>
+inline void _advance(InputIterator& it, Distance n, std::input_iterator_tag) {
+  while (n-- > 0)
+    ++it;
+}
+
+template <typename BidirectionalIterator, typename Distance>
+inline void _advance(BidirectionalIterator& it, Distance n,
+                     std::bidirectional_iterator_tag) {
+  if (n > 0)
+    while (n--)
+      ++it;
+  else
+    while (n++)
+      --it;
+}
+
+template <typename RandomAccessIterator, typename Distance>
+inline void _advance(RandomAccessIterator& it, Distance n,
+                     std::random_access_iterator_tag) {
+  it += n;
+}
+
+/**
+ * @brief Moves it by n positions; n may be negative for bidirectional
+ * iterators.
+ */
+template <typename InputIterator, typename Distance>
+inline void advance(InputIterator& it, Distance n) {
+  _advance(it, n,
+           typename iterator_traits<InputIterator>::iterator_category());
+}
+
+template <typename InputIterator>
+inline InputIterator
+next(InputIterator it,
+     typename iterator_traits<InputIterator>::difference_type n = 1) {
+  ft::advance(it, n);
+  return it;
+}
+
+template <typename BidirectionalIterator>
+inline BidirectionalIterator
+prev(BidirectionalIterator it,
+     typename iterator_traits<BidirectionalIterator>::difference_type n = 1) {
+  ft::advance(it, -n);
+  return it;
+}
+
+//!@}
+
 } /* namespace ft */
 
 #endif /* __ITERATOR_HPP__ */
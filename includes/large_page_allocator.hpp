@@ -0,0 +1,187 @@
+#ifndef __LARGE_PAGE_ALLOCATOR_HPP__
+#define __LARGE_PAGE_ALLOCATOR_HPP__
+
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "type_traits.hpp"
+
+namespace ft {
+
+//!@{ Large Pages //////////////////////////////////////////////////////////////
+
+/**
+ * @brief Blocks of at least large_page_size bytes mapped straight from the
+ * kernel, with transparent huge pages requested for them.
+ *
+ * A block is an anonymous mapping aligned on a huge page boundary, so that
+ * the kernel can back it with 2 MiB pages: one TLB entry then covers what
+ * takes 512 with 4 KiB pages, which is what dominates random access to a
+ * large array. Smaller blocks come from operator new. Whether a block is
+ * mapped depends only on its size, so deallocate and reallocate need no
+ * header.
+ *
+ * reallocate resizes a mapped block with mremap: the kernel moves the page
+ * table entries, the bytes are never copied and the old and new blocks are
+ * never both resident.
+ */
+class large_pages {
+public:
+  static const size_t large_page_size = size_t(2) << 20; // x86-64 PMD size
+
+  static void* allocate(size_t bytes) {
+    if (bytes < large_page_size)
+      return ::operator new(bytes);
+    size_t length = _round(bytes);
+    // map one huge page more than needed and trim it down to an aligned
+    // block
+    void* p = ::mmap(0, length + large_page_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      throw std::bad_alloc();
+    char* raw = static_cast<char*>(p);
+    char* start = reinterpret_cast<char*>(
+        (reinterpret_cast<size_t>(raw) + large_page_size - 1) &
+        ~(large_page_size - 1));
+    if (start != raw)
+      ::munmap(raw, size_t(start - raw));
+    ::munmap(start + length, large_page_size - size_t(start - raw));
+    _advise(start, length);
+    return start;
+  }
+
+  static void deallocate(void* p, size_t bytes) {
+    if (bytes < large_page_size)
+      ::operator delete(p);
+    else
+      ::munmap(p, _round(bytes));
+  }
+
+  /**
+   * @brief Resizes the mapped block p of old_bytes to new_bytes, moving it
+   * if it cannot grow where it is. The contents move as raw bytes.
+   * @return the block, or 0, leaving p alone, when either size is below
+   * large_page_size or the kernel refuses
+   */
+  static void* reallocate(void* p, size_t old_bytes, size_t new_bytes) {
+#ifdef MREMAP_MAYMOVE
+    if (old_bytes < large_page_size || new_bytes < large_page_size)
+      return 0;
+    size_t length = _round(new_bytes);
+    void*  q = ::mremap(p, _round(old_bytes), length, MREMAP_MAYMOVE);
+    if (q == MAP_FAILED)
+      return 0;
+    _advise(q, length);
+    return q;
+#else
+    (void)p;
+    (void)old_bytes;
+    (void)new_bytes;
+    return 0;
+#endif
+  }
+
+private:
+  static size_t _round(size_t bytes) {
+    static const size_t page = size_t(::sysconf(_SC_PAGESIZE));
+    return (bytes + page - 1) & ~(page - 1);
+  }
+
+  static void _advise(void* p, size_t length) {
+#ifdef MADV_HUGEPAGE
+    ::madvise(p, length, MADV_HUGEPAGE); // only advice: ignore a refusal
+#else
+    (void)p;
+    (void)length;
+#endif
+  }
+};
+
+//!@}
+
+//!@{ Large Page Allocator /////////////////////////////////////////////////////
+
+/**
+ * @brief std::allocator compatible front end of large_pages, for vectors
+ * that grow into the gigabytes:
+ *
+ *     ft::vector<Buffer, ft::large_page_allocator<Buffer> > v;
+ *
+ * ft::vector of a trivially copyable T grows a mapped block in place with
+ * reallocate() instead of allocating, copying and freeing. Stateless.
+ */
+template <typename T>
+class large_page_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef large_page_allocator<U> other;
+  };
+
+  large_page_allocator() { }
+
+  template <typename U>
+  large_page_allocator(const large_page_allocator<U>&) { }
+
+  pointer allocate(size_type n, const void* = 0) {
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<pointer>(large_pages::allocate(n * sizeof(T)));
+  }
+
+  void deallocate(pointer p, size_type n) {
+    large_pages::deallocate(p, n * sizeof(T));
+  }
+
+  /**
+   * @brief Resizes the block p of old_n elements to new_n, moving the
+   * elements as raw bytes: only for trivially copyable T.
+   * @return the block, or 0, leaving p alone, when it cannot be resized
+   */
+  pointer reallocate(pointer p, size_type old_n, size_type new_n) {
+    if (new_n > max_size())
+      return 0;
+    return static_cast<pointer>(
+        large_pages::reallocate(p, old_n * sizeof(T), new_n * sizeof(T)));
+  }
+
+  void construct(pointer p, const T& v) { new (static_cast<void*>(p)) T(v); }
+  void destroy(pointer p) { p->~T(); }
+
+  pointer       address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+
+  size_type max_size() const { return size_type(-1) / 2 / sizeof(T); }
+};
+
+template <typename T, typename U>
+inline bool operator==(const large_page_allocator<T>&,
+                       const large_page_allocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const large_page_allocator<T>&,
+                       const large_page_allocator<U>&) {
+  return false;
+}
+
+template <typename T>
+struct is_reallocating_allocator<large_page_allocator<T> > {
+  static const bool value = true;
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __LARGE_PAGE_ALLOCATOR_HPP__ */
@@ -1,7 +1,9 @@
 #ifndef __MAP_HPP__
 #define __MAP_HPP__
 
+#include <functional>
 #include <memory>
+#include <stdexcept>
 #include "rb_tree.hpp"
 #include "function.hpp"
 #include "pair.hpp"
@@ -10,7 +12,8 @@ namespace ft
 {
 
 template <typename Key, typename T, typename Compare = std::less<Key>,
-          typename Alloc = std::allocator<pair<const Key, T> > >
+          typename Alloc = std::allocator<pair<const Key, T> >,
+          typename Hooks = null_hooks>
 class map {
 
 public:
@@ -21,7 +24,7 @@ public:
 
 private:
   typedef rb_tree<key_type, value_type, _Select1st<value_type>,
-                   key_compare, Alloc>              rep_type;
+                   key_compare, Alloc, Hooks>       rep_type;
 
   rep_type                                          _tree;
 
@@ -42,7 +45,7 @@ public:
 
   class value_compare 
   : public std::binary_function<value_type, value_type, bool> {
-    friend class map<Key, T, Compare, Alloc>;
+    friend class map<Key, T, Compare, Alloc, Hooks>;
 
   protected:
     Compare comp;
@@ -112,17 +115,17 @@ public:
   //!@{ Element access /////////////////////////////////////////////////////////
  
   mapped_type& at(const key_type& k) {
-    iterator i = lower_bound(k);
+    iterator i = _tree.find(k);
 
-    if (i == end() || key_comp()(k, i->first))
+    if (i == end())
       throw std::out_of_range("ft::map::at");
     return i->second;
   }
 
   const mapped_type& at(const key_type& k) const {
-    const_iterator i = lower_bound(k);
+    const_iterator i = _tree.find(k);
 
-    if (i == end() || key_comp()(k, i->first))
+    if (i == end())
       throw std::out_of_range("ft::map::at");
     return i->second;
   }
@@ -154,6 +157,18 @@ public:
     _tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Replaces the contents with the n elements read from first, which
+   * must be sorted by strictly increasing key. The tree is built directly in
+   * O(n), without searching or rebalancing; see rb_tree.
+   * @throw std::invalid_argument when the keys are out of order, leaving
+   * the map unchanged
+   */
+  template <typename InputIterator>
+  void assign_sorted(InputIterator first, size_type n) {
+    _tree.assign_sorted_unique(first, n);
+  }
+
   void erase (iterator position) {
     _tree.erase(position);
   }
@@ -216,58 +231,130 @@ public:
   pair<const_iterator, const_iterator> equal_range(const key_type& x) const {
     return _tree.equal_range(x);
   }
+
+  //!@}
+
+  //!@{ Lookup filter //////////////////////////////////////////////////////////
+
+  /**
+   * @brief Keeps a Bloom filter alongside the tree so that find(), count() and
+   * at() answer definite misses without walking the tree. See rb_tree.
+   * @return false if key_type has no ft::bloom_hash specialization, or
+   * Compare is not std::less or std::greater
+   */
+  bool enable_bloom_filter(size_type bits_per_key = 10) {
+    return _tree.enable_bloom_filter(bits_per_key);
+  }
+
+  /**
+   * @brief Same, for any Compare: hash must give the same value to keys
+   * that Compare finds equivalent.
+   */
+  bool enable_bloom_filter(size_t (*hash)(const key_type&),
+                           size_type bits_per_key = 10) {
+    return _tree.enable_bloom_filter(hash, bits_per_key);
+  }
+
+  void disable_bloom_filter() { _tree.disable_bloom_filter(); }
+
+  bloom_filter_stats bloom_stats() const { return _tree.bloom_stats(); }
+
+  //!@}
+
+  //!@{ Memory Introspection ///////////////////////////////////////////////////
+
+  /**
+   * @brief Payload and structural overhead in bytes, and live allocations.
+   * Cheap (O(1)) enough to export periodically.
+   */
+  memory_stats memory_usage() const { return _tree.memory_usage(); }
+
+  /**
+   * @brief Height, black height and average depth of the underlying tree.
+   * Walks every node: O(n).
+   */
+  tree_shape shape() const { return _tree.shape(); }
+
+  //!@}
+
+  //!@{ Partitioning ///////////////////////////////////////////////////////////
+
+  typedef ft::pair<iterator, iterator>             range_type;
+  typedef ft::pair<const_iterator, const_iterator> const_range_type;
+
+  /**
+   * @brief At most k consecutive ranges of about equal size covering the
+   * map in order, cut from the top levels of the tree in O(k log n);
+   * the parallel for_each and reduce of parallel_algorithm.hpp walk one per
+   * task.
+   */
+  ft::vector<range_type> split_ranges(size_type k) {
+    return _tree.split_ranges(k);
+  }
+
+  ft::vector<const_range_type> split_ranges(size_type k) const {
+    return _tree.split_ranges(k);
+  }
+
   //!@}
 
-  template <typename K1, typename T1, typename C1, typename A1>
-  friend bool operator==(const map<K1, T1, C1, A1>&,
-                         const map<K1, T1, C1, A1>&);
+  template <typename K1, typename T1, typename C1, typename A1, typename H1>
+  friend bool operator==(const map<K1, T1, C1, A1, H1>&,
+                         const map<K1, T1, C1, A1, H1>&);
 
-  template <typename K1, typename T1, typename C1, typename A1>
-  friend bool operator<(const map<K1, T1, C1, A1>&,
-                        const map<K1, T1, C1, A1>&);
+  template <typename K1, typename T1, typename C1, typename A1, typename H1>
+  friend bool operator<(const map<K1, T1, C1, A1, H1>&,
+                        const map<K1, T1, C1, A1, H1>&);
 }; // map
 
 //!@{ Non-member functions /////////////////////////////////////////////////////
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator==(const map<Key, Tp, Compare, Alloc>& x,
-                       const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator==(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                       const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return x._tree == y._tree;
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator<(const map<Key, Tp, Compare, Alloc>& x,
-                      const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator<(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                      const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return x._tree < y._tree;
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator!=(const map<Key, Tp, Compare, Alloc>& x,
-                       const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator!=(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                       const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return !(x == y);
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator>(const map<Key, Tp, Compare, Alloc>& x,
-                      const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator>(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                      const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return y < x;
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator<=(const map<Key, Tp, Compare, Alloc>& x,
-                       const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator<=(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                       const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return !(y < x);
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline bool operator>=(const map<Key, Tp, Compare, Alloc>& x,
-                       const map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline bool operator>=(const map<Key, Tp, Compare, Alloc, Hooks>& x,
+                       const map<Key, Tp, Compare, Alloc, Hooks>& y) {
   return !(x < y);
 }
 
-template <typename Key, typename Tp, typename Compare, typename Alloc>
-inline void swap(map<Key, Tp, Compare, Alloc>& x,
-                 map<Key, Tp, Compare, Alloc>& y) {
+template <typename Key, typename Tp, typename Compare, typename Alloc,
+          typename Hooks>
+inline void swap(map<Key, Tp, Compare, Alloc, Hooks>& x,
+                 map<Key, Tp, Compare, Alloc, Hooks>& y) {
   x.swap(y);
 }
 
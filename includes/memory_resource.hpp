@@ -0,0 +1,513 @@
+#ifndef __MEMORY_RESOURCE_HPP__
+#define __MEMORY_RESOURCE_HPP__
+
+#include <cstddef>
+#include <new>
+#include <pthread.h>
+#include "arena.hpp"
+#include "type_traits.hpp"
+
+namespace ft {
+
+//!@{ Memory Resource //////////////////////////////////////////////////////////
+
+/**
+ * @brief C++98 take on std::pmr::memory_resource: an abstract, runtime
+ * selectable source of raw memory. Containers reach it through
+ * polymorphic_allocator, so the strategy becomes a property of the instance
+ * instead of its type.
+ */
+class memory_resource {
+public:
+  static const size_t max_align = 16;
+
+  virtual ~memory_resource() { }
+
+  void* allocate(size_t bytes, size_t align = max_align) {
+    return do_allocate(bytes, align);
+  }
+
+  void deallocate(void* p, size_t bytes, size_t align = max_align) {
+    do_deallocate(p, bytes, align);
+  }
+
+  bool is_equal(const memory_resource& other) const {
+    return do_is_equal(other);
+  }
+
+protected:
+  virtual void* do_allocate(size_t bytes, size_t align) = 0;
+  virtual void  do_deallocate(void* p, size_t bytes, size_t align) = 0;
+  virtual bool  do_is_equal(const memory_resource& other) const {
+    return this == &other;
+  }
+};
+
+inline bool operator==(const memory_resource& a, const memory_resource& b) {
+  return &a == &b || a.is_equal(b);
+}
+
+inline bool operator!=(const memory_resource& a, const memory_resource& b) {
+  return !(a == b);
+}
+
+/**
+ * @brief Forwards to global operator new/delete. Alignments above what
+ * operator new guarantees are handled by over-allocating and stashing the
+ * original pointer in front of the block.
+ */
+class new_delete_memory_resource : public memory_resource {
+protected:
+  void* do_allocate(size_t bytes, size_t align) {
+    if (align <= max_align)
+      return ::operator new(bytes);
+    char* raw = static_cast<char*>(::operator new(bytes + align));
+    char* p = raw + align - (reinterpret_cast<size_t>(raw) & (align - 1));
+    reinterpret_cast<void**>(p)[-1] = raw;
+    return p;
+  }
+
+  void do_deallocate(void* p, size_t, size_t align) {
+    if (align <= max_align)
+      ::operator delete(p);
+    else
+      ::operator delete(static_cast<void**>(p)[-1]);
+  }
+
+  bool do_is_equal(const memory_resource& other) const {
+    return dynamic_cast<const new_delete_memory_resource*>(&other) != 0;
+  }
+};
+
+/**
+ * @brief Refuses every allocation. Useful as the upstream of a buffer
+ * resource that must never spill to the heap.
+ */
+class null_memory_resource_type : public memory_resource {
+protected:
+  void* do_allocate(size_t, size_t) { throw std::bad_alloc(); }
+  void  do_deallocate(void*, size_t, size_t) { }
+};
+
+inline memory_resource* new_delete_resource() {
+  static new_delete_memory_resource r;
+  return &r;
+}
+
+inline memory_resource* null_memory_resource() {
+  static null_memory_resource_type r;
+  return &r;
+}
+
+inline memory_resource*& default_resource_slot() {
+  static memory_resource* r = new_delete_resource();
+  return r;
+}
+
+inline memory_resource* get_default_resource() {
+  return default_resource_slot();
+}
+
+/**
+ * @brief Sets the resource used by default-constructed polymorphic_allocators.
+ * Passing null restores new_delete_resource().
+ * @return the previous default
+ */
+inline memory_resource* set_default_resource(memory_resource* r) {
+  memory_resource* old = default_resource_slot();
+  default_resource_slot() = r ? r : new_delete_resource();
+  return old;
+}
+
+//!@}
+
+//!@{ Monotonic Buffer Resource ////////////////////////////////////////////////
+
+/**
+ * @brief memory_resource view of a monotonic_arena: allocation bumps a
+ * pointer, deallocation is a no-op and release() returns everything at once.
+ */
+class monotonic_buffer_resource : public memory_resource {
+  monotonic_arena _arena;
+
+public:
+  explicit monotonic_buffer_resource(size_t initial_size = 4096)
+  : _arena(initial_size) { }
+
+  monotonic_buffer_resource(void* buffer, size_t size)
+  : _arena(buffer, size) { }
+
+  void release() { _arena.release(); }
+
+  size_t bytes_used() const { return _arena.bytes_used(); }
+
+protected:
+  void* do_allocate(size_t bytes, size_t align) {
+    return _arena.allocate(bytes, align);
+  }
+
+  void do_deallocate(void*, size_t, size_t) { }
+
+private:
+  monotonic_buffer_resource(const monotonic_buffer_resource&);
+  monotonic_buffer_resource& operator=(const monotonic_buffer_resource&);
+};
+
+//!@}
+
+//!@{ Pool Resources ///////////////////////////////////////////////////////////
+
+struct pool_options {
+  size_t max_blocks_per_chunk;        // 0 means implementation default
+  size_t largest_required_pool_block; // 0 means implementation default
+
+  pool_options() : max_blocks_per_chunk(0), largest_required_pool_block(0) { }
+};
+
+/**
+ * @brief Segregated free lists, one per power-of-two block size. Blocks are
+ * carved out of chunks obtained from the upstream resource; chunks grow
+ * geometrically up to max_blocks_per_chunk. Requests larger than the largest
+ * pool block (or over-aligned ones) go straight to upstream but are still
+ * tracked so that release() frees them.
+ *
+ * Not thread-safe; see synchronized_pool_resource.
+ */
+class unsynchronized_pool_resource : public memory_resource {
+  struct free_block {
+    free_block* next;
+  };
+
+  struct chunk_header {
+    chunk_header* next;
+    size_t        bytes;
+  };
+
+  struct large_header {
+    large_header* prev;
+    large_header* next;
+    size_t        bytes;
+    size_t        align;
+  };
+
+  struct pool {
+    free_block*   free;
+    char*         bump;
+    char*         bump_end;
+    chunk_header* chunks;
+    size_t        block_size;
+    size_t        next_blocks;
+  };
+
+  static const size_t min_block = sizeof(void*) < 8 ? 8 : sizeof(void*);
+  static const size_t max_pools = 24;
+
+  memory_resource* _upstream;
+  pool_options     _options;
+  pool             _pools[max_pools];
+  size_t           _num_pools;
+  large_header*    _large;
+
+public:
+  explicit unsynchronized_pool_resource(
+      const pool_options& opts = pool_options(),
+      memory_resource*    upstream = get_default_resource())
+  : _upstream(upstream), _options(opts), _num_pools(0), _large(0) {
+    _init_pools();
+  }
+
+  explicit unsynchronized_pool_resource(memory_resource* upstream)
+  : _upstream(upstream), _options(), _num_pools(0), _large(0) {
+    _init_pools();
+  }
+
+  ~unsynchronized_pool_resource() { release(); }
+
+  /**
+   * @brief Returns every chunk and large block to upstream, even if they are
+   * still in use.
+   */
+  void release() {
+    for (size_t i = 0; i < _num_pools; ++i) {
+      pool& p = _pools[i];
+      while (p.chunks) {
+        chunk_header* next = p.chunks->next;
+        _upstream->deallocate(p.chunks, p.chunks->bytes);
+        p.chunks = next;
+      }
+      _init_pool(p, p.block_size);
+    }
+    while (_large) {
+      large_header* next = _large->next;
+      _upstream->deallocate(_large, _large->bytes, _large->align);
+      _large = next;
+    }
+  }
+
+  memory_resource* upstream_resource() const { return _upstream; }
+  pool_options     options() const { return _options; }
+
+protected:
+  void* do_allocate(size_t bytes, size_t align) {
+    pool* p = _pool_for(bytes, align);
+    if (p == 0)
+      return _allocate_large(bytes, align);
+    if (p->free) {
+      free_block* b = p->free;
+      p->free = b->next;
+      return b;
+    }
+    if (p->bump == p->bump_end)
+      _refill(*p);
+    void* r = p->bump;
+    p->bump += p->block_size;
+    return r;
+  }
+
+  void do_deallocate(void* ptr, size_t bytes, size_t align) {
+    if (ptr == 0)
+      return;
+    pool* p = _pool_for(bytes, align);
+    if (p == 0) {
+      _deallocate_large(ptr);
+      return;
+    }
+    free_block* b = static_cast<free_block*>(ptr);
+    b->next = p->free;
+    p->free = b;
+  }
+
+private:
+  unsynchronized_pool_resource(const unsynchronized_pool_resource&);
+  unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&);
+
+  void _init_pools() {
+    if (_options.max_blocks_per_chunk == 0)
+      _options.max_blocks_per_chunk = 1024;
+    if (_options.largest_required_pool_block == 0)
+      _options.largest_required_pool_block = 512;
+    size_t block = min_block;
+    while (block < _options.largest_required_pool_block &&
+           _num_pools < max_pools - 1) {
+      _init_pool(_pools[_num_pools++], block);
+      block <<= 1;
+    }
+    _init_pool(_pools[_num_pools++], block);
+    _options.largest_required_pool_block = block;
+  }
+
+  static void _init_pool(pool& p, size_t block_size) {
+    p.free = 0;
+    p.bump = 0;
+    p.bump_end = 0;
+    p.chunks = 0;
+    p.block_size = block_size;
+    p.next_blocks = 16;
+  }
+
+  pool* _pool_for(size_t bytes, size_t align) {
+    if (align > max_align)
+      return 0;
+    size_t need = bytes < align ? align : bytes;
+    for (size_t i = 0; i < _num_pools; ++i)
+      if (need <= _pools[i].block_size)
+        return &_pools[i];
+    return 0;
+  }
+
+  void _refill(pool& p) {
+    size_t blocks = p.next_blocks;
+    if (blocks > _options.max_blocks_per_chunk)
+      blocks = _options.max_blocks_per_chunk;
+    size_t header = (sizeof(chunk_header) + max_align - 1) & ~(max_align - 1);
+    size_t bytes = header + blocks * p.block_size;
+
+    chunk_header* c = static_cast<chunk_header*>(_upstream->allocate(bytes));
+    c->next = p.chunks;
+    c->bytes = bytes;
+    p.chunks = c;
+    p.bump = reinterpret_cast<char*>(c) + header;
+    p.bump_end = p.bump + blocks * p.block_size;
+    if (p.next_blocks < _options.max_blocks_per_chunk)
+      p.next_blocks *= 2;
+  }
+
+  // header, then the offset back to it, then the payload
+  static size_t _large_offset(size_t align) {
+    size_t a = align < max_align ? max_align : align;
+    return (sizeof(large_header) + sizeof(size_t) + a - 1) & ~(a - 1);
+  }
+
+  void* _allocate_large(size_t bytes, size_t align) {
+    size_t offset = _large_offset(align);
+    size_t a = align < max_align ? max_align : align;
+    char*  raw = static_cast<char*>(_upstream->allocate(bytes + offset, a));
+    large_header* h = reinterpret_cast<large_header*>(raw);
+    h->prev = 0;
+    h->next = _large;
+    h->bytes = bytes + offset;
+    h->align = a;
+    if (_large)
+      _large->prev = h;
+    _large = h;
+    // remember where the header is, right in front of the payload
+    reinterpret_cast<size_t*>(raw + offset)[-1] = offset;
+    return raw + offset;
+  }
+
+  void _deallocate_large(void* ptr) {
+    size_t        offset = static_cast<size_t*>(ptr)[-1];
+    large_header* h =
+        reinterpret_cast<large_header*>(static_cast<char*>(ptr) - offset);
+    if (h->prev)
+      h->prev->next = h->next;
+    else
+      _large = h->next;
+    if (h->next)
+      h->next->prev = h->prev;
+    _upstream->deallocate(h, h->bytes, h->align);
+  }
+};
+
+/**
+ * @brief unsynchronized_pool_resource behind a mutex, for containers shared
+ * between threads or resources shared by containers on different threads.
+ */
+class synchronized_pool_resource : public memory_resource {
+  unsynchronized_pool_resource _pool;
+  mutable pthread_mutex_t      _mutex;
+
+  class lock_guard {
+    pthread_mutex_t& _m;
+
+  public:
+    explicit lock_guard(pthread_mutex_t& m) : _m(m) { pthread_mutex_lock(&_m); }
+    ~lock_guard() { pthread_mutex_unlock(&_m); }
+  };
+
+public:
+  explicit synchronized_pool_resource(
+      const pool_options& opts = pool_options(),
+      memory_resource*    upstream = get_default_resource())
+  : _pool(opts, upstream) {
+    pthread_mutex_init(&_mutex, 0);
+  }
+
+  explicit synchronized_pool_resource(memory_resource* upstream)
+  : _pool(pool_options(), upstream) {
+    pthread_mutex_init(&_mutex, 0);
+  }
+
+  ~synchronized_pool_resource() { pthread_mutex_destroy(&_mutex); }
+
+  void release() {
+    lock_guard lock(_mutex);
+    _pool.release();
+  }
+
+  memory_resource* upstream_resource() const {
+    return _pool.upstream_resource();
+  }
+
+  pool_options options() const { return _pool.options(); }
+
+protected:
+  void* do_allocate(size_t bytes, size_t align) {
+    lock_guard lock(_mutex);
+    return _pool.allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) {
+    lock_guard lock(_mutex);
+    _pool.deallocate(p, bytes, align);
+  }
+
+private:
+  synchronized_pool_resource(const synchronized_pool_resource&);
+  synchronized_pool_resource& operator=(const synchronized_pool_resource&);
+};
+
+//!@}
+
+//!@{ Polymorphic Allocator ////////////////////////////////////////////////////
+
+/**
+ * @brief Allocator that forwards to a memory_resource chosen at run time.
+ * Rebinding keeps the resource, so rb_tree nodes and vector buffers come
+ * from the resource the container was constructed with:
+ *
+ *     ft::unsynchronized_pool_resource pool;
+ *     ft::map<int, int, std::less<int>,
+ *             ft::polymorphic_allocator<ft::pair<const int, int> > >
+ *         m(std::less<int>(), &pool);
+ *
+ * Copies of a container keep using the same resource.
+ */
+template <typename T>
+class polymorphic_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef polymorphic_allocator<U> other;
+  };
+
+private:
+  memory_resource* _resource;
+
+public:
+  polymorphic_allocator() : _resource(get_default_resource()) { }
+
+  polymorphic_allocator(memory_resource* r)
+  : _resource(r ? r : get_default_resource()) { }
+
+  template <typename U>
+  polymorphic_allocator(const polymorphic_allocator<U>& x)
+  : _resource(x.resource()) { }
+
+  pointer allocate(size_type n, const void* = 0) {
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<pointer>(
+        _resource->allocate(n * sizeof(T), alignment_of<T>::value));
+  }
+
+  void deallocate(pointer p, size_type n) {
+    _resource->deallocate(p, n * sizeof(T), alignment_of<T>::value);
+  }
+
+  void construct(pointer p, const T& v) { new (static_cast<void*>(p)) T(v); }
+  void destroy(pointer p) { p->~T(); }
+
+  pointer       address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+
+  size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+  memory_resource* resource() const { return _resource; }
+};
+
+template <typename T, typename U>
+inline bool operator==(const polymorphic_allocator<T>& x,
+                       const polymorphic_allocator<U>& y) {
+  return *x.resource() == *y.resource();
+}
+
+template <typename T, typename U>
+inline bool operator!=(const polymorphic_allocator<T>& x,
+                       const polymorphic_allocator<U>& y) {
+  return !(x == y);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __MEMORY_RESOURCE_HPP__ */
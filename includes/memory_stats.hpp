@@ -0,0 +1,46 @@
+#ifndef __MEMORY_STATS_HPP__
+#define __MEMORY_STATS_HPP__
+
+#include <cstddef>
+
+namespace ft {
+
+//!@{ Memory Introspection /////////////////////////////////////////////////////
+
+/**
+ * @brief Heap memory held by a container, as returned by memory_usage().
+ * Computed from sizes and counters in O(1); the container object itself
+ * (sizeof) is not included.
+ */
+struct memory_stats {
+  size_t payload_bytes;  // size() * sizeof(value_type)
+  size_t overhead_bytes; // node headers, unused capacity, auxiliary indexes
+  size_t allocations;    // live heap blocks owned by the container
+
+  size_t total_bytes() const { return payload_bytes + overhead_bytes; }
+
+  /**
+   * @brief Share of the held bytes that is not payload: 0 for a full vector,
+   * about 0.9 for a map of ints.
+   */
+  double overhead_ratio() const {
+    return total_bytes() == 0 ? 0.0 : double(overhead_bytes) / total_bytes();
+  }
+};
+
+/**
+ * @brief Shape of a red-black tree, as returned by map/set shape(). Depths
+ * count nodes, so the root is at depth 1 and height is the largest depth.
+ * Needs a walk over every node, O(n) without allocation.
+ */
+struct tree_shape {
+  size_t height;        // nodes on the longest root-to-leaf path
+  size_t black_height;  // black nodes on any root-to-leaf path
+  double average_depth; // mean depth over all nodes, i.e. cost of a hit
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __MEMORY_STATS_HPP__ */
@@ -0,0 +1,353 @@
+#ifndef __MMAP_VECTOR_HPP__
+#define __MMAP_VECTOR_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "type_traits.hpp"
+
+namespace ft {
+
+//!@{ mmap_vector File Format //////////////////////////////////////////////////
+
+/*
+ * File layout: a 64 byte header, then the elements as raw bytes.
+ *
+ *   header  "FTMV", version (4 bytes), sizeof(T) and element count (8 bytes
+ *           each), in host byte order; the rest is zero
+ *   data    capacity elements, of which the first count are live
+ *
+ * The file is only readable on a machine with the same byte order and
+ * layout of T as the one that wrote it.
+ */
+
+enum mmap_mode {
+  mmap_read_write, // open the file, creating it when missing
+  mmap_truncate,   // create the file, or empty an existing one
+  mmap_read_only   // map an existing file copy-on-write; the file never
+                   // changes
+};
+
+const unsigned mmap_vector_version = 1;
+
+//!@}
+
+/**
+ * @brief Vector of trivially copyable T stored in a memory-mapped file.
+ *
+ * Opening maps the file and returns at once: nothing is read or copied, and
+ * pages fault in as elements are touched, so a large dataset is available
+ * immediately at the next start. In read-write mode every change goes
+ * straight to the file; growing extends it with ftruncate and remaps it
+ * with mremap, which moves the mapping without copying its pages. The
+ * destructor trims the file to the live elements.
+ *
+ * In read-only mode the mapping is private: writes to elements, and size
+ * changes within the mapped file, stay in the process. Growing beyond the
+ * file throws std::logic_error.
+ *
+ * T must be trivially copyable, as the elements are raw file bytes.
+ * Errors from the system throw std::runtime_error. Not copyable.
+ */
+template <typename T>
+class mmap_vector {
+public:
+  typedef T                  value_type;
+  typedef size_t             size_type;
+  typedef ptrdiff_t          difference_type;
+  typedef value_type&        reference;
+  typedef const value_type&  const_reference;
+  typedef value_type*        pointer;
+  typedef const value_type*  const_pointer;
+  typedef pointer            iterator;
+  typedef const_pointer      const_iterator;
+
+  static const size_t header_size = 64;
+
+private:
+  // fails to compile for other types
+  typedef char _requires_trivially_copyable
+      [is_trivially_copyable<T>::value ? 1 : -1];
+
+  struct header {
+    char               magic[4];
+    unsigned           version;
+    unsigned long long element_size;
+    unsigned long long size;
+  };
+
+  std::string _path;
+  mmap_mode   _mode;
+  int         _fd;
+  char*       _map;
+  size_t      _map_bytes;
+  pointer     _data;
+  size_type   _size;
+  size_type   _capacity;
+
+public:
+  //!@{ construct/copy/destroy ///////////////////////////////////////////////
+
+  /**
+   * @throw std::runtime_error when the file cannot be opened, created or
+   * mapped, or is not an mmap_vector of T
+   */
+  explicit mmap_vector(const std::string& path,
+                       mmap_mode          mode = mmap_read_write)
+  : _path(path), _mode(mode), _fd(-1), _map(0), _map_bytes(0), _data(0),
+    _size(0), _capacity(0) {
+    int flags = mode == mmap_read_only ? O_RDONLY : O_RDWR | O_CREAT;
+    if (mode == mmap_truncate)
+      flags |= O_TRUNC;
+    _fd = ::open(path.c_str(), flags, 0644);
+    if (_fd < 0)
+      _fail_errno("cannot open");
+    struct stat st;
+    if (::fstat(_fd, &st) != 0)
+      _fail_errno("cannot stat");
+    size_t bytes = size_t(st.st_size);
+    bool   created = bytes == 0 && mode != mmap_read_only;
+    if (created) {
+      bytes = header_size;
+      if (::ftruncate(_fd, off_t(bytes)) != 0)
+        _fail_errno("cannot resize");
+    }
+    if (bytes < header_size)
+      _fail("not an mmap_vector file");
+    _map_file(bytes);
+    header* h = _header();
+    if (created) {
+      std::memcpy(h->magic, "FTMV", 4);
+      h->version = mmap_vector_version;
+      h->element_size = sizeof(T);
+      h->size = 0;
+    } else if (std::memcmp(h->magic, "FTMV", 4) != 0 ||
+               h->version != mmap_vector_version)
+      _fail("not an mmap_vector file");
+    else if (h->element_size != sizeof(T))
+      _fail("element size mismatch");
+    _capacity = (bytes - header_size) / sizeof(T);
+    if (h->size > _capacity)
+      _fail("truncated file");
+    _size = size_type(h->size);
+    if (mode == mmap_read_only)
+      _capacity = _size;
+  }
+
+  /**
+   * @brief Unmaps the file, after trimming it to the live elements in
+   * read-write mode.
+   */
+  ~mmap_vector() {
+    if (_mode != mmap_read_only) {
+      _header()->size = _size;
+      ::munmap(_map, _map_bytes);
+      if (::ftruncate(_fd, off_t(header_size + _size * sizeof(T))) != 0) {
+        // the slack stays in the file, which reopens fine
+      }
+    } else
+      ::munmap(_map, _map_bytes);
+    ::close(_fd);
+  }
+
+  //!@}
+
+  //!@{ Iterators ////////////////////////////////////////////////////////////
+
+  iterator       begin() { return _data; }
+  const_iterator begin() const { return _data; }
+  iterator       end() { return _data + _size; }
+  const_iterator end() const { return _data + _size; }
+
+  //!@}
+
+  //!@{ Capacity /////////////////////////////////////////////////////////////
+
+  size_type size() const { return _size; }
+  bool      empty() const { return _size == 0; }
+  size_type capacity() const { return _capacity; }
+
+  size_type max_size() const {
+    return (size_type(-1) / 2 - header_size) / sizeof(T);
+  }
+
+  // Whether the file was opened with mmap_read_only
+  bool read_only() const { return _mode == mmap_read_only; }
+
+  const std::string& path() const { return _path; }
+
+  /**
+   * @brief Extends the file so that it holds at least n elements.
+   */
+  void reserve(size_type n) {
+    if (n > _capacity)
+      _remap(n);
+  }
+
+  //!@}
+
+  //!@{ Element Access ///////////////////////////////////////////////////////
+
+  reference       operator[](size_type n) { return _data[n]; }
+  const_reference operator[](size_type n) const { return _data[n]; }
+
+  reference at(size_type n) {
+    if (n >= _size)
+      throw std::out_of_range("mmap_vector::at");
+    return _data[n];
+  }
+
+  const_reference at(size_type n) const {
+    if (n >= _size)
+      throw std::out_of_range("mmap_vector::at");
+    return _data[n];
+  }
+
+  reference       front() { return _data[0]; }
+  const_reference front() const { return _data[0]; }
+  reference       back() { return _data[_size - 1]; }
+  const_reference back() const { return _data[_size - 1]; }
+
+  pointer       data() { return _data; }
+  const_pointer data() const { return _data; }
+
+  //!@}
+
+  //!@{ Modifiers ////////////////////////////////////////////////////////////
+
+  void push_back(const value_type& x) {
+    if (_size == _capacity) {
+      value_type v = x; // x may live in the mapping about to move
+      _grow(_size + 1);
+      _data[_size] = v;
+    } else
+      _data[_size] = x;
+    _set_size(_size + 1);
+  }
+
+  void pop_back() { _set_size(_size - 1); }
+
+  /**
+   * @brief Appends the elements of [first, last), which must not point into
+   * this vector.
+   */
+  void append(const_pointer first, const_pointer last) {
+    size_type n = size_type(last - first);
+    if (n > _capacity - _size)
+      _grow(_size + n);
+    std::memcpy(static_cast<void*>(_data + _size), first, n * sizeof(T));
+    _set_size(_size + n);
+  }
+
+  void resize(size_type n, const value_type& v = value_type()) {
+    if (n > _capacity)
+      _grow(n);
+    for (size_type i = _size; i < n; ++i)
+      _data[i] = v;
+    _set_size(n);
+  }
+
+  void clear() { _set_size(0); }
+
+  /**
+   * @brief Writes the changes back to the file and waits for the disk.
+   * Nothing to do in read-only mode.
+   */
+  void sync() {
+    if (_mode == mmap_read_only)
+      return;
+    if (::msync(_map, _map_bytes, MS_SYNC) != 0)
+      _throw_errno("cannot sync");
+  }
+
+  //!@}
+
+private:
+  header* _header() const { return reinterpret_cast<header*>(_map); }
+
+  void _set_size(size_type n) {
+    _size = n;
+    _header()->size = n;
+  }
+
+  // grows to at least n elements, doubling the capacity
+  void _grow(size_type n) {
+    if (n > max_size())
+      throw std::length_error("mmap_vector");
+    size_type capacity = _capacity * 2;
+    if (capacity < n)
+      capacity = n;
+    if (capacity > max_size())
+      capacity = max_size();
+    _remap(capacity);
+  }
+
+  void _remap(size_type capacity) {
+    if (_mode == mmap_read_only)
+      throw std::logic_error("mmap_vector: cannot grow a read-only file");
+    size_t bytes = header_size + capacity * sizeof(T);
+    if (::ftruncate(_fd, off_t(bytes)) != 0)
+      _throw_errno("cannot resize");
+#ifdef MREMAP_MAYMOVE
+    void* p = ::mremap(_map, _map_bytes, bytes, MREMAP_MAYMOVE);
+    if (p == MAP_FAILED)
+      _throw_errno("cannot remap");
+#else
+    void* p = ::mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (p == MAP_FAILED)
+      _throw_errno("cannot map");
+    ::munmap(_map, _map_bytes);
+#endif
+    _map = static_cast<char*>(p);
+    _map_bytes = bytes;
+    _data = reinterpret_cast<pointer>(_map + header_size);
+    _capacity = capacity;
+  }
+
+  void _map_file(size_t bytes) {
+    int   flags = _mode == mmap_read_only ? MAP_PRIVATE : MAP_SHARED;
+    void* p = ::mmap(0, bytes, PROT_READ | PROT_WRITE, flags, _fd, 0);
+    if (p == MAP_FAILED)
+      _fail_errno("cannot map");
+    _map = static_cast<char*>(p);
+    _map_bytes = bytes;
+    _data = reinterpret_cast<pointer>(_map + header_size);
+  }
+
+  std::string _errno_message(const char* what) const {
+    return std::string("mmap_vector: ") + what + " " + _path + ": " +
+           std::strerror(errno);
+  }
+
+  void _throw_errno(const char* what) const {
+    throw std::runtime_error(_errno_message(what));
+  }
+
+  // clean up a half-built vector and throw
+  void _fail(const std::string& message) {
+    if (_map)
+      ::munmap(_map, _map_bytes);
+    if (_fd >= 0)
+      ::close(_fd);
+    throw std::runtime_error(message);
+  }
+
+  void _fail(const char* what) {
+    _fail(std::string("mmap_vector: ") + what + ": " + _path);
+  }
+
+  void _fail_errno(const char* what) { _fail(_errno_message(what)); }
+
+  mmap_vector(const mmap_vector&);
+  mmap_vector& operator=(const mmap_vector&);
+};
+
+} /* namespace ft */
+
+#endif /* __MMAP_VECTOR_HPP__ */
@@ -0,0 +1,258 @@
+#ifndef __MPMC_RING_HPP__
+#define __MPMC_RING_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "atomic.hpp"
+
+namespace ft {
+
+/**
+ * @brief Bounded FIFO queue for any number of producer and consumer
+ * threads.
+ *
+ * The elements live in one contiguous block of a power-of-two number of
+ * cells, each tagged with a sequence number that tells which lap of the
+ * ring it is ready for (Vyukov's bounded queue). A producer claims the cell
+ * at the enqueue position with one CAS on that position, fills it and
+ * bumps its sequence; a consumer does the same on the dequeue position.
+ * The two positions sit on separate cache lines, so producers and consumers
+ * only meet in the cells themselves, and a full or empty ring is detected
+ * from one cell without touching the other side's position.
+ *
+ * push_batch and pop_batch claim a run of up to n ready cells with a single
+ * CAS. push and pop block until they can proceed.
+ *
+ * A claimed cell has to be released whatever happens: when copying an
+ * element into it throws, the cell is released empty and skipped by the
+ * consumers; when copying an element out of it throws, that element is
+ * dropped. Not copyable.
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class mpmc_ring {
+public:
+  typedef T      value_type;
+  typedef Alloc  allocator_type;
+  typedef size_t size_type;
+
+private:
+  struct cell {
+    size_type seq;  // lap * capacity + index: free; + 1: full
+    bool      live; // false when the push that claimed it threw
+    T         value;
+  };
+
+  typedef typename Alloc::template rebind<cell>::other cell_allocator;
+
+  // read-only after construction
+  cell*          _cells;
+  size_type      _mask;
+  cell_allocator _alloc;
+  char           _pad0[cache_line_size];
+  size_type      _enqueue_pos;
+  char           _pad1[cache_line_size - sizeof(size_type)];
+  size_type      _dequeue_pos;
+  char           _pad2[cache_line_size - sizeof(size_type)];
+
+public:
+  /**
+   * @brief Ring of at least capacity cells, rounded up to a power of two.
+   * @throw std::length_error when capacity is 0
+   */
+  explicit mpmc_ring(size_type capacity,
+                     const allocator_type& a = allocator_type())
+  : _cells(0), _mask(0), _alloc(a), _enqueue_pos(0), _dequeue_pos(0) {
+    if (capacity == 0 || capacity > _alloc.max_size())
+      throw std::length_error("ft::mpmc_ring");
+    size_type n = 1;
+    while (n < capacity)
+      n *= 2;
+    _cells = _alloc.allocate(n);
+    _mask = n - 1;
+    for (size_type i = 0; i < n; ++i)
+      _cells[i].seq = i; // only the sequence numbers are initialized
+  }
+
+  /**
+   * @brief Destroys the remaining elements. No other thread may use the
+   * ring any more.
+   */
+  ~mpmc_ring() {
+    for (size_type i = _dequeue_pos; i != _enqueue_pos; ++i) {
+      cell& c = _cells[i & _mask];
+      if (c.live)
+        c.value.~T();
+    }
+    _alloc.deallocate(_cells, _mask + 1);
+  }
+
+  //!@{ Producers //////////////////////////////////////////////////////////////
+
+  /**
+   * @return false, without copying x, when the ring is full
+   */
+  bool try_push(const value_type& x) { return push_batch(&x, 1) == 1; }
+
+  void push(const value_type& x) {
+    backoff b;
+    while (!try_push(x))
+      b.pause();
+  }
+
+  /**
+   * @brief Copies the first elements of src[0, n) that fit in the ring.
+   * They end up next to each other in the queue.
+   * @return number of elements pushed, 0 when the ring is full
+   */
+  size_type push_batch(const value_type* src, size_type n) {
+    size_type pos;
+    size_type m = _claim(_enqueue_pos, 0, n, pos);
+    size_type i = 0;
+    try {
+      for (; i < m; ++i)
+        _fill(pos + i, src[i]);
+    } catch (...) {
+      // release the cell that threw and every one after it, empty
+      for (; i < m; ++i) {
+        cell& c = _cells[(pos + i) & _mask];
+        c.live = false;
+        __atomic_store_n(&c.seq, pos + i + 1, __ATOMIC_RELEASE);
+      }
+      throw;
+    }
+    return m;
+  }
+
+  //!@}
+
+  //!@{ Consumers //////////////////////////////////////////////////////////////
+
+  /**
+   * @brief Copies the oldest element into x and removes it.
+   * @return false, leaving x alone, when the ring is empty
+   */
+  bool try_pop(value_type& x) { return pop_batch(&x, 1) == 1; }
+
+  void pop(value_type& x) {
+    backoff b;
+    while (!try_pop(x))
+      b.pause();
+  }
+
+  /**
+   * @brief Moves up to n of the oldest elements into dst[0, n), oldest
+   * first.
+   * @return number of elements popped, 0 when the ring is empty
+   */
+  size_type pop_batch(value_type* dst, size_type n) {
+    size_type popped = 0;
+    while (popped < n) {
+      size_type pos;
+      size_type m = _claim(_dequeue_pos, 1, n - popped, pos);
+      if (m == 0)
+        break;
+      size_type i = 0;
+      try {
+        for (; i < m; ++i) {
+          cell& c = _cells[(pos + i) & _mask];
+          if (c.live) {
+            dst[popped] = c.value;
+            ++popped;
+          }
+          _drain(pos + i);
+        }
+      } catch (...) {
+        for (; i < m; ++i)
+          _drain(pos + i);
+        throw;
+      }
+      // cells skipped as empty leave room for more, if there are any
+    }
+    return popped;
+  }
+
+  //!@}
+
+  //!@{ Capacity ///////////////////////////////////////////////////////////////
+
+  size_type capacity() const { return _mask + 1; }
+
+  /**
+   * @brief Number of claimed cells at some point during the call, counting
+   * the ones still being filled or drained. The dequeue position is read
+   * first, so the difference never wraps below zero.
+   */
+  size_type size_approx() const {
+    size_type head = __atomic_load_n(&_dequeue_pos, __ATOMIC_ACQUIRE);
+    size_type tail = __atomic_load_n(&_enqueue_pos, __ATOMIC_ACQUIRE);
+    return tail - head > _mask ? _mask + 1 : tail - head;
+  }
+
+  bool empty() const { return size_approx() == 0; }
+
+  //!@}
+
+private:
+  /**
+   * @brief Claims up to n consecutive cells starting at position. A cell is
+   * ready when its sequence number is its position plus ready_offset: 0 for
+   * producers waiting for a free cell, 1 for consumers waiting for a full
+   * one.
+   * @param first set to the position of the first claimed cell
+   * @return number of cells claimed, 0 when the first one is not ready
+   */
+  size_type _claim(size_type& position, size_type ready_offset, size_type n,
+                   size_type& first) {
+    if (n == 0)
+      return 0;
+    size_type pos = __atomic_load_n(&position, __ATOMIC_RELAXED);
+    for (;;) {
+      size_type m = 0;
+      while (m < n) {
+        size_type seq = __atomic_load_n(&_cells[(pos + m) & _mask].seq,
+                                        __ATOMIC_ACQUIRE);
+        ptrdiff_t lag = ptrdiff_t(seq - (pos + m + ready_offset));
+        if (lag == 0) {
+          ++m;
+          continue;
+        }
+        if (m == 0 && lag < 0)
+          return 0; // full, or empty
+        break; // the run ends here, or pos is stale
+      }
+      if (m != 0 && __atomic_compare_exchange_n(&position, &pos, pos + m,
+                                                true, __ATOMIC_RELAXED,
+                                                __ATOMIC_RELAXED)) {
+        first = pos;
+        return m;
+      }
+      if (m == 0)
+        pos = __atomic_load_n(&position, __ATOMIC_RELAXED);
+      cpu_relax();
+    }
+  }
+
+  void _fill(size_type pos, const value_type& x) {
+    cell& c = _cells[pos & _mask];
+    new (&c.value) T(x);
+    c.live = true;
+    __atomic_store_n(&c.seq, pos + 1, __ATOMIC_RELEASE);
+  }
+
+  // destroys the value of a claimed full cell and frees it for the next lap
+  void _drain(size_type pos) {
+    cell& c = _cells[pos & _mask];
+    if (c.live)
+      c.value.~T();
+    __atomic_store_n(&c.seq, pos + _mask + 1, __ATOMIC_RELEASE);
+  }
+
+  mpmc_ring(const mpmc_ring&);
+  mpmc_ring& operator=(const mpmc_ring&);
+};
+
+} /* namespace ft */
+
+#endif /* __MPMC_RING_HPP__ */
@@ -0,0 +1,692 @@
+#ifndef __PARALLEL_ALGORITHM_HPP__
+#define __PARALLEL_ALGORITHM_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include "algorithm.hpp"
+#include "iterator.hpp"
+#include "map.hpp"
+#include "set.hpp"
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+namespace ft {
+
+//!@{ Parallel Internals ///////////////////////////////////////////////////////
+
+/*
+ * Every parallel algorithm splits its index range in halves, forking the
+ * right half into the pool and recursing into the left one, down to pieces
+ * of at most grain elements that run sequentially. A grain of 0 picks one
+ * from the pool size: about four pieces per thread, never fewer than
+ * parallel_min_grain elements, so that small ranges run on the calling
+ * thread alone. The range must be random access (ft::vector iterators or
+ * pointers); functors must be safe to call concurrently on distinct
+ * elements, and reduction and scan operators associative.
+ */
+
+const size_t parallel_min_grain = 2048;
+
+inline size_t _parallel_grain(const thread_pool& pool, size_t n,
+                              size_t grain) {
+  if (grain != 0)
+    return grain;
+  grain = n / (4 * pool.concurrency());
+  return grain < parallel_min_grain ? parallel_min_grain : grain;
+}
+
+template <typename F>
+void _parallel_thunk(void* f) {
+  (*static_cast<F*>(f))();
+}
+
+/**
+ * @brief Runs a() on the calling thread and b() in the pool, and returns
+ * once both have finished.
+ */
+template <typename F1, typename F2>
+void _parallel_invoke(thread_pool& pool, F1& a, F2& b) {
+  task_group g;
+  pool.run(g, &_parallel_thunk<F2>, &b);
+  try {
+    a();
+  } catch (...) {
+    // b still points into this frame
+    try {
+      pool.wait(g);
+    } catch (...) {
+    }
+    throw;
+  }
+  pool.wait(g);
+}
+
+template <typename Body>
+void _parallel_for(thread_pool& pool, size_t lo, size_t hi, size_t grain,
+                   const Body& body);
+
+template <typename Body>
+struct _parallel_for_task {
+  thread_pool* pool;
+  size_t       lo;
+  size_t       hi;
+  size_t       grain;
+  const Body*  body;
+
+  void operator()() const { _parallel_for(*pool, lo, hi, grain, *body); }
+};
+
+/**
+ * @brief Calls body(i, j) on pieces [i, j) of [lo, hi) of at most grain
+ * indices, in parallel.
+ */
+template <typename Body>
+void _parallel_for(thread_pool& pool, size_t lo, size_t hi, size_t grain,
+                   const Body& body) {
+  if (hi - lo <= grain) {
+    if (lo != hi)
+      body(lo, hi);
+    return;
+  }
+  size_t                   mid = lo + (hi - lo) / 2;
+  _parallel_for_task<Body> left = { &pool, lo, mid, grain, &body };
+  _parallel_for_task<Body> right = { &pool, mid, hi, grain, &body };
+  _parallel_invoke(pool, left, right);
+}
+
+template <typename RandomIt, typename Function>
+struct _for_each_body {
+  RandomIt        first;
+  const Function* f;
+
+  void operator()(size_t lo, size_t hi) const {
+    Function fn(*f);
+    RandomIt it = first + lo;
+    RandomIt end = first + hi;
+    for (; it != end; ++it)
+      fn(*it);
+  }
+};
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+struct _transform_body {
+  RandomIt       first;
+  OutputIt       out;
+  const UnaryOp* op;
+
+  void operator()(size_t lo, size_t hi) const {
+    UnaryOp  fn(*op);
+    RandomIt it = first + lo;
+    RandomIt end = first + hi;
+    OutputIt o = out + lo;
+    for (; it != end; ++it, ++o)
+      *o = fn(*it);
+  }
+};
+
+/*
+ * Reduction and scan cut the range into chunks of grain elements and work
+ * on one chunk per piece (so with a grain of 1 over chunk indices).
+ */
+
+template <typename RandomIt, typename T, typename BinaryOp>
+struct _chunk_reduce_body {
+  RandomIt        first;
+  size_t          n;
+  size_t          chunk;
+  T*              partial;
+  const BinaryOp* op;
+
+  void operator()(size_t lo, size_t hi) const {
+    BinaryOp fn(*op);
+    for (size_t c = lo; c < hi; ++c) {
+      RandomIt it = first + c * chunk;
+      RandomIt end = first + std::min(n, (c + 1) * chunk);
+      T        acc = *it;
+      while (++it != end)
+        acc = fn(acc, *it);
+      partial[c] = acc;
+    }
+  }
+};
+
+template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp>
+struct _chunk_scan_body {
+  RandomIt        first;
+  OutputIt        out;
+  size_t          n;
+  size_t          chunk;
+  const T*        carry; // carry[c - 1]: reduction of the chunks before c
+  const BinaryOp* op;
+
+  void operator()(size_t lo, size_t hi) const {
+    BinaryOp fn(*op);
+    for (size_t c = lo; c < hi; ++c) {
+      RandomIt it = first + c * chunk;
+      RandomIt end = first + std::min(n, (c + 1) * chunk);
+      OutputIt o = out + c * chunk;
+      T        acc = c == 0 ? T(*it) : fn(carry[c - 1], *it);
+      *o = acc;
+      while (++it != end) {
+        acc = fn(acc, *it);
+        *++o = acc;
+      }
+    }
+  }
+};
+
+/*
+ * parallel_sort sorts a power of two number of chunks with ft::sort, then
+ * merges them pairwise, round after round, between the range and a buffer.
+ * Each merge itself is split: the middle element of the longer input is
+ * located in the other one by binary search, which cuts both into two
+ * independent merges, so that the last rounds, with few but large merges,
+ * still use every thread.
+ */
+
+template <typename RandomIt, typename T>
+inline void _sort_chunk(RandomIt first, RandomIt last, std::less<T>) {
+  ft::sort(first, last);
+}
+
+template <typename RandomIt, typename Compare>
+inline void _sort_chunk(RandomIt first, RandomIt last, Compare comp) {
+  ft::sort(first, last, comp);
+}
+
+template <typename RandomIt, typename Compare>
+struct _sort_chunks_body {
+  RandomIt       first;
+  size_t         n;
+  size_t         chunks;
+  const Compare* comp;
+
+  void operator()(size_t lo, size_t hi) const {
+    for (size_t c = lo; c < hi; ++c)
+      _sort_chunk(first + n * c / chunks, first + n * (c + 1) / chunks, *comp);
+  }
+};
+
+template <typename InputIt, typename OutputIt, typename Compare>
+void _parallel_merge(thread_pool& pool, InputIt first1, InputIt last1,
+                     InputIt first2, InputIt last2, OutputIt out,
+                     const Compare& comp, size_t grain);
+
+template <typename InputIt, typename OutputIt, typename Compare>
+struct _merge_task {
+  thread_pool*   pool;
+  InputIt        first1;
+  InputIt        last1;
+  InputIt        first2;
+  InputIt        last2;
+  OutputIt       out;
+  const Compare* comp;
+  size_t         grain;
+
+  void operator()() const {
+    _parallel_merge(*pool, first1, last1, first2, last2, out, *comp, grain);
+  }
+};
+
+/**
+ * @brief std::merge of two sorted ranges, split into pieces of at most
+ * grain output elements merged in parallel. Stable like std::merge.
+ */
+template <typename InputIt, typename OutputIt, typename Compare>
+void _parallel_merge(thread_pool& pool, InputIt first1, InputIt last1,
+                     InputIt first2, InputIt last2, OutputIt out,
+                     const Compare& comp, size_t grain) {
+  size_t n1 = last1 - first1;
+  size_t n2 = last2 - first2;
+  if (n1 + n2 <= grain) {
+    std::merge(first1, last1, first2, last2, out, comp);
+    return;
+  }
+  InputIt mid1;
+  InputIt mid2;
+  // equal elements of the first range stay ahead of those of the second
+  if (n1 >= n2) {
+    mid1 = first1 + n1 / 2;
+    mid2 = std::lower_bound(first2, last2, *mid1, comp);
+  } else {
+    mid2 = first2 + n2 / 2;
+    mid1 = std::upper_bound(first1, last1, *mid2, comp);
+  }
+  OutputIt mid = out + (mid1 - first1) + (mid2 - first2);
+
+  _merge_task<InputIt, OutputIt, Compare> left = {
+    &pool, first1, mid1, first2, mid2, out, &comp, grain
+  };
+  _merge_task<InputIt, OutputIt, Compare> right = {
+    &pool, mid1, last1, mid2, last2, mid, &comp, grain
+  };
+  _parallel_invoke(pool, left, right);
+}
+
+template <typename InputIt, typename OutputIt, typename Compare>
+struct _merge_round_body {
+  thread_pool*   pool;
+  InputIt        src;
+  OutputIt       dst;
+  size_t         n;
+  size_t         chunks;
+  size_t         width; // chunks per sorted run
+  const Compare* comp;
+  size_t         grain;
+
+  void operator()(size_t lo, size_t hi) const {
+    for (size_t p = lo; p < hi; ++p) {
+      size_t b = n * (2 * p * width) / chunks;
+      size_t m = n * ((2 * p + 1) * width) / chunks;
+      size_t e = n * ((2 * p + 2) * width) / chunks;
+      _parallel_merge(*pool, src + b, src + m, src + m, src + e, dst + b,
+                      *comp, grain);
+    }
+  }
+};
+
+template <typename InputIt, typename OutputIt>
+struct _copy_body {
+  InputIt  first;
+  OutputIt out;
+
+  void operator()(size_t lo, size_t hi) const {
+    std::copy(first + lo, first + hi, out + lo);
+  }
+};
+
+template <typename RandomIt, typename Compare>
+void _parallel_sort(thread_pool& pool, RandomIt first, RandomIt last,
+                    const Compare& comp, size_t grain) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+
+  size_t n = last - first;
+  if (grain == 0) {
+    grain = n / pool.concurrency();
+    if (grain < parallel_min_grain)
+      grain = parallel_min_grain;
+  }
+  size_t chunks = 1;
+  while (n / chunks > grain)
+    chunks *= 2;
+  if (chunks == 1) {
+    _sort_chunk(first, last, comp);
+    return;
+  }
+
+  _sort_chunks_body<RandomIt, Compare> sort_body = { first, n, chunks, &comp };
+  _parallel_for(pool, 0, chunks, 1, sort_body);
+
+  ft::vector<value_type> buf(n, *first);
+  value_type*            tmp = &buf[0];
+  size_t                 merge_grain = _parallel_grain(pool, n, 0);
+  bool                   in_buf = false;
+  for (size_t width = 1; width < chunks; width *= 2) {
+    size_t pairs = chunks / (2 * width);
+    if (!in_buf) {
+      _merge_round_body<RandomIt, value_type*, Compare> round = {
+        &pool, first, tmp, n, chunks, width, &comp, merge_grain
+      };
+      _parallel_for(pool, 0, pairs, 1, round);
+    } else {
+      _merge_round_body<value_type*, RandomIt, Compare> round = {
+        &pool, tmp, first, n, chunks, width, &comp, merge_grain
+      };
+      _parallel_for(pool, 0, pairs, 1, round);
+    }
+    in_buf = !in_buf;
+  }
+  if (in_buf) {
+    _copy_body<value_type*, RandomIt> copy = { tmp, first };
+    _parallel_for(pool, 0, n, merge_grain, copy);
+  }
+}
+
+/*
+ * map and set are walked through their split_ranges(): about four in-order
+ * ranges per thread, one task each. A range has no element type to seed a
+ * fold with, so every range folds from an identity value and the partial
+ * results are combined in order.
+ */
+
+template <typename Range, typename Function>
+struct _ranges_for_each_body {
+  const Range*    ranges;
+  const Function* f;
+
+  void operator()(size_t lo, size_t hi) const {
+    Function fn(*f);
+    for (size_t r = lo; r < hi; ++r)
+      for (typename Range::first_type it = ranges[r].first;
+           it != ranges[r].second; ++it)
+        fn(*it);
+  }
+};
+
+template <typename Range, typename T, typename BinaryOp>
+struct _ranges_reduce_body {
+  const Range*    ranges;
+  T*              partial;
+  const BinaryOp* op;
+
+  void operator()(size_t lo, size_t hi) const {
+    BinaryOp fn(*op);
+    for (size_t r = lo; r < hi; ++r) {
+      T acc = partial[r];
+      for (typename Range::first_type it = ranges[r].first;
+           it != ranges[r].second; ++it)
+        acc = fn(acc, *it);
+      partial[r] = acc;
+    }
+  }
+};
+
+template <typename Range, typename Function>
+void _parallel_ranges_for_each(thread_pool& pool,
+                               const ft::vector<Range>& ranges,
+                               const Function& f) {
+  if (ranges.empty())
+    return;
+  _ranges_for_each_body<Range, Function> body = { &ranges[0], &f };
+  _parallel_for(pool, 0, ranges.size(), 1, body);
+}
+
+template <typename Range, typename T, typename BinaryOp, typename Combine>
+T _parallel_ranges_reduce(thread_pool& pool, const ft::vector<Range>& ranges,
+                          const T& identity, const BinaryOp& op,
+                          Combine combine) {
+  if (ranges.empty())
+    return identity;
+  ft::vector<T> partial(ranges.size(), identity);
+
+  _ranges_reduce_body<Range, T, BinaryOp> body = { &ranges[0], &partial[0],
+                                                   &op };
+  _parallel_for(pool, 0, ranges.size(), 1, body);
+  T result = partial[0];
+  for (size_t r = 1; r < partial.size(); ++r)
+    result = combine(result, partial[r]);
+  return result;
+}
+
+inline size_t _parallel_tree_ranges(const thread_pool& pool) {
+  return 4 * pool.concurrency();
+}
+
+//!@}
+
+//!@{ Parallel Algorithms //////////////////////////////////////////////////////
+
+/*
+ * Each algorithm takes the pool to run in and, last, an optional grain: the
+ * largest number of elements one task handles (0: chosen from the range and
+ * pool sizes). The overloads without a pool use thread_pool::global().
+ */
+
+template <typename RandomIt, typename Function>
+void parallel_for_each(thread_pool& pool, RandomIt first, RandomIt last,
+                       Function f, size_t grain = 0) {
+  size_t                             n = last - first;
+  _for_each_body<RandomIt, Function> body = { first, &f };
+  _parallel_for(pool, 0, n, _parallel_grain(pool, n, grain), body);
+}
+
+template <typename RandomIt, typename Function>
+void parallel_for_each(RandomIt first, RandomIt last, Function f,
+                       size_t grain = 0) {
+  parallel_for_each(thread_pool::global(), first, last, f, grain);
+}
+
+/**
+ * @return end of the output range
+ */
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(thread_pool& pool, RandomIt first, RandomIt last,
+                            OutputIt out, UnaryOp op, size_t grain = 0) {
+  size_t                                       n = last - first;
+  _transform_body<RandomIt, OutputIt, UnaryOp> body = { first, out, &op };
+  _parallel_for(pool, 0, n, _parallel_grain(pool, n, grain), body);
+  return out + n;
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(RandomIt first, RandomIt last, OutputIt out,
+                            UnaryOp op, size_t grain = 0) {
+  return parallel_transform(thread_pool::global(), first, last, out, op,
+                            grain);
+}
+
+/**
+ * @brief init op *first op ... op *(last - 1), grouped in any way; op must
+ * be associative but need not be commutative.
+ */
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(thread_pool& pool, RandomIt first, RandomIt last, T init,
+                  BinaryOp op, size_t grain = 0) {
+  size_t n = last - first;
+  if (n == 0)
+    return init;
+  grain = _parallel_grain(pool, n, grain);
+  size_t        chunks = (n + grain - 1) / grain;
+  ft::vector<T> partial(chunks, init);
+
+  _chunk_reduce_body<RandomIt, T, BinaryOp> body = {
+    first, n, grain, &partial[0], &op
+  };
+  _parallel_for(pool, 0, chunks, 1, body);
+  for (size_t c = 0; c < chunks; ++c)
+    init = op(init, partial[c]);
+  return init;
+}
+
+template <typename RandomIt, typename T>
+T parallel_reduce(thread_pool& pool, RandomIt first, RandomIt last, T init) {
+  return parallel_reduce(pool, first, last, init, std::plus<T>());
+}
+
+template <typename RandomIt, typename T, typename BinaryOp>
+T parallel_reduce(RandomIt first, RandomIt last, T init, BinaryOp op,
+                  size_t grain = 0) {
+  return parallel_reduce(thread_pool::global(), first, last, init, op, grain);
+}
+
+template <typename RandomIt, typename T>
+T parallel_reduce(RandomIt first, RandomIt last, T init) {
+  return parallel_reduce(thread_pool::global(), first, last, init,
+                         std::plus<T>());
+}
+
+/**
+ * @brief Writes out[i] = *first op ... op first[i], like a sequential
+ * partial_sum; out may be first. Reads every element twice: once to reduce
+ * the chunks, once to scan them.
+ * @return end of the output range
+ */
+template <typename RandomIt, typename OutputIt, typename BinaryOp>
+OutputIt parallel_inclusive_scan(thread_pool& pool, RandomIt first,
+                                 RandomIt last, OutputIt out, BinaryOp op,
+                                 size_t grain = 0) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+
+  size_t n = last - first;
+  if (n == 0)
+    return out;
+  grain = _parallel_grain(pool, n, grain);
+  size_t                 chunks = (n + grain - 1) / grain;
+  ft::vector<value_type> carry(chunks, *first);
+  _chunk_reduce_body<RandomIt, value_type, BinaryOp> reduce = {
+    first, n, grain, &carry[0], &op
+  };
+  _parallel_for(pool, 0, chunks - 1, 1, reduce); // the last one is not needed
+  for (size_t c = 1; c + 1 < chunks; ++c)
+    carry[c] = op(carry[c - 1], carry[c]);
+  _chunk_scan_body<RandomIt, OutputIt, value_type, BinaryOp> scan = {
+    first, out, n, grain, &carry[0], &op
+  };
+  _parallel_for(pool, 0, chunks, 1, scan);
+  return out + n;
+}
+
+template <typename RandomIt, typename OutputIt>
+OutputIt parallel_inclusive_scan(thread_pool& pool, RandomIt first,
+                                 RandomIt last, OutputIt out) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+  return parallel_inclusive_scan(pool, first, last, out,
+                                 std::plus<value_type>());
+}
+
+template <typename RandomIt, typename OutputIt, typename BinaryOp>
+OutputIt parallel_inclusive_scan(RandomIt first, RandomIt last, OutputIt out,
+                                 BinaryOp op, size_t grain = 0) {
+  return parallel_inclusive_scan(thread_pool::global(), first, last, out, op,
+                                 grain);
+}
+
+template <typename RandomIt, typename OutputIt>
+OutputIt parallel_inclusive_scan(RandomIt first, RandomIt last,
+                                 OutputIt out) {
+  return parallel_inclusive_scan(thread_pool::global(), first, last, out);
+}
+
+/**
+ * @brief Not stable. Sorts chunks of at most grain elements with ft::sort
+ * (so integers still go through radix sort) and merges them in parallel
+ * through a buffer of (last - first) elements.
+ */
+template <typename RandomIt, typename Compare>
+void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last,
+                   Compare comp, size_t grain = 0) {
+  _parallel_sort(pool, first, last, comp, grain);
+}
+
+template <typename RandomIt>
+void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last) {
+  typedef typename iterator_traits<RandomIt>::value_type value_type;
+  _parallel_sort(pool, first, last, std::less<value_type>(), 0);
+}
+
+template <typename RandomIt, typename Compare>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp,
+                   size_t grain = 0) {
+  _parallel_sort(thread_pool::global(), first, last, comp, grain);
+}
+
+template <typename RandomIt>
+void parallel_sort(RandomIt first, RandomIt last) {
+  parallel_sort(thread_pool::global(), first, last);
+}
+
+//!@}
+
+//!@{ Parallel Algorithms on map and set ///////////////////////////////////////
+
+/*
+ * for_each and reduce over every element of a map or set, in order within
+ * each of the tree's split_ranges(). f may modify the mapped values of a
+ * non-const map. reduce folds each range from identity, which must be
+ * neutral for op, with op(T, value_type), then combines the partial results
+ * left to right with combine(T, T); without combine, op does both.
+ */
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename Function>
+void parallel_for_each(thread_pool& pool, map<K, V, C, A, H>& m, Function f) {
+  _parallel_ranges_for_each(pool, m.split_ranges(_parallel_tree_ranges(pool)),
+                            f);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename Function>
+void parallel_for_each(thread_pool& pool, const map<K, V, C, A, H>& m,
+                       Function f) {
+  _parallel_ranges_for_each(pool, m.split_ranges(_parallel_tree_ranges(pool)),
+                            f);
+}
+
+template <typename K, typename C, typename A, typename H, typename Function>
+void parallel_for_each(thread_pool& pool, const set<K, C, A, H>& s,
+                       Function f) {
+  _parallel_ranges_for_each(pool, s.split_ranges(_parallel_tree_ranges(pool)),
+                            f);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename Function>
+void parallel_for_each(map<K, V, C, A, H>& m, Function f) {
+  parallel_for_each(thread_pool::global(), m, f);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename Function>
+void parallel_for_each(const map<K, V, C, A, H>& m, Function f) {
+  parallel_for_each(thread_pool::global(), m, f);
+}
+
+template <typename K, typename C, typename A, typename H, typename Function>
+void parallel_for_each(const set<K, C, A, H>& s, Function f) {
+  parallel_for_each(thread_pool::global(), s, f);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename T, typename BinaryOp, typename Combine>
+T parallel_reduce(thread_pool& pool, const map<K, V, C, A, H>& m, T identity,
+                  BinaryOp op, Combine combine) {
+  return _parallel_ranges_reduce(
+      pool, m.split_ranges(_parallel_tree_ranges(pool)), identity, op,
+      combine);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename T, typename BinaryOp>
+T parallel_reduce(thread_pool& pool, const map<K, V, C, A, H>& m, T identity,
+                  BinaryOp op) {
+  return parallel_reduce(pool, m, identity, op, op);
+}
+
+template <typename K, typename C, typename A, typename H, typename T,
+          typename BinaryOp, typename Combine>
+T parallel_reduce(thread_pool& pool, const set<K, C, A, H>& s, T identity,
+                  BinaryOp op, Combine combine) {
+  return _parallel_ranges_reduce(
+      pool, s.split_ranges(_parallel_tree_ranges(pool)), identity, op,
+      combine);
+}
+
+template <typename K, typename C, typename A, typename H, typename T,
+          typename BinaryOp>
+T parallel_reduce(thread_pool& pool, const set<K, C, A, H>& s, T identity,
+                  BinaryOp op) {
+  return parallel_reduce(pool, s, identity, op, op);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename T, typename BinaryOp, typename Combine>
+T parallel_reduce(const map<K, V, C, A, H>& m, T identity, BinaryOp op,
+                  Combine combine) {
+  return parallel_reduce(thread_pool::global(), m, identity, op, combine);
+}
+
+template <typename K, typename V, typename C, typename A, typename H,
+          typename T, typename BinaryOp>
+T parallel_reduce(const map<K, V, C, A, H>& m, T identity, BinaryOp op) {
+  return parallel_reduce(thread_pool::global(), m, identity, op, op);
+}
+
+template <typename K, typename C, typename A, typename H, typename T,
+          typename BinaryOp, typename Combine>
+T parallel_reduce(const set<K, C, A, H>& s, T identity, BinaryOp op,
+                  Combine combine) {
+  return parallel_reduce(thread_pool::global(), s, identity, op, combine);
+}
+
+template <typename K, typename C, typename A, typename H, typename T,
+          typename BinaryOp>
+T parallel_reduce(const set<K, C, A, H>& s, T identity, BinaryOp op) {
+  return parallel_reduce(thread_pool::global(), s, identity, op, op);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __PARALLEL_ALGORITHM_HPP__ */
@@ -0,0 +1,399 @@
+#ifndef __PRIORITY_QUEUE_HPP__
+#define __PRIORITY_QUEUE_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "iterator.hpp"
+#include "vector.hpp"
+
+namespace ft {
+
+//!@{ d-ary Heap ///////////////////////////////////////////////////////////////
+
+/*
+ * The priority queues keep a max-heap in which every node has heap_arity
+ * children: node i has children heap_arity * i + 1 to heap_arity * i +
+ * heap_arity. With 4 children the heap is half as deep as a binary one, and
+ * the children of a node sit next to each other, usually in one cache line,
+ * so a sift down takes half the cache misses for a few more comparisons.
+ *
+ * Every function places elements through track(element, index), which the
+ * indexed queue uses to keep each element's position up to date.
+ */
+
+const size_t heap_arity = 4;
+
+struct _no_track {
+  template <typename T>
+  void operator()(const T&, size_t) const { }
+};
+
+/**
+ * @brief Sifts v up from hole, toward top, in the heap at first.
+ */
+template <typename RandomIt, typename Distance, typename T, typename Compare,
+          typename Track>
+void _dary_push_heap(RandomIt first, Distance hole, Distance top, T v,
+                     Compare comp, Track track) {
+  while (hole > top) {
+    Distance parent = (hole - 1) / Distance(heap_arity);
+    if (!comp(first[parent], v))
+      break;
+    first[hole] = first[parent];
+    track(first[hole], hole);
+    hole = parent;
+  }
+  first[hole] = v;
+  track(first[hole], hole);
+}
+
+/**
+ * @brief Sifts v down from hole in the heap [first, first + len). Like
+ * _adjust_heap, it walks the hole down to a leaf along the larger children
+ * and then sifts v back up, which saves a comparison per level when v
+ * comes from the bottom of the heap, as it does in pop.
+ */
+template <typename RandomIt, typename Distance, typename T, typename Compare,
+          typename Track>
+void _dary_adjust_heap(RandomIt first, Distance hole, Distance len, T v,
+                       Compare comp, Track track) {
+  const Distance top = hole;
+  const Distance d = Distance(heap_arity);
+  Distance       child = d * hole + 1;
+  while (child < len) {
+    Distance best = child;
+    Distance end = len - child < d ? len : child + d;
+    for (Distance c = child + 1; c < end; ++c)
+      if (comp(first[best], first[c]))
+        best = c;
+    first[hole] = first[best];
+    track(first[hole], hole);
+    hole = best;
+    child = d * hole + 1;
+  }
+  _dary_push_heap(first, hole, top, v, comp, track);
+}
+
+/**
+ * @brief Arranges [first, last) into a heap in O(n), sifting down every
+ * inner node from the last one up.
+ */
+template <typename RandomIt, typename Compare, typename Track>
+void _dary_make_heap(RandomIt first, RandomIt last, Compare comp,
+                     Track track) {
+  typedef typename iterator_traits<RandomIt>::difference_type Distance;
+
+  Distance len = last - first;
+  for (Distance i = len; i-- != 0;)
+    track(first[i], i); // leaves stay in place
+  if (len < 2)
+    return;
+  for (Distance parent = (len - 2) / Distance(heap_arity);; --parent) {
+    _dary_adjust_heap(first, parent, len, first[parent], comp, track);
+    if (parent == 0)
+      return;
+  }
+}
+
+//!@}
+
+//!@{ Priority Queue ///////////////////////////////////////////////////////////
+
+/**
+ * @brief Adapter giving constant-time access to the greatest element under
+ * Compare, kept in a 4-ary heap over Container (see heap_arity). push and
+ * pop are O(log n); push_range adds many elements at once and rebuilds the
+ * heap in O(n) when that is cheaper than pushing them one by one.
+ */
+template <class T, class Container = ft::vector<T>,
+          class Compare = std::less<typename Container::value_type> >
+class priority_queue {
+public:
+  typedef Container                                  container_type;
+  typedef Compare                                    value_compare;
+  typedef typename container_type::value_type&       reference;
+  typedef const typename container_type::value_type& const_reference;
+  typedef typename container_type::value_type        value_type;
+  typedef typename container_type::size_type         size_type;
+
+protected:
+  Container c;
+  Compare   comp;
+
+public:
+  explicit priority_queue(const Compare&   comp = Compare(),
+                          const Container& c = Container())
+  : c(c), comp(comp) {
+    _dary_make_heap(this->c.begin(), this->c.end(), this->comp, _no_track());
+  }
+
+  template <class InputIterator>
+  priority_queue(InputIterator first, InputIterator last,
+                 const Compare& comp = Compare(),
+                 const Container& c = Container())
+  : c(c), comp(comp) {
+    this->c.insert(this->c.end(), first, last);
+    _dary_make_heap(this->c.begin(), this->c.end(), this->comp, _no_track());
+  }
+
+  // Test whether container is empty
+  bool empty() const { return c.empty(); }
+
+  // Return size
+  size_type size() const { return c.size(); }
+
+  // Heap memory of the underlying container (ft containers only)
+  memory_stats memory_usage() const { return c.memory_usage(); }
+
+  // Access greatest element
+  const_reference top() const { return c.front(); }
+
+  // 	Insert element
+  void push(const value_type& x) {
+    c.push_back(x);
+    _dary_push_heap(c.begin(), size_type(c.size() - 1), size_type(0),
+                    c.back(), comp, _no_track());
+  }
+
+  /**
+   * @brief Inserts the elements of [first, last). Each one is sifted up in
+   * O(log n) unless the heap at least doubles, in which case it is rebuilt
+   * as a whole in O(n).
+   */
+  template <class InputIterator>
+  void push_range(InputIterator first, InputIterator last) {
+    size_type n = c.size();
+    c.insert(c.end(), first, last);
+    if (c.size() - n >= n)
+      _dary_make_heap(c.begin(), c.end(), comp, _no_track());
+    else
+      for (size_type i = n; i < c.size(); ++i)
+        _dary_push_heap(c.begin(), i, size_type(0), c[i], comp,
+                        _no_track());
+  }
+
+  // Remove greatest element
+  void pop() {
+    value_type v = c.back();
+    c.pop_back();
+    if (!c.empty())
+      _dary_adjust_heap(c.begin(), size_type(0), size_type(c.size()), v, comp,
+                        _no_track());
+  }
+
+  void swap(priority_queue& x) {
+    c.swap(x.c);
+    ft::swap(comp, x.comp);
+  }
+
+}; /* class priority_queue */
+
+template <class T, class Container, class Compare>
+inline void swap(priority_queue<T, Container, Compare>& x,
+                 priority_queue<T, Container, Compare>& y) {
+  x.swap(y);
+}
+
+//!@}
+
+//!@{ Indexed Priority Queue ///////////////////////////////////////////////////
+
+/**
+ * @brief Priority queue whose elements can be changed or removed after
+ * they were pushed, as timers and Dijkstra's algorithm need.
+ *
+ * push returns a handle that names the element until it is popped or
+ * erased; handles of removed elements are reused by later pushes. The heap
+ * stores each value next to its handle, in the same 4-ary layout as
+ * priority_queue, and a table maps handles to heap positions, so that
+ * update, decrease_key and erase find the element in O(1) and restore the
+ * heap in O(log n).
+ *
+ * As with priority_queue, top() is the greatest element under Compare; a
+ * min-queue, where decrease_key lowers a key, takes std::greater<T>.
+ */
+template <class T, class Compare = std::less<T>,
+          class Alloc = std::allocator<T> >
+class indexed_priority_queue {
+public:
+  typedef T            value_type;
+  typedef Compare      value_compare;
+  typedef Alloc        allocator_type;
+  typedef size_t       size_type;
+  typedef size_t       handle;
+  typedef const T&     const_reference;
+
+private:
+  struct entry {
+    T      value;
+    handle id;
+
+    entry(const T& value, handle id) : value(value), id(id) { }
+  };
+
+  struct entry_compare {
+    Compare comp;
+
+    explicit entry_compare(const Compare& comp) : comp(comp) { }
+    bool operator()(const entry& x, const entry& y) const {
+      return comp(x.value, y.value);
+    }
+  };
+
+  // records where each entry lands
+  struct track_position {
+    size_type* pos;
+
+    void operator()(const entry& e, size_type i) const { pos[e.id] = i; }
+  };
+
+  typedef typename Alloc::template rebind<entry>::other     entry_allocator;
+  typedef typename Alloc::template rebind<size_type>::other index_allocator;
+  typedef ft::vector<entry, entry_allocator>                heap_type;
+  typedef ft::vector<size_type, index_allocator>            index_vector;
+
+  static const size_type npos = size_type(-1);
+
+  heap_type     _heap;
+  index_vector  _pos;  // heap position by handle, npos when unused
+  index_vector  _free; // unused handles
+  entry_compare _comp;
+
+public:
+  explicit indexed_priority_queue(const Compare&        comp = Compare(),
+                                  const allocator_type& a = allocator_type())
+  : _heap(a), _pos(a), _free(a), _comp(comp) { }
+
+  //!@{ Capacity /////////////////////////////////////////////////////////////
+
+  bool      empty() const { return _heap.empty(); }
+  size_type size() const { return _heap.size(); }
+
+  memory_stats memory_usage() const {
+    memory_stats h = _heap.memory_usage();
+    memory_stats p = _pos.memory_usage();
+    memory_stats f = _free.memory_usage();
+    memory_stats s;
+    s.payload_bytes = size() * sizeof(value_type);
+    s.overhead_bytes = h.total_bytes() + p.total_bytes() + f.total_bytes() -
+                       s.payload_bytes;
+    s.allocations = h.allocations + p.allocations + f.allocations;
+    return s;
+  }
+
+  //!@}
+
+  //!@{ Element Access ///////////////////////////////////////////////////////
+
+  // greatest element, and its handle
+  const_reference top() const { return _heap.front().value; }
+  handle          top_handle() const { return _heap.front().id; }
+
+  // whether h names an element currently in the queue
+  bool contains(handle h) const { return h < _pos.size() && _pos[h] != npos; }
+
+  const_reference operator[](handle h) const { return _heap[_pos[h]].value; }
+
+  //!@}
+
+  //!@{ Modifiers ////////////////////////////////////////////////////////////
+
+  /**
+   * @return the handle of the new element
+   */
+  handle push(const value_type& x) {
+    if (_free.empty()) {
+      _pos.push_back(npos);
+      _free.push_back(_pos.size() - 1);
+    }
+    handle h = _free.back();
+    _heap.push_back(entry(x, h));
+    _free.pop_back();
+    _dary_push_heap(_heap.begin(), size_type(_heap.size() - 1), size_type(0),
+                    _heap.back(), _comp, _track());
+    return h;
+  }
+
+  // Remove greatest element
+  void pop() { _remove(0); }
+
+  /**
+   * @brief Gives h the value x, which must not be less than its current
+   * value under Compare: the element can only move toward the top.
+   */
+  void decrease_key(handle h, const value_type& x) {
+    size_type i = _pos[h];
+    _dary_push_heap(_heap.begin(), i, size_type(0), entry(x, h), _comp,
+                    _track());
+  }
+
+  /**
+   * @brief Gives h the value x, moving it up or down as needed.
+   */
+  void update(handle h, const value_type& x) {
+    size_type i = _pos[h];
+    if (_comp.comp(_heap[i].value, x))
+      _dary_push_heap(_heap.begin(), i, size_type(0), entry(x, h), _comp,
+                      _track());
+    else
+      _dary_adjust_heap(_heap.begin(), i, size_type(_heap.size()),
+                        entry(x, h), _comp, _track());
+  }
+
+  // Remove the element named by h
+  void erase(handle h) { _remove(_pos[h]); }
+
+  void clear() {
+    _heap.clear();
+    _pos.clear();
+    _free.clear();
+  }
+
+  void swap(indexed_priority_queue& x) {
+    _heap.swap(x._heap);
+    _pos.swap(x._pos);
+    _free.swap(x._free);
+    ft::swap(_comp, x._comp);
+  }
+
+  //!@}
+
+private:
+  track_position _track() {
+    track_position t = { &_pos[0] };
+    return t;
+  }
+
+  // removes the entry at heap position i, filling the gap with the last one
+  void _remove(size_type i) {
+    handle h = _heap[i].id;
+    _free.push_back(h); // may throw, so do it before touching the heap
+    _pos[h] = npos;
+    entry last = _heap.back();
+    _heap.pop_back();
+    if (i == _heap.size())
+      return;
+    if (_comp(_heap[i], last))
+      _dary_push_heap(_heap.begin(), i, size_type(0), last, _comp, _track());
+    else
+      _dary_adjust_heap(_heap.begin(), i, size_type(_heap.size()), last, _comp,
+                        _track());
+  }
+};
+
+template <class T, class Compare, class Alloc>
+const typename indexed_priority_queue<T, Compare, Alloc>::size_type
+    indexed_priority_queue<T, Compare, Alloc>::npos;
+
+template <class T, class Compare, class Alloc>
+inline void swap(indexed_priority_queue<T, Compare, Alloc>& x,
+                 indexed_priority_queue<T, Compare, Alloc>& y) {
+  x.swap(y);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __PRIORITY_QUEUE_HPP__ */
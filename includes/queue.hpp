@@ -0,0 +1,105 @@
+#ifndef __QUEUE_HPP__
+#define __QUEUE_HPP__
+
+#include "ring_buffer.hpp"
+
+namespace ft {
+
+template <class T, class Container = ft::ring_buffer<T> >
+class queue {
+public:
+  typedef Container                                  container_type;
+  typedef typename container_type::value_type&       reference;
+  typedef const typename container_type::value_type& const_reference;
+  typedef typename container_type::value_type        value_type;
+  typedef typename container_type::size_type         size_type;
+
+protected:
+  Container c;
+
+public:
+  explicit queue(const Container& c = Container()) : c(c) { }
+  ~queue() { }
+  queue(const queue& q) : c(q.c) { }
+  queue& operator=(const queue& q) {
+    c = q.c;
+    return *this;
+  }
+
+  // Test whether container is empty
+  bool empty() const { return c.empty(); }
+
+  // Return size
+  size_type size() const { return c.size(); }
+
+  // Heap memory of the underlying container (ft containers only)
+  memory_stats memory_usage() const { return c.memory_usage(); }
+
+  // Access next element
+  reference       front() { return c.front(); }
+  const_reference front() const { return c.front(); }
+
+  // Access last element
+  reference       back() { return c.back(); }
+  const_reference back() const { return c.back(); }
+
+  // 	Insert element
+  void push(const value_type& x) { c.push_back(x); }
+
+  // Remove next element
+  void pop() { c.pop_front(); }
+
+private:
+  template <typename T1, typename Container1>
+  friend bool operator==(const queue<T1, Container1>&,
+                         const queue<T1, Container1>&);
+
+  template <typename T1, typename Container1>
+  friend bool operator<(const queue<T1, Container1>&,
+                        const queue<T1, Container1>&);
+
+}; /* class queue */
+
+//!@{ Non-member functions /////////////////////////////////////////////////////
+
+template <typename T, typename Container>
+inline bool operator==(const queue<T, Container>& lhs,
+                       const queue<T, Container>& rhs) {
+  return lhs.c == rhs.c;
+}
+
+template <typename T, typename Container>
+inline bool operator!=(const queue<T, Container>& lhs,
+                       const queue<T, Container>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename Container>
+inline bool operator<(const queue<T, Container>& lhs,
+                      const queue<T, Container>& rhs) {
+  return lhs.c < rhs.c;
+}
+
+template <typename T, typename Container>
+inline bool operator<=(const queue<T, Container>& lhs,
+                       const queue<T, Container>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, typename Container>
+inline bool operator>(const queue<T, Container>& lhs,
+                      const queue<T, Container>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, typename Container>
+inline bool operator>=(const queue<T, Container>& lhs,
+                       const queue<T, Container>& rhs) {
+  return !(lhs < rhs);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __QUEUE_HPP__ */
@@ -6,9 +6,20 @@
 #ifndef _RB_TREE_HPP__
 #define _RB_TREE_HPP__
 
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include "algobase.hpp"
+#include "bloom_filter.hpp"
+#include "compressed_pair.hpp"
+#include "hooks.hpp"
+#include "iterator.hpp"
+#include "memory_stats.hpp"
 #include "pair.hpp"
+#include "type_traits.hpp"
+#include "vector.hpp"
 
 namespace ft {
 
@@ -182,8 +193,10 @@ inline bool operator!=(const rb_tree_iterator<Val, Val&, Val*>&             x,
  * 
  * x와 y(노드 x의 오른쪽 자식)의 부모-자식 관계를 바꾼다.
 */
+template <typename Hooks>
 inline void rb_tree_rotate_left(rb_tree_node_base*  x,
                                 rb_tree_node_base*& root) {
+  Hooks::rotate_left(x);
   rb_tree_node_base* y = x->right;
   x->right = y->left;
   if (y->left != 0)
@@ -207,8 +220,10 @@ inline void rb_tree_rotate_left(rb_tree_node_base*  x,
  * 
  * x와 y(노드 x의 왼쪽 자식)의 부모-자식 관계를 바꾼다.
 */
+template <typename Hooks>
 inline void rb_tree_rotate_right(rb_tree_node_base*  x,
                                  rb_tree_node_base*& root) {
+  Hooks::rotate_right(x);
   rb_tree_node_base* y = x->left;
   x->left = y->right;
   if (y->right != 0)
@@ -225,12 +240,24 @@ inline void rb_tree_rotate_right(rb_tree_node_base*  x,
   x->parent = y;
 }
 
+/**
+ * @brief 재조정 중 노드의 색을 바꾼다. 색이 실제로 바뀔 때만 훅을 호출한다.
+ */
+template <typename Hooks>
+inline void rb_tree_recolor(rb_tree_node_base* x, rb_tree_color c) {
+  if (x->color != c)
+    Hooks::recolor(x);
+  x->color = c;
+}
+
 /**
  * @brief 트리에 노드 삽입 후, 균형을 유지하기 위한 함수
  * @param x 새로 추가된 노드
  * @param root 트리의 루트 노드
 */
+template <typename Hooks>
 inline void rb_tree_rebalance(rb_tree_node_base* x, rb_tree_node_base*& root) {
+  Hooks::insert_rebalance(x);
   x->color = red;
   while (x != root && x->parent->color == red) {
     rb_tree_node_base* x_grandparent = x->parent->parent;
@@ -241,38 +268,38 @@ inline void rb_tree_rebalance(rb_tree_node_base* x, rb_tree_node_base*& root) {
 
       // 삼촌 노드가 존재하고, 삼촌 노드가 빨간색인 경우
       if (y && y->color == red) {
-        x->parent->color = black;
-        y->color = black;
-        x_grandparent->color = red;
+        rb_tree_recolor<Hooks>(x->parent, black);
+        rb_tree_recolor<Hooks>(y, black);
+        rb_tree_recolor<Hooks>(x_grandparent, red);
         x = x_grandparent;
       } else {
         if (x == x->parent->right) {
           x = x->parent;
-          rb_tree_rotate_left(x, root);
+          rb_tree_rotate_left<Hooks>(x, root);
         }
-        x->parent->color = black;
-        x_grandparent->color = red;
-        rb_tree_rotate_right(x_grandparent, root);
+        rb_tree_recolor<Hooks>(x->parent, black);
+        rb_tree_recolor<Hooks>(x_grandparent, red);
+        rb_tree_rotate_right<Hooks>(x_grandparent, root);
       }
     } else { // x의 부모가 x의 조부모의 오른쪽 자식인 경우
       rb_tree_node_base* y = x_grandparent->left;
       if (y && y->color == red) {
-        x->parent->color = black;
-        y->color = black;
-        x_grandparent->color = red;
+        rb_tree_recolor<Hooks>(x->parent, black);
+        rb_tree_recolor<Hooks>(y, black);
+        rb_tree_recolor<Hooks>(x_grandparent, red);
         x = x_grandparent;
       } else {
         if (x == x->parent->left) {
           x = x->parent;
-          rb_tree_rotate_right(x, root);
+          rb_tree_rotate_right<Hooks>(x, root);
         }
-        x->parent->color = black;
-        x_grandparent->color = red;
-        rb_tree_rotate_left(x_grandparent, root);
+        rb_tree_recolor<Hooks>(x->parent, black);
+        rb_tree_recolor<Hooks>(x_grandparent, red);
+        rb_tree_rotate_left<Hooks>(x_grandparent, root);
       }
     }
   }
-  root->color = black;
+  rb_tree_recolor<Hooks>(root, black);
 }
 
 /**
@@ -282,10 +309,12 @@ inline void rb_tree_rebalance(rb_tree_node_base* x, rb_tree_node_base*& root) {
  * @param leftmost 트리의 가장 왼쪽 노드
  * @param rightmost 트리의 가장 오른쪽 노드
 */
+template <typename Hooks>
 inline rb_tree_node_base*
 rb_tree_rebalance_for_erase(rb_tree_node_base* z, rb_tree_node_base*& root,
                             rb_tree_node_base*& leftmost,
                             rb_tree_node_base*& rightmost) {
+  Hooks::erase_rebalance(z);
   rb_tree_node_base* y = z;
   rb_tree_node_base* x = 0;
   rb_tree_node_base* xparent = 0;
@@ -350,75 +379,82 @@ rb_tree_rebalance_for_erase(rb_tree_node_base* z, rb_tree_node_base*& root,
       if (x == xparent->left) {
         rb_tree_node_base* w = xparent->right;
         if (w->color == red) {
-          w->color = black;
-          xparent->color = red;
-          rb_tree_rotate_left(xparent, root);
+          rb_tree_recolor<Hooks>(w, black);
+          rb_tree_recolor<Hooks>(xparent, red);
+          rb_tree_rotate_left<Hooks>(xparent, root);
           w = xparent->right;
         }
         if ((w->left == 0 || w->left->color == black) &&
             (w->right == 0 || w->right->color == black)) {
-          w->color = red;
+          rb_tree_recolor<Hooks>(w, red);
           x = xparent;
           xparent = xparent->parent;
         } else {
           if (w->right == 0 || w->right->color == black) {
-            w->left->color = black;
-            w->color = red;
-            rb_tree_rotate_right(w, root);
+            rb_tree_recolor<Hooks>(w->left, black);
+            rb_tree_recolor<Hooks>(w, red);
+            rb_tree_rotate_right<Hooks>(w, root);
             w = xparent->right;
           }
-          w->color = xparent->color;
-          xparent->color = black;
+          rb_tree_recolor<Hooks>(w, xparent->color);
+          rb_tree_recolor<Hooks>(xparent, black);
           if (w->right)
-            w->right->color = black;
-          rb_tree_rotate_left(xparent, root);
+            rb_tree_recolor<Hooks>(w->right, black);
+          rb_tree_rotate_left<Hooks>(xparent, root);
           break;
         }
       } else {
         // 위의 if문과 동일한 로직, 좌우 반전의 경우
         rb_tree_node_base* w = xparent->left;
         if (w->color == red) {
-          w->color = black;
-          xparent->color = red;
-          rb_tree_rotate_right(xparent, root);
+          rb_tree_recolor<Hooks>(w, black);
+          rb_tree_recolor<Hooks>(xparent, red);
+          rb_tree_rotate_right<Hooks>(xparent, root);
           w = xparent->left;
         }
         if ((w->right == 0 || w->right->color == black) &&
             (w->left == 0 || w->left->color == black)) {
-          w->color = red;
+          rb_tree_recolor<Hooks>(w, red);
           x = xparent;
           xparent = xparent->parent;
         } else {
           if (w->left == 0 || w->left->color == black) {
-            w->right->color = black;
-            w->color = red;
-            rb_tree_rotate_left(w, root);
+            rb_tree_recolor<Hooks>(w->right, black);
+            rb_tree_recolor<Hooks>(w, red);
+            rb_tree_rotate_left<Hooks>(w, root);
             w = xparent->left;
           }
-          w->color = xparent->color;
-          xparent->color = black;
+          rb_tree_recolor<Hooks>(w, xparent->color);
+          rb_tree_recolor<Hooks>(xparent, black);
           if (w->left)
-            w->left->color = black;
-          rb_tree_rotate_right(xparent, root);
+            rb_tree_recolor<Hooks>(w->left, black);
+          rb_tree_rotate_right<Hooks>(xparent, root);
           break;
         }
       }
     if (x)
-      x->color = black;
+      rb_tree_recolor<Hooks>(x, black);
   }
   return y;
 }
 
 //!@{ Tree /////////////////////////////////////////////////////////////////////
+/**
+ * Hooks is an event policy (see hooks.hpp) called on rotations, recolors,
+ * rebalancing and node allocation; the default null_hooks costs nothing.
+ */
 template <typename Key, typename Val, typename KeyOfValue,
           typename Compare = std::less<Key>,
-          typename Alloc = std::allocator<Val> >
+          typename Alloc = std::allocator<Val>,
+          typename Hooks = null_hooks>
 class rb_tree {
-  typename Alloc::template rebind<rb_tree_node<Val> >::other node_allocator;
+  typedef typename Alloc::template rebind<rb_tree_node<Val> >::other
+      node_allocator_type;
 
 protected:
   typedef rb_tree_node_base* base_ptr;
-  typedef rb_tree_node<Val>  rb_tree_node;
+  typedef ft::rb_tree_node<Val> node_type;
+  typedef key_bloom_filter<Key> bloom_type;
 
   rb_tree_node_base  m_header;
 
@@ -429,20 +465,22 @@ public:
   typedef const value_type* const_pointer;
   typedef value_type&       reference;
   typedef const value_type& const_reference;
-  typedef rb_tree_node*     link_type;
+  typedef node_type*        link_type;
   typedef size_t            size_type;
   typedef ptrdiff_t         difference_type;
 
   typedef typename Alloc::template rebind<Val>::other allocator_type;
-  allocator_type get_allocator() const { return node_allocator; }
+  allocator_type get_allocator() const { return node_allocator(); }
 
 protected:
   link_type create_node(const value_type& x) {
-    link_type tmp = node_allocator.allocate(1);
+    link_type tmp = node_allocator().allocate(1);
+    Hooks::node_allocate(tmp, sizeof(node_type));
     try {
       get_allocator().construct(&tmp->m_value_field, x);
     } catch(std::exception& e) {
-      node_allocator.deallocate(tmp, 1);
+      Hooks::node_deallocate(tmp, sizeof(node_type));
+      node_allocator().deallocate(tmp, 1);
       throw;
     }
     return tmp;
@@ -457,12 +495,33 @@ protected:
   }
 
   void destroy_node(link_type p) {
-    node_allocator.destroy(p);
-    node_allocator.deallocate(p, 1);
+    node_allocator().destroy(p);
+    Hooks::node_deallocate(p, sizeof(node_type));
+    node_allocator().deallocate(p, 1);
   }
 
-  size_type m_node_count;
-  Compare   m_key_compare;
+  /*
+   * The allocator and the comparator are usually stateless; each shares its
+   * storage with a pointer-sized member through the empty base optimization,
+   * so they add no bytes to the tree. The optional negative-lookup filter is
+   * null until enable_bloom_filter().
+   */
+  compressed_pair<node_allocator_type, size_type> m_alloc_and_count;
+  compressed_pair<Compare, bloom_type*> m_compare_and_bloom;
+
+  node_allocator_type& node_allocator() { return m_alloc_and_count.first(); }
+  const node_allocator_type& node_allocator() const {
+    return m_alloc_and_count.first();
+  }
+  size_type&     m_node_count() { return m_alloc_and_count.second(); }
+  size_type      m_node_count() const { return m_alloc_and_count.second(); }
+  Compare&       m_key_compare() { return m_compare_and_bloom.first(); }
+  const Compare& m_key_compare() const { return m_compare_and_bloom.first(); }
+
+  bloom_type*& m_bloom() { return m_compare_and_bloom.second(); }
+  bloom_type*  m_bloom() const {
+    return m_compare_and_bloom.second();
+  }
 
   link_type& m_root() const { return (link_type&)this->m_header.parent; }
   link_type& m_leftmost() const { return (link_type&)this->m_header.left; }
@@ -515,7 +574,7 @@ private:
     link_type z;
 
     if (y == &m_header || x != 0 ||
-        m_key_compare(KeyOfValue()(v), s_key(y))) {
+        m_key_compare()(KeyOfValue()(v), s_key(y))) {
       z = create_node(v);
       s_left(y) = z;
       if (y == &m_header) {
@@ -532,8 +591,10 @@ private:
     s_parent(z) = y;
     s_left(z) = 0;
     s_right(z) = 0;
-    rb_tree_rebalance(z, this->m_header.parent);
-    ++m_node_count;
+    rb_tree_rebalance<Hooks>(z, this->m_header.parent);
+    ++m_node_count();
+    if (m_bloom())
+      m_bloom_insert(KeyOfValue()(v));
     return iterator(z);
   }
 
@@ -568,6 +629,91 @@ private:
     return top;
   }
 
+  /**
+   * @brief 필터가 키의 부재를 보장하면 true를 반환한다.
+   * 필터를 읽기만 하고 카운터는 원자적으로 올리므로, const 조회는 여러
+   * 스레드에서 동시에 해도 된다.
+   */
+  bool m_bloom_rejects(const keytype& k) const {
+    if (m_bloom() == 0)
+      return false;
+    bloom_type::count(m_bloom()->stats.lookups);
+    if (m_bloom()->may_contain(m_bloom()->hash(k)))
+      return false;
+    bloom_type::count(m_bloom()->stats.misses_avoided);
+    return true;
+  }
+
+  void m_bloom_false_positive() const {
+    if (m_bloom())
+      bloom_type::count(m_bloom()->stats.false_positives);
+  }
+
+  void m_bloom_rebuild() {
+    m_bloom()->reset(m_node_count());
+    for (const_iterator it = begin(); it != end(); ++it)
+      m_bloom()->insert(m_bloom()->hash(KeyOfValue()(*it)));
+  }
+
+  /*
+   * Inserts and erases rebuild the filter, once the tree outgrew it or a
+   * quarter of its keys are gone, so that lookups never write to it.
+   */
+  void m_bloom_insert(const keytype& k) {
+    if (m_bloom()->needs_rebuild(m_node_count())) {
+      m_bloom_rebuild();
+      ++m_bloom()->stats.rebuilds;
+    } else
+      m_bloom()->insert(m_bloom()->hash(k));
+  }
+
+  void m_bloom_erase() {
+    m_bloom()->note_erase();
+    if (m_bloom()->needs_rebuild(m_node_count())) {
+      m_bloom_rebuild();
+      ++m_bloom()->stats.rebuilds;
+    }
+  }
+
+  /**
+   * @brief Builds the subtree of the next n values from first, in order.
+   * @param prev last node built so far, 0 before the first one
+   */
+  template <typename InputIterator>
+  link_type m_build_sorted(InputIterator& first, size_type n, size_type depth,
+                           size_type red_depth, link_type& prev) {
+    if (n == 0)
+      return 0;
+    size_type half = (n - 1) / 2;
+    link_type left = m_build_sorted(first, half, depth + 1, red_depth, prev);
+    link_type x;
+    try {
+      x = create_node(*first);
+    } catch (...) {
+      erase_without_rebalancing(left);
+      throw;
+    }
+    s_left(x) = left;
+    s_right(x) = 0;
+    if (left)
+      s_parent(left) = x;
+    s_color(x) = depth == red_depth ? red : black;
+    try {
+      ++first;
+      if (prev != 0 && !m_key_compare()(s_key(prev), s_key(x)))
+        throw std::invalid_argument("rb_tree: keys out of order");
+      prev = x;
+      s_right(x) =
+          m_build_sorted(first, n - 1 - half, depth + 1, red_depth, prev);
+    } catch (...) {
+      erase_without_rebalancing(x);
+      throw;
+    }
+    if (s_right(x))
+      s_parent(s_right(x)) = x;
+    return x;
+  }
+
   void erase_without_rebalancing(link_type x) {
     while (x != 0) {
       erase_without_rebalancing(s_right(x));
@@ -580,23 +726,26 @@ private:
 public:
   // allocation/deallocation
   rb_tree()
-      : node_allocator(allocator_type()), m_node_count(0), m_key_compare() {
+      : m_alloc_and_count(node_allocator_type(), 0),
+        m_compare_and_bloom(Compare(), 0) {
     empty_initialize();
   }
 
   rb_tree(const Compare& comp)
-      : node_allocator(allocator_type()), m_node_count(0), m_key_compare(comp) {
+      : m_alloc_and_count(node_allocator_type(), 0),
+        m_compare_and_bloom(comp, 0) {
     empty_initialize();
   }
 
   rb_tree(const Compare& comp, const allocator_type& a)
-      : node_allocator(a), m_node_count(0), m_key_compare(comp) {
+      : m_alloc_and_count(node_allocator_type(a), 0),
+        m_compare_and_bloom(comp, 0) {
     empty_initialize();
   }
 
-  rb_tree(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x)
-      : node_allocator(x.get_allocator()), m_node_count(0),
-        m_key_compare(x.m_key_compare) {
+  rb_tree(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x)
+      : m_alloc_and_count(x.node_allocator(), 0),
+        m_compare_and_bloom(x.m_key_compare(), 0) {
     if (x.m_root() == 0)
       empty_initialize();
     else {
@@ -605,17 +754,22 @@ public:
       m_leftmost() = find_minimum(m_root());
       m_rightmost() = find_maximum(m_root());
     }
-    m_node_count = x.m_node_count;
+    m_node_count() = x.m_node_count();
+    if (x.m_bloom())
+      m_bloom() = new bloom_type(*x.m_bloom());
   }
 
-  ~rb_tree() { clear(); }
+  ~rb_tree() {
+    clear();
+    delete m_bloom();
+  }
 
-  rb_tree<Key, Val, KeyOfValue, Compare, Alloc>&
-  operator=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x) {
+  rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>&
+  operator=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x) {
     if (this != &x) {
       clear();
-      m_node_count = 0;
-      m_key_compare = x.m_key_compare;
+      m_node_count() = 0;
+      m_key_compare() = x.m_key_compare();
       if (x.m_root() == 0) {
         m_root() = 0;
         m_leftmost() = m_end();
@@ -624,8 +778,12 @@ public:
         m_root() = m_copy(x.m_root(), m_end());
         m_leftmost() = find_minimum(m_root());
         m_rightmost() = find_maximum(m_root());
-        m_node_count = x.m_node_count;
+        m_node_count() = x.m_node_count();
       }
+      delete m_bloom();
+      m_bloom() = 0;
+      if (x.m_bloom())
+        m_bloom() = new bloom_type(*x.m_bloom());
     }
     return *this;
   }
@@ -649,17 +807,17 @@ public:
   reverse_iterator rend() { return reverse_iterator(begin()); }
   const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
 
-  Compare key_comp() const { return m_key_compare; }
+  Compare key_comp() const { return m_key_compare(); }
 
-  bool empty() const { return m_node_count == 0; }
+  bool empty() const { return m_node_count() == 0; }
 
-  size_type size() const { return m_node_count; }
+  size_type size() const { return m_node_count(); }
 
   size_type max_size() const {
     return std::numeric_limits<difference_type>::max();
   }
 
-  void swap(rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& t) {
+  void swap(rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& t) {
     if (m_root() == 0) {
       if (t.m_root() != 0) {
         m_root() = t.m_root();
@@ -688,8 +846,10 @@ public:
       m_root()->parent = m_end();
       t.m_root()->parent = t.m_end();
     }
-    ft::swap(this->m_node_count, t.m_node_count);
-    ft::swap(this->m_key_compare, t.m_key_compare);
+    ft::swap(this->node_allocator(), t.node_allocator());
+    ft::swap(this->m_node_count(), t.m_node_count());
+    ft::swap(this->m_key_compare(), t.m_key_compare());
+    ft::swap(this->m_bloom(), t.m_bloom());
   }
 
   // Insert/erase.
@@ -700,7 +860,7 @@ public:
     bool      comp = true;
     while (x != 0) {
       y = x;
-      comp = m_key_compare(KeyOfValue()(v), s_key(x));
+      comp = m_key_compare()(KeyOfValue()(v), s_key(x));
       x = comp ? s_left(x) : s_right(x);
     }
     iterator j = iterator(y);
@@ -710,7 +870,7 @@ public:
       else
         --j;
     }
-    if (m_key_compare(s_key(j.current_node), KeyOfValue()(v)))
+    if (m_key_compare()(s_key(j.current_node), KeyOfValue()(v)))
       return pair<iterator, bool>(m_insert(x, y, v), true);
     return pair<iterator, bool>(j, false);
   }
@@ -720,27 +880,27 @@ public:
     link_type x = m_root();
     while (x != 0) {
       y = x;
-      x = m_key_compare(KeyOfValue()(v), s_key(x)) ? s_left(x) : s_right(x);
+      x = m_key_compare()(KeyOfValue()(v), s_key(x)) ? s_left(x) : s_right(x);
     }
     return m_insert(x, y, v);
   }
 
   iterator insert_unique(iterator position, const value_type& v) {
     if (position.current_node == this->m_header.left) {
-      if (size() > 0 && m_key_compare(KeyOfValue()(v), s_key(position.current_node)))
+      if (size() > 0 && m_key_compare()(KeyOfValue()(v), s_key(position.current_node)))
         return m_insert(position.current_node, position.current_node, v);
       else
         return insert_unique(v).first;
     } else if (position.current_node == &m_header) {
-      if (m_key_compare(s_key(m_rightmost()), KeyOfValue()(v)))
+      if (m_key_compare()(s_key(m_rightmost()), KeyOfValue()(v)))
         return m_insert(0, m_rightmost(), v);
       else
         return insert_unique(v).first;
     } else {
       iterator before = position;
       --before;
-      if (m_key_compare(s_key(before.current_node), KeyOfValue()(v)) &&
-          m_key_compare(KeyOfValue()(v), s_key(position.current_node))) {
+      if (m_key_compare()(s_key(before.current_node), KeyOfValue()(v)) &&
+          m_key_compare()(KeyOfValue()(v), s_key(position.current_node))) {
         if (s_right(before.current_node) == 0)
           return m_insert(0, before.current_node, v);
         else
@@ -752,20 +912,20 @@ public:
 
   iterator insert_equal(iterator position, const value_type& v) {
     if (position.current_node == this->m_header.left) {
-      if (size() > 0 && !m_key_compare(s_key(position.current_node), KeyOfValue()(v)))
+      if (size() > 0 && !m_key_compare()(s_key(position.current_node), KeyOfValue()(v)))
         return m_insert(position.current_node, position.current_node, v);
       else
         return insert_equal(v);
     } else if (position.current_node == &m_header) {
-      if (!m_key_compare(KeyOfValue()(v), s_key(m_rightmost())))
+      if (!m_key_compare()(KeyOfValue()(v), s_key(m_rightmost())))
         return m_insert(0, m_rightmost(), v);
       else
         return insert_equal(v);
     } else {
       iterator before = position;
       --before;
-      if (!m_key_compare(KeyOfValue()(v), s_key(before.current_node)) &&
-          !m_key_compare(s_key(position.current_node), KeyOfValue()(v))) {
+      if (!m_key_compare()(KeyOfValue()(v), s_key(before.current_node)) &&
+          !m_key_compare()(s_key(position.current_node), KeyOfValue()(v))) {
         if (s_right(before.current_node) == 0)
           return m_insert(0, before.current_node, v);
         else
@@ -788,16 +948,18 @@ public:
   }
 
   inline void erase(iterator position) {
-    link_type y = (link_type)rb_tree_rebalance_for_erase(
+    link_type y = (link_type)rb_tree_rebalance_for_erase<Hooks>(
         position.current_node, this->m_header.parent, this->m_header.left,
         this->m_header.right);
     destroy_node(y);
-    --m_node_count;
+    --m_node_count();
+    if (m_bloom())
+      m_bloom_erase();
   }
 
   size_type erase(const keytype& x) {
     pair<iterator, iterator> p = equal_range(x);
-    size_type                n = std::distance(p.first, p.second);
+    size_type                n = ft::distance(p.first, p.second);
     erase(p.first, p.second);
     return n;
   }
@@ -815,49 +977,111 @@ public:
       erase(*first++);
   }
 
+  /**
+   * @brief Removes every node. With a monotonic allocator (arena_allocator)
+   * and trivially destructible values the nodes are simply abandoned to the
+   * arena, so this only resets the header. Hooks other than null_hooks see
+   * every node deallocated, so they take the slow path.
+   */
   void clear() {
-    if (m_node_count != 0) {
-      erase_without_rebalancing(m_root());
+    if (m_node_count() != 0) {
+      if (m_bloom())
+        m_bloom()->reset(m_node_count());
+      if (!(is_monotonic_allocator<Alloc>::value &&
+            is_trivially_destructible<Val>::value &&
+            is_same<Hooks, null_hooks>::value))
+        erase_without_rebalancing(m_root());
       m_leftmost() = m_end();
       m_root() = 0;
       m_rightmost() = m_end();
-      m_node_count = 0;
+      m_node_count() = 0;
+    }
+  }
+
+  /**
+   * @brief Replaces the contents with the n values read from first, whose
+   * keys must be strictly increasing. The tree is linked up directly in
+   * O(n), with no descent and no rebalancing: each subtree takes the middle
+   * value of its run, so the tree is perfectly balanced, and the nodes of
+   * the last level are red when that level is incomplete, black otherwise.
+   * The only comparisons check each key against the previous one.
+   * @throw std::invalid_argument when the keys are out of order; on any
+   * exception the tree keeps its old contents
+   */
+  template <typename InputIterator>
+  void assign_sorted_unique(InputIterator first, size_type n) {
+    link_type root = 0;
+    link_type last = 0;
+    if (n != 0) {
+      size_type depth = 0; // of the last level, floor(log2(n))
+      while (n >> (depth + 1))
+        ++depth;
+      size_type red_depth = (n & (n + 1)) == 0 ? size_type(-1) : depth;
+      root = m_build_sorted(first, n, 0, red_depth, last);
     }
+    clear();
+    if (root == 0)
+      return;
+    m_root() = root;
+    s_parent(root) = m_end();
+    m_leftmost() = find_minimum(root);
+    m_rightmost() = last;
+    m_node_count() = n;
+    if (m_bloom())
+      m_bloom_rebuild();
   }
 
   // Set operations.
 
   iterator find(const keytype& k) {
+    if (m_bloom_rejects(k))
+      return end();
+
     link_type y = m_end();
     link_type x = m_root();
 
     while (x != 0)
-      if (!m_key_compare(s_key(x), k))
+      if (!m_key_compare()(s_key(x), k))
         y = x, x = s_left(x);
       else
         x = s_right(x);
 
     iterator j = iterator(y);
-    return (j == end() || m_key_compare(k, s_key(j.current_node))) ? end() : j;
+    if (j == end() || m_key_compare()(k, s_key(j.current_node))) {
+      m_bloom_false_positive();
+      return end();
+    }
+    return j;
   }
 
   const_iterator find(const keytype& k) const {
+    if (m_bloom_rejects(k))
+      return end();
+
     link_type y = m_end();
     link_type x = m_root();
 
     while (x != 0) {
-      if (!m_key_compare(s_key(x), k))
+      if (!m_key_compare()(s_key(x), k))
         y = x, x = s_left(x);
       else
         x = s_right(x);
     }
     const_iterator j = const_iterator(y);
-    return (j == end() || m_key_compare(k, s_key(j.current_node))) ? end() : j;
+    if (j == end() || m_key_compare()(k, s_key(j.current_node))) {
+      m_bloom_false_positive();
+      return end();
+    }
+    return j;
   }
 
   size_type count(const keytype& k) const {
+    if (m_bloom_rejects(k))
+      return 0;
     pair<const_iterator, const_iterator> p = equal_range(k);
-    size_type                            n = std::distance(p.first, p.second);
+    size_type                            n = ft::distance(p.first, p.second);
+    if (n == 0)
+      m_bloom_false_positive();
     return n;
   }
 
@@ -866,7 +1090,7 @@ public:
     link_type x = m_root();
 
     while (x != 0)
-      if (!m_key_compare(s_key(x), k))
+      if (!m_key_compare()(s_key(x), k))
         y = x, x = s_left(x);
       else
         x = s_right(x);
@@ -879,7 +1103,7 @@ public:
     link_type x = m_root();
 
     while (x != 0)
-      if (!m_key_compare(s_key(x), k))
+      if (!m_key_compare()(s_key(x), k))
         y = x, x = s_left(x);
       else
         x = s_right(x);
@@ -892,7 +1116,7 @@ public:
     link_type x = m_root();
 
     while (x != 0)
-      if (m_key_compare(k, s_key(x)))
+      if (m_key_compare()(k, s_key(x)))
         y = x, x = s_left(x);
       else
         x = s_right(x);
@@ -905,7 +1129,7 @@ public:
     link_type x = m_root();
 
     while (x != 0)
-      if (m_key_compare(k, s_key(x)))
+      if (m_key_compare()(k, s_key(x)))
         y = x, x = s_left(x);
       else
         x = s_right(x);
@@ -921,54 +1145,277 @@ public:
   equal_range(const keytype& k) const {
     return pair<const_iterator, const_iterator>(lower_bound(k), upper_bound(k));
   }
+
+  // Lookup filter.
+
+  typedef typename bloom_type::hash_function bloom_hash_function;
+
+  /**
+   * @brief Builds a blocked Bloom filter over the current keys. find() and
+   * count() consult it first and return a definite miss without descending
+   * the tree. Inserts keep it up to date; erases are counted and the filter is
+   * rebuilt by the erase that removes a quarter of the keys. Lookups only
+   * read it, so const lookups stay safe from several threads at once.
+   *
+   * The filter hashes keys with bloom_hash, which is only sound when Compare
+   * finds keys equivalent exactly when they are equal: std::less and
+   * std::greater. Other comparators take the overload with a hash.
+   * @param bits_per_key filter density; 10 gives about 1% false positives
+   * @return false if Key has no bloom_hash specialization or Compare is not
+   * std::less<Key> or std::greater<Key>
+   */
+  bool enable_bloom_filter(size_type bits_per_key = 10) {
+    if (!bloom_hash<Key>::enabled || !bloom_value_order<Compare, Key>::value)
+      return false;
+    m_bloom_install(new bloom_type(bits_per_key, 0));
+    return true;
+  }
+
+  /**
+   * @brief Same, hashing keys with hash, which must give the same value to
+   * any two keys that Compare finds equivalent (neither orders before the
+   * other): a case-insensitive comparator needs a case-insensitive hash.
+   * @return false if hash is null
+   */
+  bool enable_bloom_filter(bloom_hash_function hash,
+                           size_type bits_per_key = 10) {
+    if (hash == 0)
+      return false;
+    m_bloom_install(new bloom_type(bits_per_key, hash));
+    return true;
+  }
+
+  void disable_bloom_filter() {
+    delete m_bloom();
+    m_bloom() = 0;
+  }
+
+  bool bloom_filter_enabled() const { return m_bloom() != 0; }
+
+  bloom_filter_stats bloom_stats() const {
+    bloom_filter_stats s = bloom_filter_stats();
+    if (m_bloom())
+      s = m_bloom()->snapshot();
+    return s;
+  }
+
+private:
+  void m_bloom_install(bloom_type* f) {
+    delete m_bloom();
+    m_bloom() = f;
+    m_bloom_rebuild();
+  }
+
+public:
+  /**
+   * @brief Heap bytes held by the nodes and the lookup filter, in O(1).
+   * Everything in a node but the value (colour, three links, padding)
+   * counts as overhead.
+   */
+  memory_stats memory_usage() const {
+    memory_stats s;
+    s.payload_bytes = m_node_count() * sizeof(value_type);
+    s.overhead_bytes =
+        m_node_count() * (sizeof(node_type) - sizeof(value_type));
+    s.allocations = m_node_count();
+    if (m_bloom()) {
+      s.overhead_bytes += sizeof(*m_bloom()) + m_bloom()->memory_bytes();
+      s.allocations += m_bloom()->memory_bytes() != 0 ? 2 : 1;
+    }
+    return s;
+  }
+
+  /**
+   * @brief Height, black height and average depth of the tree: an in-order
+   * walk through the parent links, O(n) time and O(1) space.
+   */
+  tree_shape shape() const {
+    tree_shape               s = tree_shape();
+    const rb_tree_node_base* header = &m_header;
+    const rb_tree_node_base* x = m_header.parent;
+    if (x == 0)
+      return s;
+    for (const rb_tree_node_base* y = x; y != 0; y = y->left)
+      if (y->color == black)
+        ++s.black_height;
+
+    size_t             depth = 1;
+    unsigned long long total = 0;
+    while (x->left != 0)
+      x = x->left, ++depth;
+    for (;;) {
+      total += depth;
+      if (depth > s.height)
+        s.height = depth;
+      if (x->right != 0) {
+        x = x->right, ++depth;
+        while (x->left != 0)
+          x = x->left, ++depth;
+        continue;
+      }
+      const rb_tree_node_base* p = x->parent;
+      while (p != header && x == p->right)
+        x = p, p = p->parent, --depth;
+      if (p == header)
+        break;
+      x = p, --depth;
+    }
+    s.average_depth = double(total) / m_node_count();
+    return s;
+  }
+
+  typedef ft::pair<iterator, iterator>             range_type;
+  typedef ft::pair<const_iterator, const_iterator> const_range_type;
+
+  /**
+   * @brief Cuts the tree into at most k consecutive in-order ranges of
+   * about equal size, for threads to walk one each. Nodes carry no subtree
+   * sizes, so the cut is made on the top levels only: about 16k subtrees and
+   * the nodes above them, each subtree weighted by the length of its outer
+   * spines, grouped greedily into k runs. O(k log n), no walk over the
+   * elements; an empty tree gives no range.
+   */
+  ft::vector<range_type> split_ranges(size_type k) {
+    ft::vector<base_ptr>   bounds = m_split_bounds(k);
+    ft::vector<range_type> out;
+    for (size_type i = 0; i < bounds.size(); ++i)
+      out.push_back(range_type(
+          iterator(static_cast<link_type>(bounds[i])),
+          iterator(i + 1 < bounds.size()
+                       ? static_cast<link_type>(bounds[i + 1])
+                       : m_end())));
+    return out;
+  }
+
+  ft::vector<const_range_type> split_ranges(size_type k) const {
+    ft::vector<base_ptr>         bounds = m_split_bounds(k);
+    ft::vector<const_range_type> out;
+    for (size_type i = 0; i < bounds.size(); ++i)
+      out.push_back(const_range_type(
+          const_iterator(static_cast<link_type>(bounds[i])),
+          const_iterator(i + 1 < bounds.size()
+                             ? static_cast<link_type>(bounds[i + 1])
+                             : m_end())));
+    return out;
+  }
+
+private:
+  // a subtree at the cut depth, or a single node above it
+  struct split_piece {
+    base_ptr first; // first node in order
+    double   weight;
+  };
+
+  // a perfect tree of spine length h holds 2^h - 1 nodes: average that
+  // over the two outer spines
+  static double m_split_weight(base_ptr x) {
+    double left = 1;
+    double right = 1;
+    for (base_ptr y = x; y != 0; y = y->left)
+      left *= 2;
+    for (base_ptr y = x; y != 0; y = y->right)
+      right *= 2;
+    return (left + right) / 2 - 1;
+  }
+
+  static void m_split_collect(base_ptr x, size_t depth, size_t cut,
+                              ft::vector<split_piece>& out) {
+    if (x == 0)
+      return;
+    split_piece p;
+    if (depth == cut) {
+      p.first = rb_tree_node_base::find_minimum(x);
+      p.weight = m_split_weight(x);
+      out.push_back(p);
+      return;
+    }
+    m_split_collect(x->left, depth + 1, cut, out);
+    p.first = x;
+    p.weight = 1;
+    out.push_back(p);
+    m_split_collect(x->right, depth + 1, cut, out);
+  }
+
+  // first node of every range
+  ft::vector<base_ptr> m_split_bounds(size_type k) const {
+    ft::vector<base_ptr> bounds;
+    if (m_header.parent == 0)
+      return bounds;
+    if (k == 0)
+      k = 1;
+    size_t cut = 0;
+    while ((size_t(1) << cut) < 16 * k && cut < 8 * sizeof(size_t) - 3)
+      ++cut;
+    ft::vector<split_piece> pieces;
+    m_split_collect(m_header.parent, 0, cut, pieces);
+
+    double total = 0;
+    for (size_type i = 0; i < pieces.size(); ++i)
+      total += pieces[i].weight;
+    double done = 0;
+    bounds.push_back(pieces[0].first);
+    for (size_type i = 0; i + 1 < pieces.size() && bounds.size() < k; ++i) {
+      done += pieces[i].weight;
+      if (done >= total * bounds.size() / k)
+        bounds.push_back(pieces[i + 1].first);
+    }
+    return bounds;
+  }
 };
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator==(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                       const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
-  return x.size() == y.size() && equal(x.begin(), x.end(), y.begin());
+          typename Alloc, typename Hooks>
+inline bool
+operator==(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+           const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
+  return x.size() == y.size() && ft::equal(x.begin(), x.end(), y.begin());
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator<(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                      const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
-  return lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+          typename Alloc, typename Hooks>
+inline bool
+operator<(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+          const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
+  return ft::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator!=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                       const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
+          typename Alloc, typename Hooks>
+inline bool
+operator!=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+           const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
   return !(x == y);
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator>(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                      const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
+          typename Alloc, typename Hooks>
+inline bool
+operator>(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+          const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
   return y < x;
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator<=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                       const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
+          typename Alloc, typename Hooks>
+inline bool
+operator<=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+           const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
   return !(y < x);
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline bool operator>=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                       const rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
+          typename Alloc, typename Hooks>
+inline bool
+operator>=(const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+           const rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
   return !(x < y);
 }
 
 template <typename Key, typename Val, typename KeyOfValue, typename Compare,
-          typename Alloc>
-inline void swap(rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& x,
-                 rb_tree<Key, Val, KeyOfValue, Compare, Alloc>& y) {
+          typename Alloc, typename Hooks>
+inline void
+swap(rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& x,
+     rb_tree<Key, Val, KeyOfValue, Compare, Alloc, Hooks>& y) {
   x.swap(y);
 }
 
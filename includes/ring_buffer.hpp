@@ -0,0 +1,243 @@
+#ifndef __RING_BUFFER_HPP__
+#define __RING_BUFFER_HPP__
+
+#include <cstddef>
+#include <memory>
+#include "algobase.hpp"
+#include "compressed_pair.hpp"
+#include "memory_stats.hpp"
+
+namespace ft {
+
+/**
+ * @brief Growable circular buffer over one contiguous block: O(1)
+ * push_back, pop_front and pop_back, and random access by position. The
+ * default container of ft::queue. The capacity is a power of two, so
+ * that a position maps to its slot with a mask; it doubles when full and
+ * never shrinks.
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class ring_buffer {
+public:
+  typedef T                                        value_type;
+  typedef Alloc                                    allocator_type;
+  typedef size_t                                   size_type;
+  typedef ptrdiff_t                                difference_type;
+
+  typedef typename allocator_type::reference       reference;
+  typedef typename allocator_type::const_reference const_reference;
+  typedef typename allocator_type::pointer         pointer;
+  typedef typename allocator_type::const_pointer   const_pointer;
+
+private:
+  // the storage and the allocator, which takes no space when stateless
+  compressed_pair<pointer, allocator_type> _buf_alloc;
+  size_type                                _mask; // capacity - 1
+  size_type                                _head; // slot of the front
+  size_type                                _size;
+
+  pointer&              _buf() { return _buf_alloc.first(); }
+  pointer               _buf() const { return _buf_alloc.first(); }
+  allocator_type&       _alloc() { return _buf_alloc.second(); }
+  const allocator_type& _alloc() const { return _buf_alloc.second(); }
+
+public:
+  //!@{ construct/copy/destroy /////////////////////////////////////////////////
+
+  explicit ring_buffer(const allocator_type& a = allocator_type())
+  : _buf_alloc(NULL, a), _mask(0), _head(0), _size(0) { }
+
+  ring_buffer(const ring_buffer& other)
+  : _buf_alloc(NULL, other._alloc()), _mask(0), _head(0), _size(0) {
+    reserve(other._size);
+    for (size_type i = 0; i < other._size; ++i)
+      push_back(other[i]);
+  }
+
+  ~ring_buffer() {
+    clear();
+    if (_buf())
+      _alloc().deallocate(_buf(), capacity());
+  }
+
+  ring_buffer& operator=(const ring_buffer& other) {
+    if (this != &other) {
+      ring_buffer tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return _alloc(); }
+
+  //!@}
+
+  //!@{ Capacity ///////////////////////////////////////////////////////////////
+
+  bool      empty() const { return _size == 0; }
+  size_type size() const { return _size; }
+  size_type capacity() const { return _buf() ? _mask + 1 : 0; }
+
+  size_type max_size() const { return _alloc().max_size(); }
+
+  /**
+   * @brief Makes room for at least n elements without further allocation.
+   */
+  void reserve(size_type n) {
+    if (n > capacity())
+      _reallocate(n);
+  }
+
+  memory_stats memory_usage() const {
+    memory_stats s;
+    s.payload_bytes = size() * sizeof(value_type);
+    s.overhead_bytes = (capacity() - size()) * sizeof(value_type);
+    s.allocations = capacity() != 0;
+    return s;
+  }
+
+  //!@}
+
+  //!@{ Element Access /////////////////////////////////////////////////////////
+
+  // n-th element from the front
+  reference       operator[](size_type n) { return _buf()[_slot(n)]; }
+  const_reference operator[](size_type n) const { return _buf()[_slot(n)]; }
+
+  reference       front() { return _buf()[_head]; }
+  const_reference front() const { return _buf()[_head]; }
+  reference       back() { return _buf()[_slot(_size - 1)]; }
+  const_reference back() const { return _buf()[_slot(_size - 1)]; }
+
+  //!@}
+
+  //!@{ Modifiers //////////////////////////////////////////////////////////////
+
+  void push_back(const value_type& x) {
+    if (_size == capacity()) {
+      value_type copy(x); // x may live in the block about to be freed
+      _reallocate(_size + 1);
+      _alloc().construct(_buf() + _slot(_size), copy);
+    } else
+      _alloc().construct(_buf() + _slot(_size), x);
+    ++_size;
+  }
+
+  void pop_front() {
+    _alloc().destroy(_buf() + _head);
+    _head = (_head + 1) & _mask;
+    --_size;
+  }
+
+  void pop_back() {
+    _alloc().destroy(_buf() + _slot(_size - 1));
+    --_size;
+  }
+
+  void clear() {
+    while (_size != 0)
+      pop_back();
+    _head = 0;
+  }
+
+  void swap(ring_buffer& x) {
+    ft::swap(_alloc(), x._alloc());
+    ft::swap(_buf(), x._buf());
+    ft::swap(_mask, x._mask);
+    ft::swap(_head, x._head);
+    ft::swap(_size, x._size);
+  }
+
+  //!@}
+
+private:
+  size_type _slot(size_type n) const { return (_head + n) & _mask; }
+
+  // moves the elements, front first, into a block of at least n slots
+  void _reallocate(size_type n) {
+    size_type capacity = 1;
+    while (capacity < n)
+      capacity *= 2;
+    pointer buf = _alloc().allocate(capacity);
+    size_type i = 0;
+    try {
+      for (; i < _size; ++i)
+        _alloc().construct(buf + i, (*this)[i]);
+    } catch (...) {
+      while (i != 0)
+        _alloc().destroy(buf + --i);
+      _alloc().deallocate(buf, capacity);
+      throw;
+    }
+    size_type old_size = _size;
+    size_type old_capacity = this->capacity();
+    clear();
+    if (_buf())
+      _alloc().deallocate(_buf(), old_capacity);
+    _buf() = buf;
+    _mask = capacity - 1;
+    _head = 0;
+    _size = old_size;
+  }
+};
+
+//!@{ Non-member functions /////////////////////////////////////////////////////
+
+template <typename T, typename Alloc>
+inline bool operator==(const ring_buffer<T, Alloc>& lhs,
+                       const ring_buffer<T, Alloc>& rhs) {
+  if (lhs.size() != rhs.size())
+    return false;
+  for (size_t i = 0; i < lhs.size(); ++i)
+    if (!(lhs[i] == rhs[i]))
+      return false;
+  return true;
+}
+
+template <typename T, typename Alloc>
+inline bool operator!=(const ring_buffer<T, Alloc>& lhs,
+                       const ring_buffer<T, Alloc>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc>
+inline bool operator<(const ring_buffer<T, Alloc>& lhs,
+                      const ring_buffer<T, Alloc>& rhs) {
+  size_t n = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+  for (size_t i = 0; i < n; ++i) {
+    if (lhs[i] < rhs[i])
+      return true;
+    if (rhs[i] < lhs[i])
+      return false;
+  }
+  return lhs.size() < rhs.size();
+}
+
+template <typename T, typename Alloc>
+inline bool operator<=(const ring_buffer<T, Alloc>& lhs,
+                       const ring_buffer<T, Alloc>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, typename Alloc>
+inline bool operator>(const ring_buffer<T, Alloc>& lhs,
+                      const ring_buffer<T, Alloc>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, typename Alloc>
+inline bool operator>=(const ring_buffer<T, Alloc>& lhs,
+                       const ring_buffer<T, Alloc>& rhs) {
+  return !(lhs < rhs);
+}
+
+template <typename T, typename Alloc>
+inline void swap(ring_buffer<T, Alloc>& x, ring_buffer<T, Alloc>& y) {
+  x.swap(y);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __RING_BUFFER_HPP__ */
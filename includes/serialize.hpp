@@ -0,0 +1,371 @@
+#ifndef __SERIALIZE_HPP__
+#define __SERIALIZE_HPP__
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <unistd.h>
+#include "map.hpp"
+#include "pair.hpp"
+#include "set.hpp"
+#include "type_traits.hpp"
+
+namespace ft {
+
+//!@{ Serialization Format /////////////////////////////////////////////////////
+
+/*
+ * A saved map or set is a 24 byte header followed by its elements in key
+ * order, which is what lets load() link the tree up in O(n).
+ *
+ *   header   "FTSR", version, container kind, 2 reserved zero bytes,
+ *            sizeof(value_type) (4 bytes) and element count (8 bytes, after
+ *            4 bytes of padding), in host byte order
+ *   element  the key, then for a map the mapped value, each encoded by
+ *            serial_traits
+ *
+ * serial_traits writes trivially copyable types as their raw bytes and
+ * std::string as a 64-bit length and its characters; specialize it for
+ * other types. Like mmap_vector files, a saved container is only readable on
+ * a machine with the same byte order and type layout.
+ */
+
+enum serial_kind { serial_map = 1, serial_set = 2 };
+
+const unsigned char serial_version = 1;
+
+/**
+ * @brief Encodes T into a sink with write(const void*, size_t) and decodes
+ * it from a source with read(void*, size_t).
+ */
+template <typename T>
+struct serial_traits {
+  // fails to compile for other types: specialize serial_traits for them
+  typedef char _requires_trivially_copyable
+      [is_trivially_copyable<T>::value ? 1 : -1];
+
+  template <typename Sink>
+  static void write(Sink& out, const T& x) { out.write(&x, sizeof(T)); }
+
+  template <typename Source>
+  static T read(Source& in) {
+    T x;
+    in.read(&x, sizeof(T));
+    return x;
+  }
+};
+
+template <typename T>
+struct serial_traits<const T> : serial_traits<T> { };
+
+template <>
+struct serial_traits<std::string> {
+  template <typename Sink>
+  static void write(Sink& out, const std::string& x) {
+    unsigned long long n = x.size();
+    out.write(&n, sizeof(n));
+    out.write(x.data(), x.size());
+  }
+
+  template <typename Source>
+  static std::string read(Source& in) {
+    unsigned long long n;
+    in.read(&n, sizeof(n));
+    std::string x;
+    char        buf[256];
+    while (n != 0) { // in chunks, so that a corrupt length fails as truncated
+      size_t m = n < sizeof(buf) ? size_t(n) : sizeof(buf);
+      in.read(buf, m);
+      x.append(buf, m);
+      n -= m;
+    }
+    return x;
+  }
+};
+
+template <typename T1, typename T2>
+struct serial_traits<pair<T1, T2> > {
+  template <typename Sink>
+  static void write(Sink& out, const pair<T1, T2>& x) {
+    serial_traits<T1>::write(out, x.first);
+    serial_traits<T2>::write(out, x.second);
+  }
+
+  template <typename Source>
+  static pair<T1, T2> read(Source& in) {
+    T1 first = serial_traits<T1>::read(in); // in this order
+    T2 second = serial_traits<T2>::read(in);
+    return pair<T1, T2>(first, second);
+  }
+};
+
+//!@}
+
+//!@{ Sinks and Sources /////////////////////////////////////////////////////////
+
+class serial_ostream_sink {
+public:
+  explicit serial_ostream_sink(std::ostream& out) : _out(out) { }
+
+  void write(const void* p, size_t n) {
+    if (!_out.write(static_cast<const char*>(p), std::streamsize(n)))
+      throw std::runtime_error("ft::save: write failed");
+  }
+
+  void flush() {
+    if (!_out.flush())
+      throw std::runtime_error("ft::save: write failed");
+  }
+
+private:
+  std::ostream& _out;
+};
+
+class serial_istream_source {
+public:
+  explicit serial_istream_source(std::istream& in) : _in(in) { }
+
+  void read(void* p, size_t n) {
+    if (!_in.read(static_cast<char*>(p), std::streamsize(n)))
+      throw std::runtime_error("ft::load: truncated input");
+  }
+
+  void finish() { }
+
+private:
+  std::istream& _in;
+};
+
+/**
+ * @brief Buffers writes to a file descriptor, so that small elements do not
+ * cost a system call each.
+ */
+class serial_fd_sink {
+public:
+  explicit serial_fd_sink(int fd) : _fd(fd), _used(0) { }
+
+  void write(const void* p, size_t n) {
+    if (n > sizeof(_buf) - _used) {
+      flush();
+      if (n >= sizeof(_buf)) {
+        _write_all(static_cast<const char*>(p), n);
+        return;
+      }
+    }
+    std::memcpy(_buf + _used, p, n);
+    _used += n;
+  }
+
+  void flush() {
+    _write_all(_buf, _used);
+    _used = 0;
+  }
+
+private:
+  int    _fd;
+  size_t _used;
+  char   _buf[65536];
+
+  void _write_all(const char* p, size_t n) {
+    while (n != 0) {
+      ssize_t w = ::write(_fd, p, n);
+      if (w < 0 && errno == EINTR)
+        continue;
+      if (w <= 0)
+        throw std::runtime_error(std::string("ft::save: write failed: ") +
+                                 std::strerror(errno));
+      p += w;
+      n -= size_t(w);
+    }
+  }
+
+  serial_fd_sink(const serial_fd_sink&);
+  serial_fd_sink& operator=(const serial_fd_sink&);
+};
+
+/**
+ * @brief Buffers reads from a file descriptor. It reads ahead; finish()
+ * seeks back over what it did not use, when the descriptor is seekable.
+ */
+class serial_fd_source {
+public:
+  explicit serial_fd_source(int fd) : _fd(fd), _pos(0), _end(0) { }
+
+  void read(void* p, size_t n) {
+    char* out = static_cast<char*>(p);
+    while (n != 0) {
+      if (_pos == _end)
+        _fill();
+      size_t m = _end - _pos < n ? _end - _pos : n;
+      std::memcpy(out, _buf + _pos, m);
+      _pos += m;
+      out += m;
+      n -= m;
+    }
+  }
+
+  void finish() {
+    if (_pos != _end)
+      ::lseek(_fd, -off_t(_end - _pos), SEEK_CUR); // fails on pipes
+    _pos = _end = 0;
+  }
+
+private:
+  int    _fd;
+  size_t _pos;
+  size_t _end;
+  char   _buf[65536];
+
+  void _fill() {
+    ssize_t r;
+    do
+      r = ::read(_fd, _buf, sizeof(_buf));
+    while (r < 0 && errno == EINTR);
+    if (r < 0)
+      throw std::runtime_error(std::string("ft::load: read failed: ") +
+                               std::strerror(errno));
+    if (r == 0)
+      throw std::runtime_error("ft::load: truncated input");
+    _pos = 0;
+    _end = size_t(r);
+  }
+
+  serial_fd_source(const serial_fd_source&);
+  serial_fd_source& operator=(const serial_fd_source&);
+};
+
+//!@}
+
+//!@{ Save and Load ////////////////////////////////////////////////////////////
+
+struct _serial_header {
+  char               magic[4];
+  unsigned char      version;
+  unsigned char      kind;
+  unsigned char      reserved[2];
+  unsigned           value_size;
+  unsigned long long size;
+};
+
+// input iterator decoding one element per dereference, for assign_sorted
+template <typename Value, typename Source>
+class _serial_input {
+public:
+  explicit _serial_input(Source& in) : _in(&in) { }
+
+  Value          operator*() const { return serial_traits<Value>::read(*_in); }
+  _serial_input& operator++() { return *this; }
+
+private:
+  Source* _in;
+};
+
+template <typename Sink, typename Container>
+void _save(Sink& out, const Container& c, serial_kind kind) {
+  typedef typename Container::value_type     value_type;
+  typedef typename Container::const_iterator const_iterator;
+
+  _serial_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, "FTSR", 4);
+  h.version = serial_version;
+  h.kind = static_cast<unsigned char>(kind);
+  h.value_size = unsigned(sizeof(value_type));
+  h.size = c.size();
+  out.write(&h, sizeof(h));
+  for (const_iterator it = c.begin(); it != c.end(); ++it)
+    serial_traits<value_type>::write(out, *it);
+  out.flush();
+}
+
+template <typename Source, typename Container>
+void _load(Source& in, Container& c, serial_kind kind) {
+  typedef typename Container::value_type value_type;
+
+  _serial_header h;
+  in.read(&h, sizeof(h));
+  if (std::memcmp(h.magic, "FTSR", 4) != 0 || h.version != serial_version)
+    throw std::runtime_error("ft::load: not a saved container");
+  if (h.kind != kind || h.value_size != sizeof(value_type))
+    throw std::runtime_error("ft::load: container type mismatch");
+  if (h.size > c.max_size())
+    throw std::runtime_error("ft::load: corrupt size");
+  try {
+    c.assign_sorted(_serial_input<value_type, Source>(in),
+                    typename Container::size_type(h.size));
+  } catch (std::invalid_argument&) {
+    throw std::runtime_error("ft::load: keys out of order");
+  }
+  in.finish();
+}
+
+/**
+ * @brief Writes m, in key order, to out or to the file descriptor fd.
+ * @throw std::runtime_error when writing fails
+ */
+template <typename K, typename T, typename C, typename A, typename H>
+void save(std::ostream& out, const map<K, T, C, A, H>& m) {
+  serial_ostream_sink sink(out);
+  _save(sink, m, serial_map);
+}
+
+template <typename K, typename T, typename C, typename A, typename H>
+void save(int fd, const map<K, T, C, A, H>& m) {
+  serial_fd_sink sink(fd);
+  _save(sink, m, serial_map);
+}
+
+template <typename K, typename C, typename A, typename H>
+void save(std::ostream& out, const set<K, C, A, H>& s) {
+  serial_ostream_sink sink(out);
+  _save(sink, s, serial_set);
+}
+
+template <typename K, typename C, typename A, typename H>
+void save(int fd, const set<K, C, A, H>& s) {
+  serial_fd_sink sink(fd);
+  _save(sink, s, serial_set);
+}
+
+/**
+ * @brief Replaces the contents of m with a map written by save(). The
+ * elements come in key order, so the tree is built directly in O(n) with
+ * assign_sorted, and each key is compared only with the previous one.
+ * @throw std::runtime_error on a read error, a truncated input, a header
+ * that does not match m's type, or keys out of order under m's Compare; m
+ * is then unchanged
+ */
+template <typename K, typename T, typename C, typename A, typename H>
+void load(std::istream& in, map<K, T, C, A, H>& m) {
+  serial_istream_source source(in);
+  _load(source, m, serial_map);
+}
+
+template <typename K, typename T, typename C, typename A, typename H>
+void load(int fd, map<K, T, C, A, H>& m) {
+  serial_fd_source source(fd);
+  _load(source, m, serial_map);
+}
+
+template <typename K, typename C, typename A, typename H>
+void load(std::istream& in, set<K, C, A, H>& s) {
+  serial_istream_source source(in);
+  _load(source, s, serial_set);
+}
+
+template <typename K, typename C, typename A, typename H>
+void load(int fd, set<K, C, A, H>& s) {
+  serial_fd_source source(fd);
+  _load(source, s, serial_set);
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __SERIALIZE_HPP__ */
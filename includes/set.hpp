@@ -10,7 +10,7 @@ namespace ft
 {
 
 template <typename Key, typename Compare = std::less<Key>,
-          typename Alloc = std::allocator<Key> >
+          typename Alloc = std::allocator<Key>, typename Hooks = null_hooks>
 class set {
 
 public:
@@ -21,7 +21,7 @@ public:
 
 private:
   typedef rb_tree<key_type, value_type, _Identity<value_type>,
-                   key_compare, Alloc>              rep_type;
+                   key_compare, Alloc, Hooks>       rep_type;
 
   rep_type                                          _tree;
 
@@ -61,7 +61,7 @@ public:
     _tree.insert_unique(first, last);
   }
 
-  set(const set<Key, Compare, Alloc>& other) : _tree(other._tree) { }
+  set(const set& other) : _tree(other._tree) { }
 
   //!@}
 
@@ -110,6 +110,18 @@ public:
     _tree.insert_unique(first, last);
   }
 
+  /**
+   * @brief Replaces the contents with the n elements read from first, which
+   * must be sorted by strictly increasing key. The tree is built directly in
+   * O(n), without searching or rebalancing; see rb_tree.
+   * @throw std::invalid_argument when the keys are out of order, leaving
+   * the set unchanged
+   */
+  template <typename InputIterator>
+  void assign_sorted(InputIterator first, size_type n) {
+    _tree.assign_sorted_unique(first, n);
+  }
+
   void erase(iterator position) {
     typedef typename rep_type::iterator rep_iterator;
     _tree.erase((rep_iterator&)position);
@@ -177,56 +189,116 @@ public:
 
   //!@}
 
-  template <typename K1, typename C1, typename A1>
-  friend bool operator==(const set<K1, C1, A1>&,
-                         const set<K1, C1, A1>&);
+  //!@{ Lookup filter //////////////////////////////////////////////////////////
+
+  /**
+   * @brief Keeps a Bloom filter alongside the tree so that find() and
+   * count() answer definite misses without walking the tree. See rb_tree.
+   * @return false if key_type has no ft::bloom_hash specialization, or
+   * Compare is not std::less or std::greater
+   */
+  bool enable_bloom_filter(size_type bits_per_key = 10) {
+    return _tree.enable_bloom_filter(bits_per_key);
+  }
+
+  /**
+   * @brief Same, for any Compare: hash must give the same value to keys
+   * that Compare finds equivalent.
+   */
+  bool enable_bloom_filter(size_t (*hash)(const key_type&),
+                           size_type bits_per_key = 10) {
+    return _tree.enable_bloom_filter(hash, bits_per_key);
+  }
+
+  void disable_bloom_filter() { _tree.disable_bloom_filter(); }
+
+  bloom_filter_stats bloom_stats() const { return _tree.bloom_stats(); }
+
+  //!@}
+
+  //!@{ Memory Introspection ///////////////////////////////////////////////////
+
+  /**
+   * @brief Payload and structural overhead in bytes, and live allocations.
+   * Cheap (O(1)) enough to export periodically.
+   */
+  memory_stats memory_usage() const { return _tree.memory_usage(); }
+
+  /**
+   * @brief Height, black height and average depth of the underlying tree.
+   * Walks every node: O(n).
+   */
+  tree_shape shape() const { return _tree.shape(); }
+
+  //!@}
+
+  //!@{ Partitioning ///////////////////////////////////////////////////////////
+
+  typedef ft::pair<iterator, iterator>             range_type;
+  typedef ft::pair<const_iterator, const_iterator> const_range_type;
+
+  /**
+   * @brief At most k consecutive ranges of about equal size covering the
+   * set in order, cut from the top levels of the tree in O(k log n);
+   * the parallel for_each and reduce of parallel_algorithm.hpp walk one per
+   * task.
+   */
+  ft::vector<const_range_type> split_ranges(size_type k) const {
+    return _tree.split_ranges(k);
+  }
+
+  //!@}
+
+  template <typename K1, typename C1, typename A1, typename H1>
+  friend bool operator==(const set<K1, C1, A1, H1>&,
+                         const set<K1, C1, A1, H1>&);
 
-  template <typename K1, typename C1, typename A1>
-  friend bool operator<(const set<K1, C1, A1>&,
-                        const set<K1, C1, A1>&);
+  template <typename K1, typename C1, typename A1, typename H1>
+  friend bool operator<(const set<K1, C1, A1, H1>&,
+                        const set<K1, C1, A1, H1>&);
 }; // set
 
 //!@{ Non-member functions /////////////////////////////////////////////////////
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator==(const set<Key, Compare, Alloc>& x,
-                       const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator==(const set<Key, Compare, Alloc, Hooks>& x,
+                       const set<Key, Compare, Alloc, Hooks>& y) {
   return x._tree == y._tree;
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator<(const set<Key, Compare, Alloc>& x,
-                      const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator<(const set<Key, Compare, Alloc, Hooks>& x,
+                      const set<Key, Compare, Alloc, Hooks>& y) {
   return x._tree < y._tree;
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator!=(const set<Key, Compare, Alloc>& x,
-                       const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator!=(const set<Key, Compare, Alloc, Hooks>& x,
+                       const set<Key, Compare, Alloc, Hooks>& y) {
   return !(x == y);
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator>(const set<Key, Compare, Alloc>& x,
-                      const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator>(const set<Key, Compare, Alloc, Hooks>& x,
+                      const set<Key, Compare, Alloc, Hooks>& y) {
   return y < x;
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator<=(const set<Key, Compare, Alloc>& x,
-                       const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator<=(const set<Key, Compare, Alloc, Hooks>& x,
+                       const set<Key, Compare, Alloc, Hooks>& y) {
   return !(y < x);
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline bool operator>=(const set<Key, Compare, Alloc>& x,
-                       const set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline bool operator>=(const set<Key, Compare, Alloc, Hooks>& x,
+                       const set<Key, Compare, Alloc, Hooks>& y) {
   return !(x < y);
 }
 
-template <typename Key, typename Compare, typename Alloc>
-inline void swap(set<Key, Compare, Alloc>& x,
-                 set<Key, Compare, Alloc>& y) {
+template <typename Key, typename Compare, typename Alloc, typename Hooks>
+inline void swap(set<Key, Compare, Alloc, Hooks>& x,
+                 set<Key, Compare, Alloc, Hooks>& y) {
   x.swap(y);
 }
 
@@ -0,0 +1,319 @@
+/** @file simd.hpp
+ *  This is an internal header file, included by algobase.hpp.
+ *  You should not attempt to use it directly.
+ */
+
+#ifndef __SIMD_HPP__
+#define __SIMD_HPP__
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    defined(__SSE2__)
+  #define FT_SIMD_X86 1
+  #include <immintrin.h>
+#endif
+
+namespace ft {
+
+//!@{ Contiguous Kernels ///////////////////////////////////////////////////////
+
+/*
+ * Search and comparison kernels over contiguous arrays of unsigned integers
+ * of 1, 2, 4 or 8 bytes, used by the pointer and vector_iterator overloads
+ * of find, count and lexicographical_compare in algobase.hpp. On x86 they
+ * compare 16 bytes at a time with SSE2, which every x86-64 CPU has, or 32
+ * with AVX2 when the running CPU supports it; the choice is made once, at
+ * the first call. Elsewhere they are plain loops.
+ */
+
+template <size_t Size>
+struct uint_of_size;
+
+template <> struct uint_of_size<1> { typedef unsigned char      type; };
+template <> struct uint_of_size<2> { typedef unsigned short     type; };
+template <> struct uint_of_size<4> { typedef unsigned int       type; };
+template <> struct uint_of_size<8> { typedef unsigned long long type; };
+
+/**
+ * @brief Integral types whose equality is equality of their object
+ * representation, so that they can be searched and compared as unsigned
+ * bytes. memcmp_order additionally says that memcmp orders them like
+ * operator<.
+ */
+template <typename T>
+struct simd_traits {
+  static const bool value = false;
+  static const bool memcmp_order = false;
+};
+
+#define FT_SIMD_TRAITS(T, MEMCMP_ORDER)                                        \
+  template <>                                                                  \
+  struct simd_traits<T> {                                                      \
+    static const bool value = true;                                            \
+    static const bool memcmp_order = MEMCMP_ORDER;                             \
+    typedef uint_of_size<sizeof(T)>::type type;                                \
+  };
+
+FT_SIMD_TRAITS(char, char(-1) > 0)
+FT_SIMD_TRAITS(signed char, false)
+FT_SIMD_TRAITS(unsigned char, true)
+FT_SIMD_TRAITS(short, false)
+FT_SIMD_TRAITS(unsigned short, false)
+FT_SIMD_TRAITS(int, false)
+FT_SIMD_TRAITS(unsigned int, false)
+FT_SIMD_TRAITS(long, false)
+FT_SIMD_TRAITS(unsigned long, false)
+FT_SIMD_TRAITS(long long, false)
+FT_SIMD_TRAITS(unsigned long long, false)
+
+#undef FT_SIMD_TRAITS
+
+#ifdef FT_SIMD_X86
+
+inline bool cpu_has_avx2() {
+  static const bool has = __builtin_cpu_supports("avx2");
+  return has;
+}
+
+/*
+ * Per lane width: broadcast a value, compare lanes, and turn the comparison
+ * into a byte mask with Size bits set for every equal lane.
+ */
+template <size_t Size>
+struct sse2_lanes;
+
+template <>
+struct sse2_lanes<1> {
+  static __m128i splat(unsigned char v) { return _mm_set1_epi8(char(v)); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+  }
+};
+
+template <>
+struct sse2_lanes<2> {
+  static __m128i splat(unsigned short v) { return _mm_set1_epi16(short(v)); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(a, b));
+  }
+};
+
+template <>
+struct sse2_lanes<4> {
+  static __m128i splat(unsigned int v) { return _mm_set1_epi32(int(v)); }
+  static unsigned eq(__m128i a, __m128i b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b));
+  }
+};
+
+template <>
+struct sse2_lanes<8> {
+  static __m128i splat(unsigned long long v) {
+    return _mm_set1_epi64x((long long)v);
+  }
+  // SSE2 has no 64-bit compare: a lane is equal when both halves are
+  static unsigned eq(__m128i a, __m128i b) {
+    unsigned m = _mm_movemask_epi8(_mm_cmpeq_epi32(a, b));
+    m &= (m >> 4) & 0x0f0f;
+    return m | (m << 4);
+  }
+};
+
+template <size_t Size>
+struct avx2_lanes;
+
+template <>
+struct avx2_lanes<1> {
+  __attribute__((target("avx2"))) static __m256i splat(unsigned char v) {
+    return _mm256_set1_epi8(char(v));
+  }
+  __attribute__((target("avx2"))) static unsigned eq(__m256i a, __m256i b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+  }
+};
+
+template <>
+struct avx2_lanes<2> {
+  __attribute__((target("avx2"))) static __m256i splat(unsigned short v) {
+    return _mm256_set1_epi16(short(v));
+  }
+  __attribute__((target("avx2"))) static unsigned eq(__m256i a, __m256i b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b));
+  }
+};
+
+template <>
+struct avx2_lanes<4> {
+  __attribute__((target("avx2"))) static __m256i splat(unsigned int v) {
+    return _mm256_set1_epi32(int(v));
+  }
+  __attribute__((target("avx2"))) static unsigned eq(__m256i a, __m256i b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi32(a, b));
+  }
+};
+
+template <>
+struct avx2_lanes<8> {
+  __attribute__((target("avx2"))) static __m256i
+  splat(unsigned long long v) {
+    return _mm256_set1_epi64x((long long)v);
+  }
+  __attribute__((target("avx2"))) static unsigned eq(__m256i a, __m256i b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi64(a, b));
+  }
+};
+
+template <typename U>
+size_t sse2_find(const U* p, size_t n, U v) {
+  typedef sse2_lanes<sizeof(U)> lanes;
+  const size_t  per = 16 / sizeof(U);
+  const __m128i needle = lanes::splat(v);
+  size_t        i = 0;
+  for (; i + per <= n; i += per) {
+    unsigned m = lanes::eq(_mm_loadu_si128((const __m128i*)(p + i)), needle);
+    if (m != 0)
+      return i + __builtin_ctz(m) / sizeof(U);
+  }
+  for (; i < n; ++i)
+    if (p[i] == v)
+      return i;
+  return n;
+}
+
+template <typename U>
+__attribute__((target("avx2"))) size_t avx2_find(const U* p, size_t n, U v) {
+  typedef avx2_lanes<sizeof(U)> lanes;
+  const size_t  per = 32 / sizeof(U);
+  const __m256i needle = lanes::splat(v);
+  size_t        i = 0;
+  for (; i + per <= n; i += per) {
+    unsigned m =
+        lanes::eq(_mm256_loadu_si256((const __m256i*)(p + i)), needle);
+    if (m != 0)
+      return i + __builtin_ctz(m) / sizeof(U);
+  }
+  for (; i < n; ++i)
+    if (p[i] == v)
+      return i;
+  return n;
+}
+
+template <typename U>
+size_t sse2_count(const U* p, size_t n, U v) {
+  typedef sse2_lanes<sizeof(U)> lanes;
+  const size_t  per = 16 / sizeof(U);
+  const __m128i needle = lanes::splat(v);
+  size_t        bits = 0;
+  size_t        i = 0;
+  for (; i + per <= n; i += per)
+    bits += __builtin_popcount(
+        lanes::eq(_mm_loadu_si128((const __m128i*)(p + i)), needle));
+  size_t c = bits / sizeof(U);
+  for (; i < n; ++i)
+    c += p[i] == v;
+  return c;
+}
+
+template <typename U>
+__attribute__((target("avx2"))) size_t avx2_count(const U* p, size_t n,
+                                                  U v) {
+  typedef avx2_lanes<sizeof(U)> lanes;
+  const size_t  per = 32 / sizeof(U);
+  const __m256i needle = lanes::splat(v);
+  size_t        bits = 0;
+  size_t        i = 0;
+  for (; i + per <= n; i += per)
+    bits += __builtin_popcount(
+        lanes::eq(_mm256_loadu_si256((const __m256i*)(p + i)), needle));
+  size_t c = bits / sizeof(U);
+  for (; i < n; ++i)
+    c += p[i] == v;
+  return c;
+}
+
+inline size_t sse2_mismatch(const unsigned char* a, const unsigned char* b,
+                            size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    unsigned m = sse2_lanes<1>::eq(_mm_loadu_si128((const __m128i*)(a + i)),
+                                   _mm_loadu_si128((const __m128i*)(b + i)));
+    if (m != 0xffff)
+      return i + __builtin_ctz(~m);
+  }
+  for (; i < n; ++i)
+    if (a[i] != b[i])
+      return i;
+  return n;
+}
+
+__attribute__((target("avx2"))) inline size_t
+avx2_mismatch(const unsigned char* a, const unsigned char* b, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    unsigned m =
+        avx2_lanes<1>::eq(_mm256_loadu_si256((const __m256i*)(a + i)),
+                          _mm256_loadu_si256((const __m256i*)(b + i)));
+    if (m != 0xffffffffu)
+      return i + __builtin_ctz(~m);
+  }
+  for (; i < n; ++i)
+    if (a[i] != b[i])
+      return i;
+  return n;
+}
+
+#endif /* FT_SIMD_X86 */
+
+/**
+ * @return index of the first element of [p, p + n) equal to v, or n
+ */
+template <typename U>
+inline size_t simd_find(const U* p, size_t n, U v) {
+#ifdef FT_SIMD_X86
+  return cpu_has_avx2() ? avx2_find(p, n, v) : sse2_find(p, n, v);
+#else
+  size_t i = 0;
+  while (i < n && p[i] != v)
+    ++i;
+  return i;
+#endif
+}
+
+/**
+ * @return number of elements of [p, p + n) equal to v
+ */
+template <typename U>
+inline size_t simd_count(const U* p, size_t n, U v) {
+#ifdef FT_SIMD_X86
+  return cpu_has_avx2() ? avx2_count(p, n, v) : sse2_count(p, n, v);
+#else
+  size_t c = 0;
+  for (size_t i = 0; i < n; ++i)
+    c += p[i] == v;
+  return c;
+#endif
+}
+
+/**
+ * @return offset of the first differing byte of a and b, or n
+ */
+inline size_t simd_mismatch(const void* a, const void* b, size_t n) {
+  const unsigned char* x = static_cast<const unsigned char*>(a);
+  const unsigned char* y = static_cast<const unsigned char*>(b);
+#ifdef FT_SIMD_X86
+  return cpu_has_avx2() ? avx2_mismatch(x, y, n) : sse2_mismatch(x, y, n);
+#else
+  size_t i = 0;
+  while (i < n && x[i] == y[i])
+    ++i;
+  return i;
+#endif
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __SIMD_HPP__ */
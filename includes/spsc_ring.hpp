@@ -0,0 +1,203 @@
+#ifndef __SPSC_RING_HPP__
+#define __SPSC_RING_HPP__
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include "atomic.hpp"
+
+namespace ft {
+
+/**
+ * @brief Bounded FIFO queue between exactly one producer thread and one
+ * consumer thread.
+ *
+ * The elements live in one contiguous block of a power-of-two number of
+ * slots. The producer owns the tail index and the consumer the head index,
+ * each on its own cache line, and every operation is wait-free: a bounded
+ * number of steps with a single release store to publish it. Each side also
+ * keeps a cached copy of the other side's index and only reloads it, taking
+ * a cache miss, when the cached value says the ring is full (producer) or
+ * empty (consumer).
+ *
+ * push_batch and pop_batch move up to n elements for the price of one
+ * index update. push and pop block until they can proceed. Not copyable.
+ */
+template <typename T, typename Alloc = std::allocator<T> >
+class spsc_ring {
+public:
+  typedef T                                      value_type;
+  typedef Alloc                                  allocator_type;
+  typedef size_t                                 size_type;
+  typedef typename allocator_type::pointer       pointer;
+
+private:
+  // read-only after construction, shared by both sides
+  pointer        _buf;
+  size_type      _mask;
+  allocator_type _alloc;
+  char           _pad0[cache_line_size];
+  // consumer side
+  size_type      _head;
+  size_type      _cached_tail;
+  char           _pad1[cache_line_size - 2 * sizeof(size_type)];
+  // producer side
+  size_type      _tail;
+  size_type      _cached_head;
+  char           _pad2[cache_line_size - 2 * sizeof(size_type)];
+
+public:
+  /**
+   * @brief Ring of at least capacity slots, rounded up to a power of two.
+   * @throw std::length_error when capacity is 0
+   */
+  explicit spsc_ring(size_type capacity,
+                     const allocator_type& a = allocator_type())
+  : _buf(0), _mask(0), _alloc(a), _head(0), _cached_tail(0), _tail(0),
+    _cached_head(0) {
+    if (capacity == 0 || capacity > _alloc.max_size())
+      throw std::length_error("ft::spsc_ring");
+    size_type n = 1;
+    while (n < capacity)
+      n *= 2;
+    _buf = _alloc.allocate(n);
+    _mask = n - 1;
+  }
+
+  /**
+   * @brief Destroys the remaining elements. Neither side may use the ring
+   * any more.
+   */
+  ~spsc_ring() {
+    for (size_type i = _head; i != _tail; ++i)
+      _alloc.destroy(_buf + (i & _mask));
+    _alloc.deallocate(_buf, _mask + 1);
+  }
+
+  //!@{ Producer ///////////////////////////////////////////////////////////////
+
+  /**
+   * @return false, without copying x, when the ring is full
+   */
+  bool try_push(const value_type& x) {
+    size_type tail = _tail;
+    if (tail - _cached_head > _mask) {
+      _cached_head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+      if (tail - _cached_head > _mask)
+        return false;
+    }
+    _alloc.construct(_buf + (tail & _mask), x);
+    __atomic_store_n(&_tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  void push(const value_type& x) {
+    backoff b;
+    while (!try_push(x))
+      b.pause();
+  }
+
+  /**
+   * @brief Copies the first elements of src[0, n) that fit in the ring.
+   * @return number of elements pushed, 0 when the ring is full
+   */
+  size_type push_batch(const value_type* src, size_type n) {
+    size_type tail = _tail;
+    size_type room = _mask + 1 - (tail - _cached_head);
+    if (room < n) {
+      _cached_head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+      room = _mask + 1 - (tail - _cached_head);
+    }
+    if (n > room)
+      n = room;
+    size_type i = 0;
+    try {
+      for (; i < n; ++i)
+        _alloc.construct(_buf + ((tail + i) & _mask), src[i]);
+    } catch (...) {
+      while (i != 0)
+        _alloc.destroy(_buf + ((tail + --i) & _mask));
+      throw;
+    }
+    __atomic_store_n(&_tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+  }
+
+  //!@}
+
+  //!@{ Consumer ///////////////////////////////////////////////////////////////
+
+  /**
+   * @brief Copies the oldest element into x and removes it.
+   * @return false, leaving x alone, when the ring is empty
+   */
+  bool try_pop(value_type& x) {
+    size_type head = _head;
+    if (head == _cached_tail) {
+      _cached_tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+      if (head == _cached_tail)
+        return false;
+    }
+    pointer p = _buf + (head & _mask);
+    x = *p;
+    _alloc.destroy(p);
+    __atomic_store_n(&_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  void pop(value_type& x) {
+    backoff b;
+    while (!try_pop(x))
+      b.pause();
+  }
+
+  /**
+   * @brief Moves up to n of the oldest elements into dst[0, n), oldest
+   * first. If a copy throws, the ring is left unchanged.
+   * @return number of elements popped, 0 when the ring is empty
+   */
+  size_type pop_batch(value_type* dst, size_type n) {
+    size_type head = _head;
+    size_type ready = _cached_tail - head;
+    if (ready < n) {
+      _cached_tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+      ready = _cached_tail - head;
+    }
+    if (n > ready)
+      n = ready;
+    for (size_type i = 0; i < n; ++i)
+      dst[i] = _buf[(head + i) & _mask];
+    for (size_type i = 0; i < n; ++i)
+      _alloc.destroy(_buf + ((head + i) & _mask));
+    __atomic_store_n(&_head, head + n, __ATOMIC_RELEASE);
+    return n;
+  }
+
+  //!@}
+
+  //!@{ Capacity ///////////////////////////////////////////////////////////////
+
+  size_type capacity() const { return _mask + 1; }
+
+  /**
+   * @brief Number of elements at some point during the call; exact when
+   * called by either side while the other one is idle.
+   */
+  size_type size_approx() const {
+    size_type head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    size_type tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    return tail - head;
+  }
+
+  bool empty() const { return size_approx() == 0; }
+
+  //!@}
+
+private:
+  spsc_ring(const spsc_ring&);
+  spsc_ring& operator=(const spsc_ring&);
+};
+
+} /* namespace ft */
+
+#endif /* __SPSC_RING_HPP__ */
@@ -32,6 +32,9 @@ public:
   // Return size
   size_type size() const { return c.size(); }
 
+  // Heap memory of the underlying container (ft containers only)
+  memory_stats memory_usage() const { return c.memory_usage(); }
+
   // Access next element
   reference       top() { return c.back(); }
   const_reference top() const { return c.back(); }
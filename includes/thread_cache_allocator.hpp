@@ -0,0 +1,363 @@
+#ifndef __THREAD_CACHE_ALLOCATOR_HPP__
+#define __THREAD_CACHE_ALLOCATOR_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <pthread.h>
+
+namespace ft {
+
+//!@{ Thread Cache /////////////////////////////////////////////////////////////
+
+/**
+ * @brief Counters of the thread caching allocator. Per-thread hit and miss
+ * counts are published when a thread talks to the depot, calls
+ * thread_cache::flush() or exits, so a snapshot may lag slightly behind.
+ */
+struct thread_cache_stats {
+  size_t cache_hits;       // served from the calling thread's free list
+  size_t cache_misses;     // free list was empty, had to go to the depot
+  size_t depot_refills;    // batches moved from the depot to a thread
+  size_t depot_returns;    // batches moved from a thread to the depot
+  size_t slab_allocations; // fresh batches carved from operator new
+  size_t lock_contentions; // depot lock acquisitions that had to wait
+  size_t oversized;        // requests above max_small, sent to operator new
+};
+
+struct thread_cache_block {
+  thread_cache_block* next;
+};
+
+// First block of a batch parked in the depot; the smallest class (16 bytes)
+// is just large enough for the two links.
+struct thread_cache_batch {
+  thread_cache_block* next;
+  thread_cache_batch* next_batch;
+};
+
+/**
+ * @brief Size-class allocator with a free list per thread and class.
+ *
+ * Classes are 16-byte steps up to 256 bytes (which covers rb_tree_node<Val>
+ * for small values) and then 384, 512, 768 and 1024 bytes for small vector
+ * buffers. A thread allocates and frees against its own lists without any
+ * locking. Lists exchange whole batches with a global depot: an empty list
+ * pulls one batch, a list holding more than max_cached blocks pushes one
+ * back. Memory freed on another thread than the one that allocated it thus
+ * lands in the freeing thread's cache and returns to circulation through
+ * the depot instead of contending on malloc arenas.
+ *
+ * Depot memory is never handed back to the system.
+ */
+class thread_cache {
+public:
+  static const size_t num_classes = 20;
+  static const size_t max_small = 1024;
+  static const size_t batch_size = 32;
+  static const size_t max_cached = 2 * batch_size;
+
+private:
+  struct free_list {
+    thread_cache_block* head;
+    size_t              count;
+  };
+
+  struct local {
+    free_list lists[num_classes];
+    size_t    hits;
+    size_t    misses;
+  };
+
+  struct depot {
+    pthread_mutex_t     locks[num_classes];
+    thread_cache_batch* batches[num_classes];
+    thread_cache_stats  stats;
+
+    depot() {
+      std::memset(batches, 0, sizeof(batches));
+      std::memset(&stats, 0, sizeof(stats));
+      for (size_t i = 0; i < num_classes; ++i)
+        pthread_mutex_init(&locks[i], 0);
+    }
+  };
+
+public:
+  static size_t class_index(size_t bytes) {
+    if (bytes <= 256)
+      return bytes == 0 ? 0 : (bytes + 15) / 16 - 1;
+    if (bytes <= 384)
+      return 16;
+    if (bytes <= 512)
+      return 17;
+    if (bytes <= 768)
+      return 18;
+    return 19;
+  }
+
+  static size_t class_size(size_t index) {
+    static const size_t large[4] = { 384, 512, 768, 1024 };
+    return index < 16 ? (index + 1) * 16 : large[index - 16];
+  }
+
+  static void* allocate(size_t bytes) {
+    if (bytes > max_small) {
+      __sync_fetch_and_add(&_depot().stats.oversized, 1);
+      return ::operator new(bytes);
+    }
+    size_t     c = class_index(bytes);
+    local*     l = _local();
+    free_list& list = l->lists[c];
+
+    if (list.head == 0) {
+      ++l->misses;
+      _refill(*l, c);
+    } else
+      ++l->hits;
+    thread_cache_block* b = list.head;
+    list.head = b->next;
+    --list.count;
+    return b;
+  }
+
+  static void deallocate(void* p, size_t bytes) {
+    if (p == 0)
+      return;
+    if (bytes > max_small) {
+      ::operator delete(p);
+      return;
+    }
+    size_t              c = class_index(bytes);
+    local*              l = _local();
+    free_list&          list = l->lists[c];
+    thread_cache_block* b = static_cast<thread_cache_block*>(p);
+
+    b->next = list.head;
+    list.head = b;
+    if (++list.count > max_cached)
+      _return_batch(*l, c);
+  }
+
+  /**
+   * @brief Hands every block cached by the calling thread back to the depot
+   * and publishes its counters.
+   */
+  static void flush() {
+    local* l = _local_slot();
+    if (l)
+      _flush(*l);
+  }
+
+  static thread_cache_stats stats() {
+    local* l = _local_slot();
+    if (l)
+      _publish(*l);
+    thread_cache_stats s;
+    depot&             d = _depot();
+    s.cache_hits = __sync_fetch_and_add(&d.stats.cache_hits, 0);
+    s.cache_misses = __sync_fetch_and_add(&d.stats.cache_misses, 0);
+    s.depot_refills = __sync_fetch_and_add(&d.stats.depot_refills, 0);
+    s.depot_returns = __sync_fetch_and_add(&d.stats.depot_returns, 0);
+    s.slab_allocations = __sync_fetch_and_add(&d.stats.slab_allocations, 0);
+    s.lock_contentions = __sync_fetch_and_add(&d.stats.lock_contentions, 0);
+    s.oversized = __sync_fetch_and_add(&d.stats.oversized, 0);
+    return s;
+  }
+
+private:
+  static depot& _depot() {
+    // never destroyed: exiting threads may still flush into it
+    static depot* d = new depot;
+    return *d;
+  }
+
+  static local*& _local_slot() {
+    static __thread local* l = 0;
+    return l;
+  }
+
+  static pthread_key_t& _key() {
+    static pthread_key_t k;
+    return k;
+  }
+
+  static void _make_key() { pthread_key_create(&_key(), &_thread_exit); }
+
+  static void _thread_exit(void* p) {
+    local* l = static_cast<local*>(p);
+    _flush(*l);
+    _local_slot() = 0;
+    delete l;
+  }
+
+  static local* _local() {
+    local*& l = _local_slot();
+    if (l == 0) {
+      static pthread_once_t once = PTHREAD_ONCE_INIT;
+      pthread_once(&once, &_make_key);
+      l = new local;
+      std::memset(l, 0, sizeof(local));
+      pthread_setspecific(_key(), l);
+    }
+    return l;
+  }
+
+  static void _lock(size_t c) {
+    depot& d = _depot();
+    if (pthread_mutex_trylock(&d.locks[c]) != 0) {
+      __sync_fetch_and_add(&d.stats.lock_contentions, 1);
+      pthread_mutex_lock(&d.locks[c]);
+    }
+  }
+
+  static void _unlock(size_t c) { pthread_mutex_unlock(&_depot().locks[c]); }
+
+  static void _publish(local& l) {
+    depot& d = _depot();
+    if (l.hits)
+      __sync_fetch_and_add(&d.stats.cache_hits, l.hits);
+    if (l.misses)
+      __sync_fetch_and_add(&d.stats.cache_misses, l.misses);
+    l.hits = 0;
+    l.misses = 0;
+  }
+
+  static void _refill(local& l, size_t c) {
+    depot&              d = _depot();
+    thread_cache_batch* batch;
+
+    _lock(c);
+    batch = d.batches[c];
+    if (batch)
+      d.batches[c] = batch->next_batch;
+    _unlock(c);
+
+    free_list& list = l.lists[c];
+    if (batch) {
+      __sync_fetch_and_add(&d.stats.depot_refills, 1);
+      list.head = reinterpret_cast<thread_cache_block*>(batch);
+      list.count = 0;
+      for (thread_cache_block* b = list.head; b; b = b->next)
+        ++list.count;
+    } else {
+      __sync_fetch_and_add(&d.stats.slab_allocations, 1);
+      size_t size = class_size(c);
+      char*  slab = static_cast<char*>(::operator new(size * batch_size));
+      for (size_t i = 0; i < batch_size; ++i) {
+        thread_cache_block* b =
+            reinterpret_cast<thread_cache_block*>(slab + i * size);
+        b->next = i + 1 < batch_size
+                      ? reinterpret_cast<thread_cache_block*>(slab +
+                                                              (i + 1) * size)
+                      : 0;
+      }
+      list.head = reinterpret_cast<thread_cache_block*>(slab);
+      list.count = batch_size;
+    }
+    _publish(l);
+  }
+
+  static void _push_batch(size_t c, thread_cache_block* first) {
+    depot&              d = _depot();
+    thread_cache_batch* batch = reinterpret_cast<thread_cache_batch*>(first);
+
+    _lock(c);
+    batch->next_batch = d.batches[c];
+    d.batches[c] = batch;
+    _unlock(c);
+    __sync_fetch_and_add(&d.stats.depot_returns, 1);
+  }
+
+  static void _return_batch(local& l, size_t c) {
+    free_list&          list = l.lists[c];
+    thread_cache_block* first = list.head;
+    thread_cache_block* last = first;
+
+    for (size_t i = 1; i < batch_size; ++i)
+      last = last->next;
+    list.head = last->next;
+    list.count -= batch_size;
+    last->next = 0;
+    _push_batch(c, first);
+    _publish(l);
+  }
+
+  static void _flush(local& l) {
+    for (size_t c = 0; c < num_classes; ++c) {
+      free_list& list = l.lists[c];
+      while (list.count > batch_size)
+        _return_batch(l, c);
+      if (list.head)
+        _push_batch(c, list.head);
+      list.head = 0;
+      list.count = 0;
+    }
+    _publish(l);
+  }
+};
+
+//!@}
+
+//!@{ Thread Cache Allocator ///////////////////////////////////////////////////
+
+/**
+ * @brief Stateless std::allocator replacement backed by thread_cache.
+ * Any instance can free memory obtained from any other, on any thread.
+ */
+template <typename T>
+class thread_cache_allocator {
+public:
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template <typename U>
+  struct rebind {
+    typedef thread_cache_allocator<U> other;
+  };
+
+  thread_cache_allocator() { }
+
+  template <typename U>
+  thread_cache_allocator(const thread_cache_allocator<U>&) { }
+
+  pointer allocate(size_type n, const void* = 0) {
+    if (n > max_size())
+      throw std::bad_alloc();
+    return static_cast<pointer>(thread_cache::allocate(n * sizeof(T)));
+  }
+
+  void deallocate(pointer p, size_type n) {
+    thread_cache::deallocate(p, n * sizeof(T));
+  }
+
+  void construct(pointer p, const T& v) { new (static_cast<void*>(p)) T(v); }
+  void destroy(pointer p) { p->~T(); }
+
+  pointer       address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+
+  size_type max_size() const { return size_type(-1) / sizeof(T); }
+};
+
+template <typename T, typename U>
+inline bool operator==(const thread_cache_allocator<T>&,
+                       const thread_cache_allocator<U>&) {
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const thread_cache_allocator<T>&,
+                       const thread_cache_allocator<U>&) {
+  return false;
+}
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __THREAD_CACHE_ALLOCATOR_HPP__ */
@@ -0,0 +1,371 @@
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+
+#include <cstddef>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace ft {
+
+//!@{ Thread Pool //////////////////////////////////////////////////////////////
+
+/*
+ * A fork-join pool. Every worker owns a deque of tasks: it pushes and pops
+ * at the back, so it runs its most recently forked task first, while idle
+ * workers steal from the front of the others' deques, where the oldest and
+ * so largest pieces of a recursively split job sit. Threads outside the
+ * pool push into one extra shared deque. A thread waiting for its task_group
+ * does not block: it runs tasks (its own first, then stolen ones) until the
+ * group is done. Workers that find nothing to do spin briefly, then sleep
+ * until a task is queued.
+ *
+ * Tasks are a function pointer and an argument; the argument usually lives
+ * in the frame of the forking function, which must wait for the group
+ * before returning. Exceptions do not cross threads in C++98: one escaping
+ * a task is caught and wait() throws std::runtime_error instead.
+ */
+
+class task_group;
+
+struct pool_task {
+  void (*fn)(void*);
+  void*       arg;
+  task_group* group;
+};
+
+/**
+ * @brief Tasks a fork-join step is waiting for.
+ */
+class task_group {
+public:
+  task_group() : _pending(0), _failed(0) { }
+
+  bool done() const {
+    return __atomic_load_n(&_pending, __ATOMIC_ACQUIRE) == 0;
+  }
+
+private:
+  friend class thread_pool;
+
+  long _pending;
+  int  _failed;
+
+  task_group(const task_group&);
+  task_group& operator=(const task_group&);
+};
+
+/**
+ * @brief Deque of tasks behind a lock. The owner uses the back, thieves the
+ * front; size() is a lock-free hint that lets thieves skip empty deques.
+ */
+class work_deque {
+public:
+  work_deque() : _buf(0), _mask(0), _head(0), _tail(0) {
+    pthread_mutex_init(&_mutex, 0);
+  }
+
+  ~work_deque() {
+    delete[] _buf;
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  size_t size() const {
+    return __atomic_load_n(&_tail, __ATOMIC_RELAXED) -
+           __atomic_load_n(&_head, __ATOMIC_RELAXED);
+  }
+
+  void push(const pool_task& t) {
+    pthread_mutex_lock(&_mutex);
+    if (_buf == 0 || _tail - _head > _mask)
+      _grow();
+    _buf[_tail & _mask] = t;
+    __atomic_store_n(&_tail, _tail + 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  bool pop(pool_task& t) {
+    if (size() == 0)
+      return false;
+    pthread_mutex_lock(&_mutex);
+    bool found = _tail != _head;
+    if (found) {
+      t = _buf[(_tail - 1) & _mask];
+      __atomic_store_n(&_tail, _tail - 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&_mutex);
+    return found;
+  }
+
+  bool steal(pool_task& t) {
+    if (size() == 0)
+      return false;
+    pthread_mutex_lock(&_mutex);
+    bool found = _tail != _head;
+    if (found) {
+      t = _buf[_head & _mask];
+      __atomic_store_n(&_head, _head + 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&_mutex);
+    return found;
+  }
+
+private:
+  pool_task*      _buf;
+  size_t          _mask; // capacity - 1, capacity a power of two
+  size_t          _head;
+  size_t          _tail;
+  pthread_mutex_t _mutex;
+
+  void _grow() {
+    size_t     capacity = _buf ? 2 * (_mask + 1) : 64;
+    pool_task* buf = new pool_task[capacity];
+    for (size_t i = _head; i != _tail; ++i)
+      buf[i & (capacity - 1)] = _buf[i & _mask];
+    delete[] _buf;
+    _buf = buf;
+    _mask = capacity - 1;
+  }
+
+  work_deque(const work_deque&);
+  work_deque& operator=(const work_deque&);
+};
+
+/**
+ * @brief Counters of a thread_pool, updated as tasks run.
+ */
+struct thread_pool_stats {
+  size_t tasks_run;    // tasks executed by any thread
+  size_t tasks_stolen; // taken from another thread's deque
+  size_t sleeps;       // times a worker went to sleep for lack of work
+};
+
+class thread_pool {
+public:
+  // rounds of sched_yield() an idle worker tries stealing before sleeping
+  static const int spin_rounds = 64;
+
+  /**
+   * @brief Starts the given number of worker threads. The thread calling
+   * wait() runs tasks as well, so a pool of n workers keeps n + 1 threads
+   * busy and a pool of 0 workers runs everything on the waiting thread.
+   */
+  explicit thread_pool(size_t workers = hardware_concurrency() - 1)
+  : _workers(workers), _deques(new work_deque[workers + 1]),
+    _threads(new pthread_t[workers]), _args(new worker_arg[workers]),
+    _queued(0), _sleeping(0), _stop(false) {
+    std::memset(&_stats, 0, sizeof(_stats));
+    pthread_mutex_init(&_mutex, 0);
+    pthread_cond_init(&_cond, 0);
+    size_t started = 0;
+    for (; started < workers; ++started) {
+      _args[started].pool = this;
+      _args[started].index = started;
+      if (pthread_create(&_threads[started], 0, &_worker_main,
+                         &_args[started]) != 0)
+        break;
+    }
+    if (started != workers) {
+      _join(started);
+      _release();
+      throw std::runtime_error("ft::thread_pool: cannot start threads");
+    }
+  }
+
+  ~thread_pool() {
+    _join(_workers);
+    _release();
+  }
+
+  /**
+   * @brief Online CPUs, at least 1.
+   */
+  static size_t hardware_concurrency() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? size_t(n) : 1;
+  }
+
+  /**
+   * @brief Pool shared by the parallel algorithms called without one,
+   * started on first use with hardware_concurrency() - 1 workers.
+   */
+  static thread_pool& global() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  size_t workers() const { return _workers; }
+
+  // threads working on a job: the workers and the thread waiting for it
+  size_t concurrency() const { return _workers + 1; }
+
+  thread_pool_stats stats() const {
+    thread_pool_stats s;
+    s.tasks_run = __atomic_load_n(&_stats.tasks_run, __ATOMIC_RELAXED);
+    s.tasks_stolen = __atomic_load_n(&_stats.tasks_stolen, __ATOMIC_RELAXED);
+    s.sleeps = __atomic_load_n(&_stats.sleeps, __ATOMIC_RELAXED);
+    return s;
+  }
+
+  /**
+   * @brief Queues fn(arg) as part of group g; it may run on any thread of
+   * the pool, or on the caller when it waits.
+   */
+  void run(task_group& g, void (*fn)(void*), void* arg) {
+    pool_task t;
+    t.fn = fn;
+    t.arg = arg;
+    t.group = &g;
+    __sync_fetch_and_add(&g._pending, 1);
+    _deques[_self()].push(t);
+    __sync_fetch_and_add(&_queued, 1);
+    // pairs with the increment of _sleeping before a worker's last look at
+    // _queued: one of the two sides sees the other
+    if (__sync_fetch_and_add(&_sleeping, 0) != 0) {
+      pthread_mutex_lock(&_mutex);
+      pthread_cond_signal(&_cond);
+      pthread_mutex_unlock(&_mutex);
+    }
+  }
+
+  /**
+   * @brief Runs tasks until every task of g has finished.
+   * @throw std::runtime_error when one of them threw
+   */
+  void wait(task_group& g) {
+    size_t self = _self();
+    while (!g.done()) {
+      pool_task t;
+      if (_find(self, t))
+        _execute(t);
+      else
+        sched_yield();
+    }
+    if (g._failed) {
+      g._failed = 0;
+      throw std::runtime_error("ft::thread_pool: a task threw an exception");
+    }
+  }
+
+private:
+  struct worker_arg {
+    thread_pool* pool;
+    size_t       index;
+  };
+
+  struct thread_slot {
+    const thread_pool* pool;
+    size_t             index;
+  };
+
+  size_t            _workers;
+  work_deque*       _deques; // one per worker, then the shared one
+  pthread_t*        _threads;
+  worker_arg*       _args;
+  long              _queued; // tasks sitting in any deque
+  long              _sleeping;
+  bool              _stop;
+  pthread_mutex_t   _mutex;
+  pthread_cond_t    _cond;
+  thread_pool_stats _stats;
+
+  static thread_slot& _slot() {
+    static __thread thread_slot s = { 0, 0 };
+    return s;
+  }
+
+  // deque of the calling thread: its own for a worker, else the shared one
+  size_t _self() const {
+    const thread_slot& s = _slot();
+    return s.pool == this ? s.index : _workers;
+  }
+
+  bool _find(size_t self, pool_task& t) {
+    if (_deques[self].pop(t)) {
+      __sync_fetch_and_sub(&_queued, 1);
+      return true;
+    }
+    size_t n = _workers + 1;
+    for (size_t i = 1; i < n; ++i) {
+      if (_deques[(self + i) % n].steal(t)) {
+        __sync_fetch_and_sub(&_queued, 1);
+        __sync_fetch_and_add(&_stats.tasks_stolen, 1);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void _execute(const pool_task& t) {
+    try {
+      t.fn(t.arg);
+    } catch (...) {
+      __atomic_store_n(&t.group->_failed, 1, __ATOMIC_RELAXED);
+    }
+    __sync_fetch_and_add(&_stats.tasks_run, 1);
+    // last touch of the group: its owner may return as soon as it is done
+    __sync_fetch_and_sub(&t.group->_pending, 1);
+  }
+
+  void _work(size_t index) {
+    _slot().pool = this;
+    _slot().index = index;
+    for (;;) {
+      pool_task t;
+      bool      found = _find(index, t);
+      for (int i = 0; !found && i < spin_rounds; ++i) {
+        sched_yield();
+        found = _find(index, t);
+      }
+      if (found) {
+        _execute(t);
+        continue;
+      }
+      pthread_mutex_lock(&_mutex);
+      __sync_fetch_and_add(&_sleeping, 1);
+      while (!_stop && __sync_fetch_and_add(&_queued, 0) == 0) {
+        __sync_fetch_and_add(&_stats.sleeps, 1);
+        pthread_cond_wait(&_cond, &_mutex);
+      }
+      __sync_fetch_and_sub(&_sleeping, 1);
+      bool stop = _stop && __sync_fetch_and_add(&_queued, 0) == 0;
+      pthread_mutex_unlock(&_mutex);
+      if (stop)
+        return;
+    }
+  }
+
+  static void* _worker_main(void* p) {
+    worker_arg* a = static_cast<worker_arg*>(p);
+    a->pool->_work(a->index);
+    return 0;
+  }
+
+  void _join(size_t started) {
+    pthread_mutex_lock(&_mutex);
+    _stop = true;
+    pthread_cond_broadcast(&_cond);
+    pthread_mutex_unlock(&_mutex);
+    for (size_t i = 0; i < started; ++i)
+      pthread_join(_threads[i], 0);
+  }
+
+  void _release() {
+    delete[] _deques;
+    delete[] _threads;
+    delete[] _args;
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  thread_pool(const thread_pool&);
+  thread_pool& operator=(const thread_pool&);
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __THREAD_POOL_HPP__ */
@@ -0,0 +1,391 @@
+#ifndef __TRACE_HPP__
+#define __TRACE_HPP__
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "pair.hpp"
+
+namespace ft {
+
+//!@{ Trace Format /////////////////////////////////////////////////////////////
+
+/*
+ * A trace is an 8 byte header followed by one record per operation.
+ *
+ *   header  "FTTR", version, container kind, 2 reserved zero bytes
+ *   record  op byte, then key, value and result as LEB128 varints; signed
+ *           key and value are zigzag encoded and only present for the
+ *           operations that take them (see trace_has_key/trace_has_value)
+ *
+ * The result is what the recorded container observed (hit or miss, elements
+ * erased, size after a push...) so that a replay can detect divergence.
+ * Keys and values are stored as 64-bit integers, which limits recording to
+ * containers of integral types.
+ */
+
+enum trace_kind { trace_map = 1, trace_set = 2, trace_vector = 3 };
+
+enum trace_op {
+  trace_insert = 1, // map, set: result 1 if inserted
+  trace_find,       // map: 0 on miss, else 1 + zigzag(mapped); set: 0 or 1
+  trace_count,      // map, set: result count(key)
+  trace_erase,      // map, set: result erase(key)
+  trace_subscript,  // map operator[]: result 1 if the key already existed
+  trace_assign,     // map insert_or_assign: result 1 if the key existed;
+                    // vector element store at index key: result 0
+  trace_push_back,  // vector: value, result size after
+  trace_pop_back,   // vector: result size after
+  trace_at,         // vector read at index key: result zigzag(element)
+  trace_clear,      // all: result 0
+  trace_num_ops
+};
+
+const unsigned char trace_version = 1;
+
+inline bool trace_has_key(int op) {
+  return op != trace_push_back && op != trace_pop_back && op != trace_clear;
+}
+
+inline bool trace_has_value(int op, int kind) {
+  return op == trace_assign || op == trace_push_back ||
+         (op == trace_insert && kind == trace_map);
+}
+
+inline unsigned long long trace_zigzag(long long v) {
+  return (static_cast<unsigned long long>(v) << 1) ^
+         static_cast<unsigned long long>(v >> 63);
+}
+
+inline long long trace_unzigzag(unsigned long long v) {
+  return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+}
+
+struct trace_record {
+  int                op;
+  long long          key;
+  long long          value;
+  unsigned long long result;
+};
+
+//!@}
+
+//!@{ Trace Writer /////////////////////////////////////////////////////////////
+
+/**
+ * @brief Appends records to a trace file through stdio buffering.
+ * @throw std::runtime_error when the file cannot be created or written
+ */
+class trace_writer {
+public:
+  trace_writer(const std::string& path, trace_kind kind)
+  : _file(std::fopen(path.c_str(), "wb")), _kind(kind), _records(0) {
+    if (!_file)
+      throw std::runtime_error("trace_writer: cannot create " + path);
+    unsigned char header[8] = { 'F', 'T', 'T', 'R', trace_version,
+                                static_cast<unsigned char>(kind), 0, 0 };
+    _write(header, sizeof(header));
+  }
+
+  ~trace_writer() { std::fclose(_file); }
+
+  trace_kind kind() const { return _kind; }
+  size_t     records() const { return _records; }
+
+  void record(int op, long long key, long long value,
+              unsigned long long result) {
+    unsigned char buf[1 + 3 * 10];
+    size_t        n = 0;
+    buf[n++] = static_cast<unsigned char>(op);
+    if (trace_has_key(op))
+      n = _varint(buf, n, trace_zigzag(key));
+    if (trace_has_value(op, _kind))
+      n = _varint(buf, n, trace_zigzag(value));
+    n = _varint(buf, n, result);
+    _write(buf, n);
+    ++_records;
+  }
+
+  void flush() {
+    if (std::fflush(_file) != 0)
+      throw std::runtime_error("trace_writer: write failed");
+  }
+
+private:
+  std::FILE* _file;
+  trace_kind _kind;
+  size_t     _records;
+
+  trace_writer(const trace_writer&);
+  trace_writer& operator=(const trace_writer&);
+
+  static size_t _varint(unsigned char* buf, size_t n, unsigned long long v) {
+    while (v >= 0x80) {
+      buf[n++] = static_cast<unsigned char>(v | 0x80);
+      v >>= 7;
+    }
+    buf[n++] = static_cast<unsigned char>(v);
+    return n;
+  }
+
+  void _write(const unsigned char* p, size_t n) {
+    if (std::fwrite(p, 1, n, _file) != n)
+      throw std::runtime_error("trace_writer: write failed");
+  }
+};
+
+//!@}
+
+//!@{ Trace Reader /////////////////////////////////////////////////////////////
+
+/**
+ * @brief Reads back a trace written by trace_writer, one record at a time.
+ * @throw std::runtime_error on a missing file, a bad header or a truncated
+ * record
+ */
+class trace_reader {
+public:
+  explicit trace_reader(const std::string& path)
+  : _file(std::fopen(path.c_str(), "rb")), _kind(trace_map) {
+    if (!_file)
+      throw std::runtime_error("trace_reader: cannot open " + path);
+    unsigned char header[8];
+    if (std::fread(header, 1, sizeof(header), _file) != sizeof(header) ||
+        header[0] != 'F' || header[1] != 'T' || header[2] != 'T' ||
+        header[3] != 'R' || header[4] != trace_version ||
+        header[5] < trace_map || header[5] > trace_vector) {
+      std::fclose(_file);
+      throw std::runtime_error("trace_reader: not a trace file: " + path);
+    }
+    _kind = static_cast<trace_kind>(header[5]);
+  }
+
+  ~trace_reader() { std::fclose(_file); }
+
+  trace_kind kind() const { return _kind; }
+
+  /**
+   * @return false at the end of the trace
+   */
+  bool next(trace_record& r) {
+    int op = std::getc(_file);
+    if (op == EOF)
+      return false;
+    if (op <= 0 || op >= trace_num_ops)
+      throw std::runtime_error("trace_reader: bad operation");
+    r.op = op;
+    r.key = trace_has_key(op) ? trace_unzigzag(_varint()) : 0;
+    r.value = trace_has_value(op, _kind) ? trace_unzigzag(_varint()) : 0;
+    r.result = _varint();
+    return true;
+  }
+
+private:
+  std::FILE* _file;
+  trace_kind _kind;
+
+  trace_reader(const trace_reader&);
+  trace_reader& operator=(const trace_reader&);
+
+  unsigned long long _varint() {
+    unsigned long long v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      int c = std::getc(_file);
+      if (c == EOF)
+        throw std::runtime_error("trace_reader: truncated record");
+      v |= static_cast<unsigned long long>(c & 0x7f) << shift;
+      if (!(c & 0x80))
+        return v;
+    }
+    throw std::runtime_error("trace_reader: bad varint");
+  }
+};
+
+//!@}
+
+//!@{ Recording Wrappers ///////////////////////////////////////////////////////
+
+/**
+ * @brief Map front end that forwards to Map (ft::map or std::map of integral
+ * key and mapped types) and logs every operation to a trace_writer. Reads
+ * through base() are not recorded.
+ */
+template <typename Map>
+class traced_map {
+public:
+  typedef typename Map::key_type       key_type;
+  typedef typename Map::mapped_type    mapped_type;
+  typedef typename Map::value_type     value_type;
+  typedef typename Map::size_type      size_type;
+  typedef typename Map::iterator       iterator;
+  typedef typename Map::const_iterator const_iterator;
+
+  explicit traced_map(trace_writer& trace, const Map& m = Map())
+  : _map(m), _trace(&trace) { }
+
+  ft::pair<iterator, bool> insert(const value_type& v) {
+    // std::map returns std::pair, so rebuild rather than convert
+    size_type before = _map.size();
+    iterator  it = _map.insert(v).first;
+    bool      inserted = _map.size() != before;
+    _trace->record(trace_insert, v.first, v.second, inserted);
+    return ft::pair<iterator, bool>(it, inserted);
+  }
+
+  iterator find(const key_type& k) {
+    iterator it = _map.find(k);
+    _trace->record(trace_find, k, 0,
+                   it == _map.end() ? 0 : 1 + trace_zigzag(it->second));
+    return it;
+  }
+
+  size_type count(const key_type& k) {
+    size_type n = _map.count(k);
+    _trace->record(trace_count, k, 0, n);
+    return n;
+  }
+
+  size_type erase(const key_type& k) {
+    size_type n = _map.erase(k);
+    _trace->record(trace_erase, k, 0, n);
+    return n;
+  }
+
+  mapped_type& operator[](const key_type& k) {
+    size_type before = _map.size();
+    mapped_type& v = _map[k];
+    _trace->record(trace_subscript, k, 0, _map.size() == before);
+    return v;
+  }
+
+  void insert_or_assign(const key_type& k, const mapped_type& v) {
+    size_type before = _map.size();
+    _map[k] = v;
+    _trace->record(trace_assign, k, v, _map.size() == before);
+  }
+
+  void clear() {
+    _map.clear();
+    _trace->record(trace_clear, 0, 0, 0);
+  }
+
+  size_type  size() const { return _map.size(); }
+  bool       empty() const { return _map.empty(); }
+  const Map& base() const { return _map; }
+
+private:
+  Map           _map;
+  trace_writer* _trace;
+};
+
+/**
+ * @brief Set front end that forwards to Set and logs every operation.
+ */
+template <typename Set>
+class traced_set {
+public:
+  typedef typename Set::key_type       key_type;
+  typedef typename Set::value_type     value_type;
+  typedef typename Set::size_type      size_type;
+  typedef typename Set::iterator       iterator;
+  typedef typename Set::const_iterator const_iterator;
+
+  explicit traced_set(trace_writer& trace, const Set& s = Set())
+  : _set(s), _trace(&trace) { }
+
+  ft::pair<iterator, bool> insert(const value_type& v) {
+    size_type before = _set.size();
+    iterator  it = _set.insert(v).first;
+    bool      inserted = _set.size() != before;
+    _trace->record(trace_insert, v, 0, inserted);
+    return ft::pair<iterator, bool>(it, inserted);
+  }
+
+  iterator find(const key_type& k) {
+    iterator it = _set.find(k);
+    _trace->record(trace_find, k, 0, it != _set.end());
+    return it;
+  }
+
+  size_type count(const key_type& k) {
+    size_type n = _set.count(k);
+    _trace->record(trace_count, k, 0, n);
+    return n;
+  }
+
+  size_type erase(const key_type& k) {
+    size_type n = _set.erase(k);
+    _trace->record(trace_erase, k, 0, n);
+    return n;
+  }
+
+  void clear() {
+    _set.clear();
+    _trace->record(trace_clear, 0, 0, 0);
+  }
+
+  size_type  size() const { return _set.size(); }
+  bool       empty() const { return _set.empty(); }
+  const Set& base() const { return _set; }
+
+private:
+  Set           _set;
+  trace_writer* _trace;
+};
+
+/**
+ * @brief Vector front end that forwards to Vector and logs every operation.
+ * Element reads go through at() and writes through set() so that both end
+ * up in the trace.
+ */
+template <typename Vector>
+class traced_vector {
+public:
+  typedef typename Vector::value_type      value_type;
+  typedef typename Vector::size_type       size_type;
+  typedef typename Vector::const_reference const_reference;
+
+  explicit traced_vector(trace_writer& trace, const Vector& v = Vector())
+  : _vec(v), _trace(&trace) { }
+
+  void push_back(const value_type& v) {
+    _vec.push_back(v);
+    _trace->record(trace_push_back, 0, v, _vec.size());
+  }
+
+  void pop_back() {
+    _vec.pop_back();
+    _trace->record(trace_pop_back, 0, 0, _vec.size());
+  }
+
+  const_reference at(size_type n) const {
+    const_reference v = _vec.at(n);
+    _trace->record(trace_at, n, 0, trace_zigzag(v));
+    return v;
+  }
+
+  void set(size_type n, const value_type& v) {
+    _vec.at(n) = v;
+    _trace->record(trace_assign, n, v, 0);
+  }
+
+  void clear() {
+    _vec.clear();
+    _trace->record(trace_clear, 0, 0, 0);
+  }
+
+  size_type     size() const { return _vec.size(); }
+  bool          empty() const { return _vec.empty(); }
+  const Vector& base() const { return _vec; }
+
+private:
+  Vector        _vec;
+  trace_writer* _trace;
+};
+
+//!@}
+
+} /* namespace ft */
+
+#endif /* __TRACE_HPP__ */
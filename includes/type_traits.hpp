@@ -1,6 +1,8 @@
 #ifndef __TYPE_TRAITS_HPP__
 #define __TYPE_TRAITS_HPP__
 
+#include <cstddef>
+
 namespace ft {
 
 /**
@@ -25,6 +27,83 @@ struct enable_if { static const bool value = false; };
 template<typename T>
 struct enable_if<true, T> { typedef T type; static const bool value = true; };
 
+/**
+  @brief is_trivially_destructible
+  Destroying such a value is a no-op, so containers may drop it without
+  running its destructor.
+*/
+
+template <class T>
+struct is_trivially_destructible {
+  static const bool value = __has_trivial_destructor(T);
+};
+
+/**
+  @brief is_trivially_copyable
+  Copying such a value is a memcpy and destroying it a no-op, so it may be
+  moved around, or stored in a file and mapped back, as raw bytes.
+*/
+
+template <class T>
+struct is_trivially_copyable {
+  static const bool value = __has_trivial_copy(T) && __has_trivial_assign(T) &&
+                            __has_trivial_destructor(T);
+};
+
+/**
+  @brief is_empty
+  Class types with no non-static data members, virtual functions or
+  non-empty bases, e.g. std::allocator and std::less. Storing them as a base
+  instead of a member takes no space (see compressed_pair.hpp).
+*/
+
+template <class T>
+struct is_empty {
+  static const bool value = __is_empty(T);
+};
+
+/**
+  @brief is_same
+*/
+
+template <class T, class U> struct is_same       { static const bool value = false; };
+template <class T>          struct is_same<T, T> { static const bool value = true; };
+
+/**
+  @brief alignment_of
+*/
+
+template <class T>
+struct alignment_of_helper {
+  char c;
+  T    t;
+};
+
+template <class T>
+struct alignment_of {
+  static const size_t value = sizeof(alignment_of_helper<T>) - sizeof(T);
+};
+
+/**
+  @brief is_monotonic_allocator
+  Allocators whose deallocate() is a no-op because memory is reclaimed in
+  bulk (see arena.hpp). Combined with is_trivially_destructible, containers
+  tear down without visiting each element.
+*/
+
+template <class Alloc>
+struct is_monotonic_allocator { static const bool value = false; };
+
+/**
+  @brief is_reallocating_allocator
+  Allocators with a reallocate(p, old_n, new_n) that resizes a block without
+  copying it, returning 0 when it cannot (see large_page_allocator.hpp).
+  ft::vector grows through it when its elements are trivially copyable.
+*/
+
+template <class Alloc>
+struct is_reallocating_allocator { static const bool value = false; };
+
 } /* namespace ft */
 
 #endif /* __TYPE_TRAITS_HPP__ */
@@ -1,14 +1,43 @@
 #ifndef __VECTOR_HPP__
 #define __VECTOR_HPP__
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
 #include "vector_iterator.hpp"
 #include "type_traits.hpp"
 #include "algobase.hpp"
+#include "compressed_pair.hpp"
+#include "hooks.hpp"
+#include "memory_stats.hpp"
 
 namespace ft {
 
-template <typename T, typename Alloc = std::allocator<T> >
+/*
+ * Calls reallocate only on allocators that have one (see
+ * is_reallocating_allocator); the generic version never names it.
+ */
+template <bool Reallocating>
+struct _vector_reallocate {
+  template <typename Alloc, typename Pointer>
+  static Pointer call(Alloc&, Pointer, size_t, size_t) { return 0; }
+};
+
+template <>
+struct _vector_reallocate<true> {
+  template <typename Alloc, typename Pointer>
+  static Pointer call(Alloc& a, Pointer p, size_t old_n, size_t new_n) {
+    return a.reallocate(p, old_n, new_n);
+  }
+};
+
+/*
+ * Hooks is an event policy (see hooks.hpp), told about every regrowth of the
+ * storage; the default null_hooks compiles away.
+ */
+template <typename T, typename Alloc = std::allocator<T>,
+          typename Hooks = null_hooks>
 class vector {
 
 public:
@@ -28,10 +57,15 @@ public:
   typedef ft::reverse_iterator<const_iterator>     const_reverse_iterator;
 
 private:
-  allocator_type                                   _alloc;
   pointer                                          _start;
   pointer                                          _finish;
-  pointer                                          _end_of_storage;
+  // end of storage and the allocator, which takes no space when stateless
+  compressed_pair<pointer, allocator_type>         _end_cap;
+
+  allocator_type&       _alloc() { return _end_cap.second(); }
+  const allocator_type& _alloc() const { return _end_cap.second(); }
+  pointer&              _end_of_storage() { return _end_cap.first(); }
+  pointer               _end_of_storage() const { return _end_cap.first(); }
 
 public:
   //!@{ construct/copy/destroy /////////////////////////////////////////////////
@@ -43,7 +77,7 @@ public:
    *     ft::vector<int> first;
    */
   explicit vector(const allocator_type& a = allocator_type()) 
-  : _alloc(a), _start(NULL), _finish(NULL), _end_of_storage(NULL) { }
+  : _start(NULL), _finish(NULL), _end_cap(NULL, a) { }
 
   /**
    * @brief constructor(fill)
@@ -53,13 +87,13 @@ public:
    */
   explicit vector(size_type n, const value_type& v = value_type(),
                   const allocator_type& a = allocator_type())
-  : _alloc(a), _start(NULL), _finish(NULL), _end_of_storage(NULL) {
-    _start = _alloc.allocate(n);
+  : _start(NULL), _finish(NULL), _end_cap(NULL, a) {
+    _start = _alloc().allocate(n);
     _finish = _start;
-    _end_of_storage = _finish + n;
+    _end_of_storage() = _finish + n;
 
     while (n--)
-      _alloc.construct(_finish++, v);
+      _alloc().construct(_finish++, v);
   }
 
   /**
@@ -74,16 +108,9 @@ public:
          const allocator_type& a = allocator_type(),
          typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = 0
          )
-  : _alloc(a), _start(NULL), _finish(NULL), _end_of_storage(NULL) {
-    difference_type n = ft::distance(first, last);
-
-    _start = _alloc.allocate(n);
-    _finish = _start;
-
-    while (n--)
-      _alloc.construct(_finish++, *first++);
-
-    _end_of_storage = _finish;
+  : _start(NULL), _finish(NULL), _end_cap(NULL, a) {
+    _range_initialize(first, last,
+                      typename iterator_traits<InputIterator>::iterator_category());
   }
 
   /**
@@ -92,12 +119,10 @@ public:
    *     ft::vector<int> fourth(second);
    */
   vector(const vector& other)
-   : _alloc(other._alloc), _start(NULL), _finish(NULL), _end_of_storage(NULL)
+   : _start(NULL), _finish(NULL), _end_cap(NULL, other._alloc())
   {
-    _start = _alloc.allocate(other.size());
-    _finish = _start;
-    _end_of_storage = _start + other.size();
-    insert(begin(), other.begin(), other.end());
+    _range_initialize(other._start, other._finish,
+                      std::random_access_iterator_tag());
   }
 
   /**
@@ -106,9 +131,7 @@ public:
    */
   ~vector() { 
     clear();
-    for (pointer p = _start; p != _finish; p++)
-      _alloc.destroy(p);
-    _alloc.deallocate(_start, _finish - _start);
+    _alloc().deallocate(_start, _end_of_storage() - _start);
    }
 
   /**
@@ -222,7 +245,19 @@ public:
    * vector, expressed in terms of elements.
    */
   size_type capacity() const {
-    return size_type(const_iterator(_end_of_storage) - begin());
+    return size_type(const_iterator(_end_of_storage()) - begin());
+  }
+
+  /**
+   * @brief Returns the heap memory held by the vector: the constructed
+   * elements as payload and the unused capacity as overhead.
+   */
+  memory_stats memory_usage() const {
+    memory_stats s;
+    s.payload_bytes = size() * sizeof(value_type);
+    s.overhead_bytes = (capacity() - size()) * sizeof(value_type);
+    s.allocations = capacity() != 0;
+    return s;
   }
 
   /**
@@ -236,10 +271,32 @@ public:
    * @param n: new capacity of the container
    */
   void reserve(size_type n) {
-    if (n < capacity())
+    if (n <= capacity())
       return;
-    // TODO: if n is greater than the current vector capacity....
-    // https://cplusplus.com/reference/vector/vector/reserve/
+    if (n > max_size())
+      throw std::length_error("vector::reserve");
+    if (_reallocate_in_place(n))
+      return;
+    pointer new_start = _alloc().allocate(n);
+    pointer new_finish = new_start;
+    try {
+      for (pointer s = _start; s != _finish; ++s, ++new_finish)
+        _alloc().construct(new_finish, *s);
+    } catch (...) {
+      for (pointer s = new_start; s != new_finish; ++s)
+        _alloc().destroy(s);
+      _alloc().deallocate(new_start, n);
+      throw;
+    }
+    size_type old_capacity = capacity();
+    for (pointer s = _start; s != _finish; ++s)
+      _alloc().destroy(s);
+    Hooks::reallocate(_start, old_capacity * sizeof(T), new_start,
+                      n * sizeof(T));
+    _alloc().deallocate(_start, old_capacity);
+    _start = new_start;
+    _finish = new_finish;
+    _end_of_storage() = new_start + n;
   }
 
   //!@}
@@ -299,24 +356,10 @@ public:
    */
   void assign(size_type n, const value_type& val) { 
     clear();
-    if (capacity() < n) {
-      pointer old_start = _start;
-      pointer old_end = _end_of_storage;
-
-      _start = _alloc.allocate(n);
-      _finish = _start;
-      _end_of_storage = _start + n;
-
-      while (old_end != old_start)
-        _alloc.destroy(old_end--);
-
-      while (n--)
-        _alloc.construct(_finish++, val);
-      _alloc.deallocate(old_start, old_end - old_start);
-      return;
-    }
+    if (capacity() < n)
+      _reallocate_empty(n);
     while (n--)
-      _alloc.construct(_finish++, val);
+      _alloc().construct(_finish++, val);
   }
 
   /**
@@ -328,29 +371,9 @@ public:
   template <typename InputIterator>
   void assign(InputIterator first, InputIterator last,
               typename ft::enable_if<!ft::is_integral<InputIterator>::value>::type* = 0) {
-    
     clear();
-    size_type n = ft::distance(first, last);
-
-    if (capacity() < n) {
-      pointer old_start = _start;
-      pointer old_end = _end_of_storage;
-
-      _start = _alloc.allocate(n);
-      _finish = _start;
-      _end_of_storage = _start + n;
-      pointer tmp = &(*first);
-
-      while (old_end != old_start)
-        _alloc.destroy(old_end--);
-
-      while (n--)
-        _alloc.construct(_finish++, *tmp++);
-      _alloc.deallocate(old_start, old_end - old_start);
-      return;
-    }
-    while (n--)
-      _alloc.construct(_finish++, *first++);
+    _range_assign(first, last,
+                  typename iterator_traits<InputIterator>::iterator_category());
   }
 
   /**
@@ -358,8 +381,8 @@ public:
    * element.
    */
   void push_back(const value_type& val) {
-    if (_finish != _end_of_storage) {
-      _alloc.construct(_finish, val);
+    if (_finish != _end_of_storage()) {
+      _alloc().construct(_finish, val);
       ++_finish;
     } else {
       insert(end(), val);
@@ -372,7 +395,7 @@ public:
    */
   void pop_back() {
     --_finish;
-    _alloc.destroy(_finish);
+    _alloc().destroy(_finish);
   }
 
   /**
@@ -409,11 +432,8 @@ public:
   void insert(iterator position, InputIterator first, InputIterator last,
               typename ft::enable_if<!ft::is_integral<InputIterator>::value,
                                      InputIterator>::type* = 0) {
-    while (first != last) {
-      position = insert(position, *first);
-      ++position;
-      ++first;
-    }
+    _range_insert(position, first, last,
+                  typename iterator_traits<InputIterator>::iterator_category());
   }
 
   /**
@@ -426,9 +446,8 @@ public:
   iterator erase(iterator position) {
     if (position != end() - 1)
       std::copy(position + 1, end(), position);
-    pointer old_finish = _finish;
     --_finish;
-    _alloc.destroy(old_finish);
+    _alloc().destroy(_finish);
     return position;
   }
 
@@ -450,7 +469,7 @@ public:
     pointer old_finish = _finish;
     _finish = _finish - (last - first);
     while (old_finish != _finish) {
-      _alloc.destroy(old_finish--);
+      _alloc().destroy(--old_finish);
     }
     return first;
   }
@@ -462,16 +481,22 @@ public:
    * @param x
    */
   void swap(vector& x) {
+    ft::swap(_alloc(), x._alloc());
     ft::swap(_start, x._start);
     ft::swap(_finish, x._finish);
-    ft::swap(_end_of_storage, x._end_of_storage);
+    ft::swap(_end_of_storage(), x._end_of_storage());
   }
 
   /**
    * @brief Removes all elements from the vector (which are destroyed), leaving
    * the container with a size of 0.
    */
-  void clear() { erase(begin(), end()); }
+  void clear() {
+    if (ft::is_trivially_destructible<value_type>::value)
+      _finish = _start;
+    else
+      erase(begin(), end());
+  }
 
   //!@}
 
@@ -480,7 +505,7 @@ public:
   /**
    * @brief Get the allocator object
    */
-  allocator_type get_allocator() const { return _alloc; }
+  allocator_type get_allocator() const { return _alloc(); }
 
   //!@}
 
@@ -498,89 +523,261 @@ protected:
     if (max_size() < n)
       throw (std::length_error("vector::insert (fill)"));
 
-    if (n <= size_type(_end_of_storage - _finish)) {
-      // if there is enough space at the end of the vector
-      size_type n_after = end() - position;
-      pointer old_finish = _finish - 1;
-      _finish += n;
-      pointer p = _finish - 1;
-
-      while (n_after--)
-        _alloc.construct(p--, *(old_finish--));
-      while (n--)
-        _alloc.construct(p--, v);
+    // v may be one of the elements about to be shifted, moved or destroyed
+    value_type copy(v);
+
+    if (n <= size_type(_end_of_storage() - _finish)) {
+      // if there is enough space at the end of the vector: raw storage is
+      // constructed, live elements are assigned
+      pointer   pos = position.base();
+      size_type elems_after = _finish - pos;
+      pointer   old_finish = _finish;
+      if (elems_after > n) {
+        for (pointer s = old_finish - n; s != old_finish; ++s)
+          _alloc().construct(_finish++, *s);
+        std::copy_backward(pos, old_finish - n, old_finish);
+        std::fill(pos, pos + n, copy);
+      } else {
+        for (size_type i = elems_after; i < n; ++i)
+          _alloc().construct(_finish++, copy);
+        for (pointer s = pos; s != old_finish; ++s)
+          _alloc().construct(_finish++, *s);
+        std::fill(pos, old_finish, copy);
+      }
       return;
     }
   
     // if there is not enough space at the end of the vector
+    if (_relocatable) {
+      size_type offset = position - begin();
+      if (_reallocate_in_place(size() + std::max(size(), n))) {
+        _fill_insert(begin() + offset, n, copy);
+        return;
+      }
+    }
     size_type n_before = position - begin();
     size_type n_after = end() - position;
 
     size_type new_size = size() + std::max(size(), n);
     pointer s = _start;
     pointer old_start = _start;
+    size_type old_capacity = capacity();
 
-    _start = _alloc.allocate(new_size);
+    _start = _alloc().allocate(new_size);
     _finish = _start;
-    _end_of_storage = _start + new_size;
+    _end_of_storage() = _start + new_size;
 
     while (n_before--) {
-      _alloc.construct(_finish++, *s);
-      _alloc.destroy(s++);
+      _alloc().construct(_finish++, *s);
+      _alloc().destroy(s++);
     }
     while (n--)
-      _alloc.construct(_finish++, v);
+      _alloc().construct(_finish++, copy);
     while (n_after--) {
-      _alloc.construct(_finish++, *s);
-      _alloc.destroy(s++);
+      _alloc().construct(_finish++, *s);
+      _alloc().destroy(s++);
+    }
+
+    Hooks::reallocate(old_start, old_capacity * sizeof(T), _start,
+                      new_size * sizeof(T));
+    _alloc().deallocate(old_start, old_capacity);
+  }
+
+  /*
+   * Range construction, assignment and insertion dispatch on the iterator
+   * category: a forward range is measured first and lands in storage sized
+   * once, a single-pass input range is consumed element by element.
+   */
+
+  template <typename InputIterator>
+  void _range_initialize(InputIterator first, InputIterator last,
+                         std::input_iterator_tag) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  template <typename ForwardIterator>
+  void _range_initialize(ForwardIterator first, ForwardIterator last,
+                         std::forward_iterator_tag) {
+    size_type n = ft::distance(first, last);
+
+    _start = _alloc().allocate(n);
+    _finish = _start;
+    _end_of_storage() = _start + n;
+    for (; first != last; ++first)
+      _alloc().construct(_finish++, *first);
+  }
+
+  template <typename InputIterator>
+  void _range_assign(InputIterator first, InputIterator last,
+                     std::input_iterator_tag) {
+    for (; first != last; ++first)
+      push_back(*first);
+  }
+
+  template <typename ForwardIterator>
+  void _range_assign(ForwardIterator first, ForwardIterator last,
+                     std::forward_iterator_tag) {
+    size_type n = ft::distance(first, last);
+
+    if (capacity() < n)
+      _reallocate_empty(n);
+    for (; first != last; ++first)
+      _alloc().construct(_finish++, *first);
+  }
+
+  template <typename InputIterator>
+  void _range_insert(iterator position, InputIterator first,
+                     InputIterator last, std::input_iterator_tag) {
+    for (; first != last; ++first, ++position)
+      position = insert(position, *first);
+  }
+
+  template <typename ForwardIterator>
+  void _range_insert(iterator position, ForwardIterator first,
+                     ForwardIterator last, std::forward_iterator_tag) {
+    if (first == last)
+      return;
+    size_type n = ft::distance(first, last);
+    pointer   pos = position.base();
+
+    if (n <= size_type(_end_of_storage() - _finish)) {
+      size_type elems_after = _finish - pos;
+      pointer   old_finish = _finish;
+      if (elems_after > n) {
+        // the last n elements move to raw storage, the rest shift over
+        // live ones
+        for (pointer s = old_finish - n; s != old_finish; ++s)
+          _alloc().construct(_finish++, *s);
+        std::copy_backward(pos, old_finish - n, old_finish);
+        std::copy(first, last, pos);
+      } else {
+        // the tail of the range and the moved elements go to raw storage
+        ForwardIterator mid = ft::next(first, elems_after);
+        for (ForwardIterator it = mid; it != last; ++it)
+          _alloc().construct(_finish++, *it);
+        for (pointer s = pos; s != old_finish; ++s)
+          _alloc().construct(_finish++, *s);
+        std::copy(first, mid, pos);
+      }
+      return;
     }
 
-    _alloc.deallocate(old_start, capacity());
+    size_type old_size = size();
+    size_type old_capacity = capacity();
+    size_type new_size = old_size + std::max(old_size, n);
+    size_type offset = pos - _start;
+    if (_reallocate_in_place(new_size)) {
+      _range_insert(begin() + offset, first, last,
+                    std::forward_iterator_tag());
+      return;
+    }
+    pointer   new_start = _alloc().allocate(new_size);
+    pointer   new_finish = new_start;
+    for (pointer s = _start; s != pos; ++s)
+      _alloc().construct(new_finish++, *s);
+    for (; first != last; ++first)
+      _alloc().construct(new_finish++, *first);
+    for (pointer s = pos; s != _finish; ++s)
+      _alloc().construct(new_finish++, *s);
+    for (pointer s = _start; s != _finish; ++s)
+      _alloc().destroy(s);
+    Hooks::reallocate(_start, old_capacity * sizeof(T), new_start,
+                      new_size * sizeof(T));
+    _alloc().deallocate(_start, old_capacity);
+    _start = new_start;
+    _finish = new_finish;
+    _end_of_storage() = new_start + new_size;
+  }
+
+  /*
+   * Trivially copyable elements may move as raw bytes, so an allocator that
+   * can resize its blocks (large_page_allocator, with mremap) grows the
+   * storage without allocating, copying and freeing.
+   */
+  static const bool _relocatable = is_trivially_copyable<T>::value &&
+                                   is_reallocating_allocator<Alloc>::value;
+
+  /**
+   * @brief Resizes the storage to n elements through the allocator, keeping
+   * the elements.
+   * @return false, changing nothing, when the elements are not relocatable
+   * or the allocator cannot resize this block
+   */
+  bool _reallocate_in_place(size_type n) {
+    if (!_relocatable || _start == 0)
+      return false;
+    size_type old_size = size();
+    size_type old_capacity = capacity();
+    pointer   p = _vector_reallocate<_relocatable>::call(_alloc(), _start,
+                                                        old_capacity, n);
+    if (p == 0)
+      return false;
+    Hooks::reallocate(_start, old_capacity * sizeof(T), p, n * sizeof(T));
+    _start = p;
+    _finish = p + old_size;
+    _end_of_storage() = p + n;
+    return true;
+  }
+
+  /**
+   * @brief Swaps the (empty) storage for a fresh block of n elements.
+   * Allocators such as pool resources rely on getting back the exact size
+   * they handed out.
+   */
+  void _reallocate_empty(size_type n) {
+    pointer new_start = _alloc().allocate(n);
+    Hooks::reallocate(_start, capacity() * sizeof(T), new_start,
+                      n * sizeof(T));
+    _alloc().deallocate(_start, _end_of_storage() - _start);
+    _start = new_start;
+    _finish = new_start;
+    _end_of_storage() = new_start + n;
   }
 }; // vector
 
 //!@{ Non-member functions /////////////////////////////////////////////////////
 
-template <typename T, typename Alloc>
-inline bool operator==(const vector<T, Alloc>& lhs,
-                       const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator==(const vector<T, Alloc, Hooks>& lhs,
+                       const vector<T, Alloc, Hooks>& rhs) {
   return lhs.size() == rhs.size() &&
          ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T, typename Alloc>
-inline bool operator!=(const vector<T, Alloc>& lhs,
-                       const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator!=(const vector<T, Alloc, Hooks>& lhs,
+                       const vector<T, Alloc, Hooks>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, typename Alloc>
-inline bool operator<(const vector<T, Alloc>& lhs,
-                      const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator<(const vector<T, Alloc, Hooks>& lhs,
+                      const vector<T, Alloc, Hooks>& rhs) {
   return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                      rhs.end());
 }
 
-template <typename T, typename Alloc>
-inline bool operator<=(const vector<T, Alloc>& lhs,
-                       const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator<=(const vector<T, Alloc, Hooks>& lhs,
+                       const vector<T, Alloc, Hooks>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, typename Alloc>
-inline bool operator>(const vector<T, Alloc>& lhs,
-                      const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator>(const vector<T, Alloc, Hooks>& lhs,
+                      const vector<T, Alloc, Hooks>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, typename Alloc>
-inline bool operator>=(const vector<T, Alloc>& lhs,
-                       const vector<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename Hooks>
+inline bool operator>=(const vector<T, Alloc, Hooks>& lhs,
+                       const vector<T, Alloc, Hooks>& rhs) {
   return !(lhs < rhs);
 }
 
-template <typename T, typename Alloc>
-inline void swap(vector<T, Alloc>& x, vector<T, Alloc>& y) {
+template <typename T, typename Alloc, typename Hooks>
+inline void swap(vector<T, Alloc, Hooks>& x, vector<T, Alloc, Hooks>& y) {
   x.swap(y);
 }
 
@@ -135,26 +135,6 @@ operator+(typename vector_iterator<Iterator>::difference_type n,
   return vector_iterator<Iterator>(i.base() + n);
 }
 
-template <typename Iterator>
-inline typename vector_iterator<Iterator>::difference_type
-distance(const vector_iterator<Iterator>& first,
-         const vector_iterator<Iterator>& last, std::input_iterator_tag) {
-  typename vector_iterator<Iterator>::difference_type n = 0;
-  while (first != last) {
-    ++first;
-    ++n;
-  }
-  return n;
-}
-
-template <typename Iterator>
-inline typename vector_iterator<Iterator>::difference_type
-distance(const vector_iterator<Iterator>& first,
-         const vector_iterator<Iterator>& last,
-         std::random_access_iterator_tag) {
-  return last.base() - first.base();
-}
-
 } /* namespace ft */
 
 #endif /* __VECTOR_ITERATOR_HPP__ */
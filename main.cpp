@@ -1,7 +1,10 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <cctype>
+#include <cstring>
 #include <stdlib.h>
+#include <ctime>
 
 // #define FT_STL
 
@@ -16,6 +19,21 @@
   #include "stack.hpp"
   #include "map.hpp"
   #include "set.hpp"
+  #include "large_page_allocator.hpp"
+  #include "arena.hpp"
+  #include "memory_resource.hpp"
+  #include "thread_cache_allocator.hpp"
+  #include "serialize.hpp"
+  #include "concurrent_stack.hpp"
+  #include "concurrent_vector.hpp"
+  #include "mpmc_ring.hpp"
+  #include "priority_queue.hpp"
+  #include "queue.hpp"
+  #include "spsc_ring.hpp"
+  #include <pthread.h>
+  #include <sstream>
+  #include <stdio.h>
+  #include <unistd.h>
 #endif
 
 // test code from the subject
@@ -179,6 +197,15 @@ void test_vector() {
 	v3.pop_back();
   std::cout << "- v3: ";
 	print_vector_set(v3);
+
+  // the value pushed lives in the storage that the regrowth frees; a long
+  // string keeps its characters on the heap, freed with the element
+  std::cout << "[push_back own element]" << std::endl;
+  ft::vector<std::string> v5(1, "first element, too long for SSO");
+  while (v5.size() != v5.capacity())
+    v5.push_back("filler");
+  v5.push_back(v5[0]);
+  std::cout << "- v5.back(): " << v5.back() << std::endl;
 }
 
 void test_stack() {
@@ -275,6 +302,700 @@ void test_set() {
   std::cout << "- s1.find(3) => " << *s1.find(3) << std::endl;
 }
 
+#ifndef FT_STL
+// comparators under which different values are equivalent
+
+struct case_insensitive_less {
+  bool operator()(const std::string& a, const std::string& b) const {
+    for (std::string::size_type i = 0; i < a.size() && i < b.size(); ++i) {
+      int x = std::tolower(static_cast<unsigned char>(a[i]));
+      int y = std::tolower(static_cast<unsigned char>(b[i]));
+      if (x != y)
+        return x < y;
+    }
+    return a.size() < b.size();
+  }
+};
+
+size_t case_insensitive_hash(const std::string& s) {
+  unsigned long long h = 14695981039346656037ULL;
+  for (std::string::size_type i = 0; i < s.size(); ++i) {
+    h ^= static_cast<unsigned long long>(
+        std::tolower(static_cast<unsigned char>(s[i])));
+    h *= 1099511628211ULL;
+  }
+  return ft::bloom_mix(h);
+}
+
+struct strcmp_less {
+  bool operator()(const char* a, const char* b) const {
+    return std::strcmp(a, b) < 0;
+  }
+};
+
+struct mod10_less {
+  bool operator()(int a, int b) const { return a % 10 < b % 10; }
+};
+
+// the filter must never turn a key the comparator matches into a miss
+int test_bloom_filter() {
+  std::cout << "=============== test_bloom_filter ===============" << std::endl;
+  int failed = 0;
+
+  ft::set<std::string, case_insensitive_less> words;
+  words.insert("Hello");
+  words.insert("World");
+  bool plain = words.enable_bloom_filter();
+  words.enable_bloom_filter(case_insensitive_hash);
+  std::cout << "- case insensitive set: default hash "
+            << (plain ? "accepted" : "refused") << ", count(\"hello\") "
+            << words.count("hello") << std::endl;
+  failed += plain || words.count("hello") != 1 || words.count("moon") != 0;
+
+  char                                   key[] = "key";
+  std::string                            other(key);
+  ft::map<const char*, int, strcmp_less> by_name;
+  by_name[key] = 1;
+  plain = by_name.enable_bloom_filter();
+  std::cout << "- strcmp map: default hash "
+            << (plain ? "accepted" : "refused") << ", count(copy) "
+            << by_name.count(other.c_str()) << std::endl;
+  failed += plain || by_name.count(other.c_str()) != 1;
+
+  ft::set<int, mod10_less> digits;
+  digits.insert(3);
+  plain = digits.enable_bloom_filter();
+  std::cout << "- mod 10 set: default hash "
+            << (plain ? "accepted" : "refused") << ", count(13) "
+            << digits.count(13) << std::endl;
+  failed += plain || digits.count(13) != 1;
+
+  ft::set<int> ints;
+  for (int i = 0; i < 1000; ++i)
+    ints.insert(i * 2);
+  failed += !ints.enable_bloom_filter();
+  for (int i = 0; i < 1000; i += 2)
+    ints.erase(i * 2);
+  for (int i = 0; i < 2000; ++i)
+    failed += ints.count(i) != size_t(i % 4 == 2);
+  std::cout << "- int set after erases: " << ints.size() << " keys, "
+            << ints.bloom_stats().rebuilds << " rebuild(s)" << std::endl;
+  failed += ints.bloom_stats().rebuilds == 0;
+
+  // every miss the filter lets through is a false positive, whichever
+  // lookup finds it
+  ft::set<int> evens;
+  for (int i = 0; i < 1000; ++i)
+    evens.insert(i * 2);
+  evens.enable_bloom_filter();
+  for (int i = 0; i < 100000; ++i)
+    evens.count(i * 2 + 1);
+  ft::bloom_filter_stats by_count = evens.bloom_stats();
+  for (int i = 0; i < 100000; ++i)
+    evens.find(i * 2 + 1);
+  ft::bloom_filter_stats by_find = evens.bloom_stats();
+  std::cout << "- false positives on 100000 misses: count "
+            << by_count.false_positives << ", find "
+            << by_find.false_positives - by_count.false_positives << std::endl;
+  failed += by_count.lookups !=
+            by_count.misses_avoided + by_count.false_positives;
+  failed += by_find.false_positives != 2 * by_count.false_positives;
+
+  if (failed)
+    std::cout << "Error: THE BLOOM FILTER MISSED A KEY!!" << std::endl;
+  return failed;
+}
+// containers on an arena give their memory back all at once
+int test_arena() {
+  std::cout << "=============== test_arena ===============" << std::endl;
+  typedef ft::pair<const int, int> value_type;
+  int                              failed = 0;
+
+  ft::scoped_arena<1024> arena;
+  {
+    ft::arena_allocator<value_type> node_alloc(arena);
+    ft::arena_allocator<int>        int_alloc(arena);
+    ft::map<int, int, std::less<int>, ft::arena_allocator<value_type> > m(
+        std::less<int>(), node_alloc);
+    ft::vector<int, ft::arena_allocator<int> > v(int_alloc);
+    for (int i = 0; i < 1000; ++i) {
+      m[i] = i * i;
+      v.push_back(i);
+    }
+    for (int i = 0; i < 1000; ++i)
+      failed += m.find(i) == m.end() || m.find(i)->second != i * i ||
+                v[i] != i;
+    m.clear();
+    failed += !m.empty() || m.begin() != m.end();
+    // far more than the 1 KiB buffer: the rest came from heap chunks
+    std::cout << "- map and vector of " << v.size() << ": "
+              << arena.bytes_used() << " bytes used" << std::endl;
+    failed += arena.bytes_used() <= 1024;
+  }
+
+  // hooks see every node go, although the arena keeps the memory
+  typedef ft::counting_hooks<ft::monotonic_arena> arena_hooks;
+  {
+    ft::arena_allocator<value_type> node_alloc(arena);
+    ft::map<int, int, std::less<int>, ft::arena_allocator<value_type>,
+            arena_hooks>
+        m(std::less<int>(), node_alloc);
+    for (int i = 0; i < 100; ++i)
+      m[i] = i;
+    m.clear();
+    failed += arena_hooks::counters().node_bytes != 0;
+    for (int i = 0; i < 100; ++i)
+      m[i] = i;
+  }
+  std::cout << "- node bytes the hooks count after clear and destruction: "
+            << arena_hooks::counters().node_bytes << std::endl;
+  failed += arena_hooks::counters().node_bytes != 0;
+
+  arena.release();
+  char* self = reinterpret_cast<char*>(&arena);
+  char* p = static_cast<char*>(arena.allocate(16));
+  bool  inline_block = p >= self && p < self + sizeof(arena);
+  std::cout << "- after release: " << arena.bytes_used()
+            << " bytes used, next block "
+            << (inline_block ? "inline" : "on the heap") << std::endl;
+  failed += arena.bytes_used() != 16 || !inline_block;
+
+  // larger than any chunk so far: a chunk of its own
+  char* big = static_cast<char*>(arena.allocate(65536));
+  std::memset(big, 0, 65536);
+  failed += big >= self && big < self + sizeof(arena);
+  try {
+    arena.allocate(size_t(-1) - 8);
+    failed += 1;
+  } catch (std::bad_alloc&) {
+    std::cout << "- oversized request: bad_alloc" << std::endl;
+  }
+  try {
+    ft::arena_allocator<int>(arena).allocate(size_t(-1) / 2);
+    failed += 1;
+  } catch (std::bad_alloc&) {
+  }
+
+  if (failed)
+    std::cout << "Error: THE ARENA LOST TRACK OF ITS MEMORY!!" << std::endl;
+  return failed;
+}
+// what a pool resource takes from and gives back to its upstream
+class counting_resource : public ft::memory_resource {
+public:
+  size_t allocations;
+  size_t live_bytes;
+
+  counting_resource() : allocations(0), live_bytes(0) { }
+
+protected:
+  void* do_allocate(size_t bytes, size_t align) {
+    ++allocations;
+    live_bytes += bytes;
+    return ft::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) {
+    live_bytes -= bytes;
+    ft::new_delete_resource()->deallocate(p, bytes, align);
+  }
+};
+
+int test_memory_resource() {
+  std::cout << "=============== test_memory_resource ===============" << std::endl;
+  typedef ft::pair<const int, int>              value_type;
+  typedef ft::polymorphic_allocator<value_type> node_allocator;
+  typedef ft::map<int, int, std::less<int>, node_allocator> pool_map;
+  int failed = 0;
+
+  counting_resource upstream;
+  {
+    ft::unsynchronized_pool_resource pool(&upstream);
+    pool_map                         m(std::less<int>(), &pool);
+    for (int i = 0; i < 1000; ++i)
+      m[i] = -i;
+    pool_map copy(m);
+    for (int i = 0; i < 1000; ++i)
+      failed += copy[i] != -i;
+    failed += copy.get_allocator().resource() != &pool;
+    size_t pooled = upstream.allocations;
+
+    // beyond the largest pool block: straight to upstream
+    ft::vector<char, ft::polymorphic_allocator<char> > big(4096, 'x', &pool);
+    std::cout << "- map of " << m.size() << " in " << pooled
+              << " upstream chunk(s), a 4 KiB vector in "
+              << upstream.allocations - pooled << " more" << std::endl;
+    failed += pooled == 0 || pooled > 100 ||
+              upstream.allocations != pooled + 1;
+  }
+  std::cout << "- upstream bytes live after the pool: " << upstream.live_bytes
+            << std::endl;
+  failed += upstream.live_bytes != 0;
+
+  ft::unsynchronized_pool_resource a;
+  ft::unsynchronized_pool_resource b;
+  ft::new_delete_memory_resource   other_new_delete;
+  ft::polymorphic_allocator<int>   on_a(&a);
+  failed += on_a != ft::polymorphic_allocator<long>(&a);
+  failed += on_a == ft::polymorphic_allocator<int>(&b);
+  failed += *ft::new_delete_resource() != other_new_delete;
+  failed += ft::polymorphic_allocator<int>().resource() !=
+            ft::new_delete_resource();
+  ft::memory_resource* old = ft::set_default_resource(&a);
+  failed += ft::polymorphic_allocator<int>() != on_a;
+  ft::set_default_resource(old);
+
+  ft::unsynchronized_pool_resource sealed(ft::null_memory_resource());
+  try {
+    sealed.allocate(16);
+    failed += 1;
+  } catch (std::bad_alloc&) {
+    std::cout << "- pool over null_memory_resource: bad_alloc" << std::endl;
+  }
+
+  if (failed)
+    std::cout << "Error: THE MEMORY RESOURCE MIXED UP ITS BLOCKS!!"
+              << std::endl;
+  return failed;
+}
+// a size class nothing else in this program allocates from
+struct cache_block {
+  char bytes[200];
+};
+
+typedef ft::thread_cache_allocator<cache_block> cache_block_allocator;
+
+const size_t cache_blocks = 100;
+
+void* allocate_blocks(void* p) {
+  cache_block** blocks = static_cast<cache_block**>(p);
+  for (size_t i = 0; i < cache_blocks; ++i)
+    blocks[i] = cache_block_allocator().allocate(1);
+  return 0;
+}
+
+void* deallocate_blocks(void* p) {
+  cache_block** blocks = static_cast<cache_block**>(p);
+  for (size_t i = 0; i < cache_blocks; ++i)
+    cache_block_allocator().deallocate(blocks[i], 1);
+  return 0;
+}
+
+// blocks freed on another thread come back to circulation once it exits
+int test_thread_cache() {
+  std::cout << "=============== test_thread_cache ===============" << std::endl;
+  int          failed = 0;
+  cache_block* blocks[cache_blocks];
+  pthread_t    t;
+
+  pthread_create(&t, 0, &allocate_blocks, blocks);
+  pthread_join(t, 0);
+  pthread_create(&t, 0, &deallocate_blocks, blocks);
+  pthread_join(t, 0);
+
+  // both threads flushed their lists into the depot as they exited: every
+  // block carved so far is there for this thread to take
+  ft::thread_cache_stats before = ft::thread_cache::stats();
+  size_t                 per_slab = ft::thread_cache::batch_size;
+  size_t carved = (cache_blocks + per_slab - 1) / per_slab * per_slab;
+  ft::vector<cache_block*> taken;
+  for (size_t i = 0; i < carved; ++i)
+    taken.push_back(cache_block_allocator().allocate(1));
+  ft::thread_cache_stats after = ft::thread_cache::stats();
+  for (size_t i = 0; i < taken.size(); ++i)
+    cache_block_allocator().deallocate(taken[i], 1);
+  std::cout << "- " << carved << " blocks after both threads exited: "
+            << after.depot_refills - before.depot_refills << " refill(s), "
+            << after.slab_allocations - before.slab_allocations
+            << " new slab(s)" << std::endl;
+  failed += after.slab_allocations != before.slab_allocations;
+  failed += after.depot_refills == before.depot_refills;
+  failed += after.depot_returns < 2; // one batch per exiting thread at least
+  ft::thread_cache::flush();
+
+  if (failed)
+    std::cout << "Error: THE THREAD CACHE KEPT BLOCKS OF A DEAD THREAD!!"
+              << std::endl;
+  return failed;
+}
+typedef ft::map<int, std::string> name_map;
+
+// load must throw runtime_error and leave the target as it was
+template <typename Container>
+int load_fails(const std::string& bytes, Container& target,
+               const char* what) {
+  Container         before(target);
+  std::stringstream in(bytes);
+  try {
+    ft::load(in, target);
+    std::cout << "- " << what << ": loaded" << std::endl;
+    return 1;
+  } catch (std::runtime_error& e) {
+    std::cout << "- " << what << ": " << e.what() << std::endl;
+  }
+  return target != before;
+}
+
+int test_serialize() {
+  std::cout << "=============== test_serialize ===============" << std::endl;
+  int failed = 0;
+
+  name_map     names;
+  ft::set<int> odds;
+  for (int i = 0; i < 1000; ++i) {
+    names[i * 3] = std::string(size_t(i % 40), char('a' + i % 26));
+    odds.insert(i * 2 + 1);
+  }
+
+  std::stringstream map_stream;
+  std::stringstream set_stream;
+  ft::save(map_stream, names);
+  ft::save(set_stream, odds);
+  name_map     names_back;
+  ft::set<int> odds_back;
+  names_back[-1] = "replaced";
+  ft::load(map_stream, names_back);
+  ft::load(set_stream, odds_back);
+  failed += names_back != names || odds_back != odds;
+
+  FILE* file = tmpfile();
+  int   fd = fileno(file);
+  ft::save(fd, names);
+  ft::save(fd, odds);
+  lseek(fd, 0, SEEK_SET);
+  name_map     names_fd;
+  ft::set<int> odds_fd;
+  ft::load(fd, names_fd); // reads ahead, and seeks back to the set
+  ft::load(fd, odds_fd);
+  fclose(file);
+  failed += names_fd != names || odds_fd != odds;
+  std::cout << "- round trips of " << names.size() << " names and "
+            << odds.size() << " odd numbers: "
+            << (failed ? "different" : "equal") << std::endl;
+
+  std::string saved_map = map_stream.str();
+  std::string saved_set = set_stream.str();
+  name_map    target;
+  target[7] = "seven";
+  failed += load_fails(saved_map.substr(0, saved_map.size() - 5), target,
+                       "truncated map");
+  failed += load_fails(saved_set, target, "set into a map");
+  ft::set<long long> wide;
+  wide.insert(7);
+  failed += load_fails(saved_set, wide, "set<int> into set<long long>");
+  ft::set<int, std::greater<int> > descending(odds.begin(), odds.end());
+  std::stringstream                reversed;
+  ft::save(reversed, descending);
+  ft::set<int> ascending;
+  ascending.insert(7);
+  failed += load_fails(reversed.str(), ascending, "descending keys");
+
+  if (failed)
+    std::cout << "Error: SAVE AND LOAD DISAGREE!!" << std::endl;
+  return failed;
+}
+// producers push disjoint ranges of ints, consumers pop until all are out
+template <typename Structure>
+struct handoff {
+  Structure*     s;
+  int            producers;
+  int            per_producer;
+  int            next_producer;
+  int            popped;
+  unsigned char* seen;
+
+  static void* produce(void* p) {
+    handoff* h = static_cast<handoff*>(p);
+    int      id = __atomic_fetch_add(&h->next_producer, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < h->per_producer; ++i)
+      h->s->push(id * h->per_producer + i);
+    return 0;
+  }
+
+  static void* consume(void* p) {
+    handoff* h = static_cast<handoff*>(p);
+    int      total = h->producers * h->per_producer;
+    int      x;
+    while (__atomic_load_n(&h->popped, __ATOMIC_RELAXED) < total) {
+      ft::backoff b;
+      while (!h->s->try_pop(x)) {
+        if (__atomic_load_n(&h->popped, __ATOMIC_RELAXED) == total)
+          return 0;
+        b.pause();
+      }
+      __atomic_fetch_add(&h->seen[x], 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&h->popped, 1, __ATOMIC_RELAXED);
+    }
+    return 0;
+  }
+};
+
+/**
+ * @return the number of items that did not come out of s exactly once
+ */
+template <typename Structure>
+int handoff_once(Structure& s, int producers, int consumers,
+                 int per_producer) {
+  ft::vector<unsigned char> seen(size_t(producers * per_producer), 0);
+  ft::vector<pthread_t>     ids(size_t(producers + consumers));
+  handoff<Structure>        h = { &s, producers, per_producer, 0, 0, &seen[0] };
+  for (int i = 0; i < producers + consumers; ++i)
+    pthread_create(&ids[i], 0,
+                   i < producers ? &handoff<Structure>::produce
+                                 : &handoff<Structure>::consume,
+                   &h);
+  for (size_t i = 0; i < ids.size(); ++i)
+    pthread_join(ids[i], 0);
+  int wrong = 0;
+  for (size_t i = 0; i < seen.size(); ++i)
+    wrong += seen[i] != 1;
+  return wrong;
+}
+
+int test_concurrent_stack() {
+  std::cout << "=============== test_concurrent_stack ===============" << std::endl;
+  int failed = 0;
+
+  ft::concurrent_stack<int> s;
+  int                       x = -1;
+  failed += !s.empty() || s.try_pop(x) || x != -1;
+  for (int i = 1; i <= 5; ++i)
+    s.push(i);
+  std::cout << "- s: ";
+  for (int i = 5; s.try_pop(x); --i) {
+    std::cout << x << (s.empty() ? "" : ", ");
+    failed += x != i;
+  }
+  std::cout << std::endl;
+  failed += !s.empty();
+
+  int wrong = handoff_once(s, 4, 4, 20000);
+  std::cout << "- 4 producers, 4 consumers: " << wrong
+            << " item(s) not popped exactly once" << std::endl;
+  failed += wrong != 0 || !s.empty();
+
+  if (failed)
+    std::cout << "Error: THE CONCURRENT STACK LOST AN ITEM!!" << std::endl;
+  return failed;
+}
+/**
+ * @return nonzero unless ring, of capacity 8, keeps FIFO order, refuses a
+ * ninth element and counts its elements
+ */
+template <typename Ring>
+int ring_fifo(Ring& ring, const char* name) {
+  int failed = 0;
+  int x = -1;
+  failed += ring.capacity() != 8 || !ring.empty() || ring.try_pop(x);
+  for (int i = 0; i < 8; ++i)
+    failed += !ring.try_push(i);
+  failed += ring.try_push(8) || ring.size_approx() != 8;
+  std::cout << "- " << name << ": ";
+  for (int i = 0; i < 3; ++i) {
+    failed += !ring.try_pop(x) || x != i;
+    std::cout << x << ", ";
+  }
+  int batch[8] = { 8, 9, 10 };
+  failed += ring.push_batch(batch, 8) != 3 || ring.size_approx() != 8;
+  failed += ring.pop_batch(batch, 8) != 8;
+  for (int i = 0; i < 8; ++i) {
+    failed += batch[i] != i + 3;
+    std::cout << batch[i] << (i < 7 ? ", " : "");
+  }
+  std::cout << std::endl;
+  failed += !ring.empty() || ring.try_pop(x);
+  return failed;
+}
+
+int test_rings() {
+  std::cout << "=============== test_rings ===============" << std::endl;
+  int failed = 0;
+
+  ft::queue<int> q;
+  for (int i = 0; i < 5; ++i)
+    q.push(i);
+  failed += q.size() != 5 || q.front() != 0 || q.back() != 4;
+  q.pop();
+  failed += q.size() != 4 || q.front() != 1;
+
+  ft::spsc_ring<int> spsc(5); // rounded up to 8
+  ft::mpmc_ring<int> mpmc(8);
+  failed += ring_fifo(spsc, "spsc_ring");
+  failed += ring_fifo(mpmc, "mpmc_ring");
+
+  int spsc_wrong = handoff_once(spsc, 1, 1, 100000);
+  int mpmc_wrong = handoff_once(mpmc, 4, 4, 20000);
+  std::cout << "- 1 producer, 1 consumer through spsc_ring: " << spsc_wrong
+            << " item(s) not popped exactly once" << std::endl;
+  std::cout << "- 4 producers, 4 consumers through mpmc_ring: " << mpmc_wrong
+            << " item(s) not popped exactly once" << std::endl;
+  failed += spsc_wrong != 0 || mpmc_wrong != 0;
+  failed += !spsc.empty() || !mpmc.empty();
+
+  if (failed)
+    std::cout << "Error: A RING LOST AN ITEM!!" << std::endl;
+  return failed;
+}
+int test_priority_queue() {
+  std::cout << "=============== test_priority_queue ===============" << std::endl;
+  int failed = 0;
+
+  ft::vector<int> values;
+  for (int i = 0; i < 1000; ++i)
+    values.push_back((i * 7919) % 1009);
+  ft::priority_queue<int> max_first(values.begin(), values.begin() + 10);
+  max_first.push_range(values.begin() + 10, values.end());
+  for (int i = 0; i < 10; ++i)
+    max_first.push(values[i]);
+  failed += max_first.size() != 1010;
+  int previous = max_first.top();
+  while (!max_first.empty()) {
+    failed += max_first.top() > previous;
+    previous = max_first.top();
+    max_first.pop();
+  }
+
+  ft::priority_queue<int, ft::vector<int>, std::greater<int> > min_first(
+      values.begin(), values.end());
+  std::cout << "- smallest first:";
+  for (int i = 0; i < 5; ++i) {
+    std::cout << " " << min_first.top();
+    failed += min_first.top() != i;
+    min_first.pop();
+  }
+  std::cout << std::endl;
+
+  ft::indexed_priority_queue<int>         tasks;
+  ft::indexed_priority_queue<int>::handle h[5];
+  for (int i = 0; i < 5; ++i)
+    h[i] = tasks.push(i * 10); // 0 10 20 30 40
+  tasks.update(h[0], 35);       // 10 20 30 35 40
+  tasks.decrease_key(h[1], 50); // 20 30 35 40 50
+  tasks.update(h[4], 5);        // 5 20 30 35 50
+  tasks.erase(h[3]);            // 5 20 35 50
+  failed += tasks.size() != 4 || tasks.contains(h[3]) || !tasks.contains(h[4]);
+  failed += tasks.top_handle() != h[1] || tasks[h[0]] != 35;
+  std::cout << "- indexed:";
+  const int expected[4] = { 50, 35, 20, 5 };
+  for (int i = 0; i < 4; ++i) {
+    std::cout << " " << tasks.top();
+    failed += tasks.top() != expected[i];
+    tasks.pop();
+  }
+  std::cout << std::endl;
+  failed += !tasks.empty() || tasks.contains(h[1]);
+
+  if (failed)
+    std::cout << "Error: THE PRIORITY QUEUE POPPED OUT OF ORDER!!"
+              << std::endl;
+  return failed;
+}
+const int appends_per_thread = 20000;
+
+void* append_range(void* p) {
+  static int next_thread = 0;
+  ft::concurrent_vector<int>* v = static_cast<ft::concurrent_vector<int>*>(p);
+  int id = __atomic_fetch_add(&next_thread, 1, __ATOMIC_RELAXED);
+  for (int i = 0; i < appends_per_thread; ++i)
+    v->push_back(id * appends_per_thread + i);
+  return 0;
+}
+
+int test_concurrent_vector() {
+  std::cout << "=============== test_concurrent_vector ===============" << std::endl;
+  int failed = 0;
+
+  ft::concurrent_vector<int> v;
+  failed += !v.empty() || v.size() != 0;
+  int& first = v.push_back(0);
+  for (int i = 1; i < 100; ++i)
+    v.push_back(i);
+  int* sixteenth = &v[15];
+  for (int i = 100; i < 1000; ++i)
+    v.push_back(i);
+  // growing allocated new segments and moved nothing
+  failed += &first != &v[0] || sixteenth != &v[15];
+  failed += v.size() != 1000 || v.capacity() < 1000;
+  ft::concurrent_vector<int>::iterator sevens = v.grow_by(10, 7);
+  failed += sevens != v.begin() + 1000 || *sevens != 7 || v.size() != 1010;
+  long sum = 0;
+  for (ft::concurrent_vector<int>::iterator it = v.begin(); it != v.end();
+       ++it)
+    sum += *it;
+  failed += sum != 999 * 1000 / 2 + 70;
+  try {
+    v.at(v.size());
+    failed += 1;
+  } catch (std::out_of_range&) {
+  }
+  std::cout << "- " << v.size() << " elements, sum " << sum
+            << ", first element at the same address: "
+            << (&first == &v[0] ? "yes" : "no") << std::endl;
+  v.clear();
+  failed += !v.empty();
+
+  ft::vector<pthread_t> ids(4);
+  for (size_t i = 0; i < ids.size(); ++i)
+    pthread_create(&ids[i], 0, &append_range, &v);
+  for (size_t i = 0; i < ids.size(); ++i)
+    pthread_join(ids[i], 0);
+  ft::vector<unsigned char> seen(v.size(), 0);
+  for (size_t i = 0; i < v.size(); ++i)
+    if (size_t(v[i]) < seen.size())
+      ++seen[v[i]];
+  int wrong = 0;
+  for (size_t i = 0; i < seen.size(); ++i)
+    wrong += seen[i] != 1;
+  std::cout << "- 4 threads appending " << appends_per_thread << " each: "
+            << v.size() << " elements, " << wrong
+            << " value(s) not stored exactly once" << std::endl;
+  failed += v.size() != 4 * size_t(appends_per_thread) || wrong != 0;
+
+  if (failed)
+    std::cout << "Error: THE CONCURRENT VECTOR LOST AN ELEMENT!!"
+              << std::endl;
+  return failed;
+}
+// the subject's Buffer vector on huge pages, grown with mremap: the elements
+// must survive every move of the mapping
+int test_large_page_allocator() {
+  std::cout << "=============== test_large_page_allocator ===============" << std::endl;
+  typedef ft::large_page_allocator<Buffer> buffer_allocator;
+  int failed = 0;
+
+  ft::vector<Buffer, buffer_allocator> buffers;
+  const int count = 4096; // 16 MiB
+  for (int i = 0; i < count; ++i) {
+    buffers.push_back(Buffer());
+    buffers.back().idx = i;
+    buffers.back().buff[BUFFER_SIZE - 1] = char(i);
+  }
+  for (int i = 0; i < count; ++i)
+    failed += buffers[i].idx != i ||
+              buffers[i].buff[BUFFER_SIZE - 1] != char(i);
+  buffers.reserve(3 * count);
+  buffers.insert(buffers.begin(), buffers[count - 1]);
+  failed += buffers.size() != size_t(count) + 1 ||
+            buffers.capacity() < size_t(3 * count) ||
+            buffers[0].idx != count - 1 || buffers[count].idx != count - 1;
+  std::cout << "- " << buffers.size() << " buffers, "
+            << buffers.capacity() * sizeof(Buffer) / (1 << 20)
+            << " MiB reserved" << std::endl;
+  ft::vector<Buffer, buffer_allocator>().swap(buffers);
+  failed += buffers.capacity() != 0;
+
+  // below one huge page, blocks come from operator new and never resize
+  buffer_allocator alloc;
+  Buffer*          small = alloc.allocate(4);
+  failed += alloc.reallocate(small, 4, 8) != 0;
+  alloc.deallocate(small, 4);
+
+  if (failed)
+    std::cout << "Error: A BUFFER MOVED WITHOUT ITS CONTENTS!!" << std::endl;
+  return failed;
+}
+#endif
+
 int main (int argc, char**argv) {
   std::clock_t start = std::clock();
 
@@ -290,6 +1011,28 @@ int main (int argc, char**argv) {
   std::clock_t t4 = std::clock();
   test_set();
   std::clock_t t5 = std::clock();
+#ifndef FT_STL
+  if (test_bloom_filter())
+    return 1;
+  if (test_arena())
+    return 1;
+  if (test_memory_resource())
+    return 1;
+  if (test_thread_cache())
+    return 1;
+  if (test_serialize())
+    return 1;
+  if (test_concurrent_stack())
+    return 1;
+  if (test_rings())
+    return 1;
+  if (test_priority_queue())
+    return 1;
+  if (test_concurrent_vector())
+    return 1;
+  if (test_large_page_allocator())
+    return 1;
+#endif
 
 #ifdef FT_STL
   std::cout << "=============== time[STL] ===============" << std::endl;